@@ -0,0 +1,30 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Command-line value parsing shared by the benchmark and test drivers.
+
+#pragma once
+
+#include <charconv>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace coogle::bench {
+
+// Parses all of Value as an integer. Returns false on anything else.
+template <typename T> bool parseValue(std::string_view Value, T &Out) {
+  auto [Ptr, Ec] = std::from_chars(Value.data(), Value.data() + Value.size(),
+                                   Out);
+  return Ec == std::errc() && Ptr == Value.data() + Value.size();
+}
+
+// Parses all of Value as a non-negative number, such as a ratio or limit.
+inline bool parseValue(std::string_view Value, double &Out) {
+  const std::string Str(Value);
+  char *End = nullptr;
+  Out = std::strtod(Str.c_str(), &End);
+  return !Str.empty() && *End == '\0' && Out >= 0;
+}
+
+} // namespace coogle::bench
@@ -0,0 +1,403 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Microbenchmarks for the core string and signature kernels.
+//
+// Inputs mirror what libclang hands coogle when scanning real projects:
+// mostly short builtin/pointer types, a minority of long canonical library
+// types and a tail of deeply nested templates.
+//
+//   ./build/coogle_bench
+//   ./build/coogle_bench --benchmark_filter=Normalize
+
+#include "coogle/any_order.h"
+#include "coogle/fuzzy.h"
+#include "coogle/arena.h"
+#include "coogle/match.h"
+#include "coogle/parser.h"
+#include "coogle/rank.h"
+#include "coogle/short_names.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace coogle;
+
+namespace {
+
+// Type spellings by shape, as produced by clang_getTypeSpelling on
+// canonical types.
+constexpr std::array<std::string_view, 8> ShortTypes = {
+    "int",          "char *",  "const char *", "unsigned long",
+    "void *",       "double",  "bool",         "const int &"};
+
+constexpr std::array<std::string_view, 4> LongTypes = {
+    "const std::basic_string<char, std::char_traits<char>, "
+    "std::allocator<char> > &",
+    "std::vector<int, std::allocator<int> > &",
+    "const llvm::SmallVectorImpl<llvm::StringRef> &",
+    "struct std::pair<const unsigned long, const char *> *"};
+
+constexpr std::array<std::string_view, 3> TemplateTypes = {
+    "std::map<std::basic_string<char>, std::vector<std::pair<int, "
+    "std::unique_ptr<Node, std::default_delete<Node> > > >, "
+    "std::less<std::basic_string<char> > > &",
+    "const std::unordered_map<unsigned int, std::function<void (const "
+    "Event &, std::shared_ptr<Context>)> > &",
+    "std::tuple<std::optional<std::variant<int, double, "
+    "std::basic_string<char> > >, std::array<float, 16> > &&"};
+
+// Weighted mix of 7 short : 2 long : 1 template type per ten.
+std::vector<std::string_view> typeMix() {
+  std::vector<std::string_view> Mix;
+  for (std::size_t i = 0; i < 70; ++i) {
+    Mix.push_back(ShortTypes[i % ShortTypes.size()]);
+  }
+  for (std::size_t i = 0; i < 20; ++i) {
+    Mix.push_back(LongTypes[i % LongTypes.size()]);
+  }
+  for (std::size_t i = 0; i < 10; ++i) {
+    Mix.push_back(TemplateTypes[i % TemplateTypes.size()]);
+  }
+  return Mix;
+}
+
+// Representative user queries.
+constexpr std::array<std::string_view, 5> Queries = {
+    "int(int, int)", "void(char *)", "void(*, *)",
+    "std::string(const std::string &)",
+    "bool(const std::map<std::string, std::vector<int>> &, size_t)"};
+
+// ---- normalizeType ----
+
+void normalizeShape(benchmark::State &State, std::string_view Type) {
+  StringArena Arena;
+  for (auto _ : State) {
+    Arena.clear();
+    benchmark::DoNotOptimize(normalizeType(Arena, Type));
+  }
+  State.SetItemsProcessed(State.iterations());
+  State.SetBytesProcessed(State.iterations() *
+                          static_cast<int64_t>(Type.size()));
+}
+
+void BM_NormalizeType_Short(benchmark::State &State) {
+  normalizeShape(State, ShortTypes[2]);
+}
+BENCHMARK(BM_NormalizeType_Short);
+
+void BM_NormalizeType_Long(benchmark::State &State) {
+  normalizeShape(State, LongTypes[0]);
+}
+BENCHMARK(BM_NormalizeType_Long);
+
+void BM_NormalizeType_Template(benchmark::State &State) {
+  normalizeShape(State, TemplateTypes[0]);
+}
+BENCHMARK(BM_NormalizeType_Template);
+
+void BM_NormalizeType_Mix(benchmark::State &State) {
+  const std::vector<std::string_view> Mix = typeMix();
+  StringArena Arena;
+  for (auto _ : State) {
+    Arena.clear();
+    for (std::string_view Type : Mix) {
+      benchmark::DoNotOptimize(normalizeType(Arena, Type));
+    }
+  }
+  State.SetItemsProcessed(State.iterations() *
+                          static_cast<int64_t>(Mix.size()));
+}
+BENCHMARK(BM_NormalizeType_Mix);
+
+// ---- parseFunctionSignature ----
+
+void BM_ParseFunctionSignature(benchmark::State &State) {
+  const std::string_view Query = Queries[State.range(0)];
+  for (auto _ : State) {
+    SignatureStorage Storage;
+    benchmark::DoNotOptimize(parseFunctionSignature(Storage, Query));
+  }
+  State.SetLabel(std::string(Query));
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ParseFunctionSignature)->DenseRange(0, Queries.size() - 1);
+
+// ---- isSignatureMatch ----
+
+// Parses Query into its own storage and keeps both alive.
+struct ParsedSignature {
+  SignatureStorage Storage;
+  Signature Sig;
+
+  explicit ParsedSignature(std::string_view Query)
+      : Sig(*parseFunctionSignature(Storage, Query)) {}
+};
+
+void matchBench(benchmark::State &State, std::string_view Query,
+                std::string_view Actual, bool Expected) {
+  ParsedSignature User(Query);
+  ParsedSignature Candidate(Actual);
+  if (isSignatureMatch(User.Sig, Candidate.Sig) != Expected) {
+    State.SkipWithError("unexpected match result");
+    return;
+  }
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(isSignatureMatch(User.Sig, Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+
+// Same cases through the compiled query, as the search visitor runs them.
+void programBench(benchmark::State &State, std::string_view Query,
+                  std::string_view Actual, bool Expected) {
+  ParsedSignature User(Query);
+  ParsedSignature Candidate(Actual);
+  const MatchProgram Program(User.Sig);
+  if (Program.matches(Candidate.Sig) != Expected) {
+    State.SkipWithError("unexpected match result");
+    return;
+  }
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Program.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+
+void BM_SignatureMatch_Hit(benchmark::State &State) {
+  matchBench(State, "std::string(const std::string &, int)",
+             "std::string(const std::string &, int)", true);
+}
+BENCHMARK(BM_SignatureMatch_Hit);
+
+void BM_SignatureMatch_EarlyMiss(benchmark::State &State) {
+  // Return types differ: the common case when scanning a tree
+  matchBench(State, "int(int, int)", "void(const char *, unsigned long)",
+             false);
+}
+BENCHMARK(BM_SignatureMatch_EarlyMiss);
+
+void BM_SignatureMatch_Wildcard(benchmark::State &State) {
+  matchBench(State, "void(*, *, int)", "void(const char *, void *, int)",
+             true);
+}
+BENCHMARK(BM_SignatureMatch_Wildcard);
+
+void BM_MatchProgram_Hit(benchmark::State &State) {
+  programBench(State, "std::string(const std::string &, int)",
+               "std::string(const std::string &, int)", true);
+}
+BENCHMARK(BM_MatchProgram_Hit);
+
+void BM_MatchProgram_EarlyMiss(benchmark::State &State) {
+  programBench(State, "int(int, int)", "void(const char *, unsigned long)",
+               false);
+}
+BENCHMARK(BM_MatchProgram_EarlyMiss);
+
+void BM_MatchProgram_Wildcard(benchmark::State &State) {
+  programBench(State, "void(*, *, int)", "void(const char *, void *, int)",
+               true);
+}
+BENCHMARK(BM_MatchProgram_Wildcard);
+
+// Same arity, the selective argument differs: the interpreter compares
+// the common return type first, the program the qualified name
+void BM_SignatureMatch_LateMiss(benchmark::State &State) {
+  matchBench(State, "void(int, const llvm::Twine &)",
+             "void(int, const llvm::StringRef &)", false);
+}
+BENCHMARK(BM_SignatureMatch_LateMiss);
+
+void BM_MatchProgram_LateMiss(benchmark::State &State) {
+  programBench(State, "void(int, const llvm::Twine &)",
+               "void(int, const llvm::StringRef &)", false);
+}
+BENCHMARK(BM_MatchProgram_LateMiss);
+
+// Wildcards inside a template and under a pointer
+void BM_SignatureMatch_Pattern(benchmark::State &State) {
+  matchBench(State, "bool(const std::map<std::string, *> &, * *)",
+             "bool(const std::map<std::string, std::vector<int>> &, char **)",
+             true);
+}
+BENCHMARK(BM_SignatureMatch_Pattern);
+
+void BM_MatchProgram_Pattern(benchmark::State &State) {
+  programBench(State, "bool(const std::map<std::string, *> &, * *)",
+               "bool(const std::map<std::string, std::vector<int>> &, char **)",
+               true);
+}
+BENCHMARK(BM_MatchProgram_Pattern);
+
+// ---- RankedQuery ----
+
+// The bound a worker checks for every function once its heap is full
+void BM_RankedQuery_LowerBound(benchmark::State &State) {
+  ParsedSignature User("bool(int, void *, const Foo &, size_t)");
+  ParsedSignature Candidate("void(const char *, unsigned long)");
+  const RankedQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.lowerBound(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_RankedQuery_LowerBound);
+
+// Full scoring: permuted arguments, one relaxed and one extra
+void BM_RankedQuery_Score(benchmark::State &State) {
+  ParsedSignature User("bool(int, void *, const Foo &, size_t)");
+  ParsedSignature Candidate("bool(Foo *, size_t, void *, int, double)");
+  const RankedQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.score(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_RankedQuery_Score);
+
+// ---- AnyOrderQuery ----
+
+// Same arity, different types: the multiset hash rejects it
+void BM_AnyOrder_Miss(benchmark::State &State) {
+  ParsedSignature User("bool(const Foo &, int, size_t)");
+  ParsedSignature Candidate("bool(const char *, int, size_t)");
+  AnyOrderQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_AnyOrder_Miss);
+
+// Permuted arguments: hash, then the ID merge
+void BM_AnyOrder_Hit(benchmark::State &State) {
+  ParsedSignature User("bool(const Foo &, int, size_t)");
+  ParsedSignature Candidate("bool(size_t, const Foo &, int)");
+  AnyOrderQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_AnyOrder_Hit);
+
+// ---- FuzzyQuery ----
+
+// A typo in one argument: the distance comes from the cache after the
+// first call
+void BM_FuzzyQuery_Hit(benchmark::State &State) {
+  ParsedSignature User("void(llvm::raw_ostram &, int)");
+  ParsedSignature Candidate("void(llvm::raw_ostream &, int)");
+  FuzzyQuery Query(User.Sig, DefaultFuzzyEdits);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FuzzyQuery_Hit);
+
+// Types too far apart in length are rejected before any lookup
+void BM_FuzzyQuery_Miss(benchmark::State &State) {
+  ParsedSignature User("void(llvm::raw_ostram &, int)");
+  ParsedSignature Candidate("void(const char *, int)");
+  FuzzyQuery Query(User.Sig, DefaultFuzzyEdits);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FuzzyQuery_Miss);
+
+// One uncached distance: the bit-parallel scan itself
+void BM_FuzzyPattern_Distance(benchmark::State &State) {
+  const FuzzyPattern Pattern("llvm::raw_ostram&");
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Pattern.distance("llvm::raw_ostream&", 2));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_FuzzyPattern_Distance);
+
+// ---- ShortNameQuery ----
+
+// Unqualified query names: after the first call each type is an ID-set
+// membership test and a cached verdict
+void BM_ShortNames_Hit(benchmark::State &State) {
+  ParsedSignature User("bool(StringRef, const Twine &)");
+  ParsedSignature Candidate("bool(llvm::StringRef, const llvm::Twine &)");
+  ShortNameQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ShortNames_Hit);
+
+void BM_ShortNames_Miss(benchmark::State &State) {
+  ParsedSignature User("bool(StringRef, const Twine &)");
+  ParsedSignature Candidate("bool(clang::SourceLocation, int)");
+  ShortNameQuery Query(User.Sig);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(Query.matches(Candidate.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ShortNames_Miss);
+
+// ---- StringArena ----
+
+// Arenas are cleared every this many operations, like one per function.
+constexpr std::size_t ArenaOpsPerReset = 64;
+
+void BM_ArenaIntern(benchmark::State &State) {
+  const std::vector<std::string_view> Mix = typeMix();
+  StringArena Arena;
+  std::size_t i = 0;
+  for (auto _ : State) {
+    if (i % ArenaOpsPerReset == 0) {
+      Arena.clear();
+    }
+    benchmark::DoNotOptimize(Arena.intern(Mix[i % Mix.size()]));
+    ++i;
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ArenaIntern);
+
+void BM_ArenaAllocateFinalize(benchmark::State &State) {
+  const std::vector<std::string_view> Mix = typeMix();
+  StringArena Arena;
+  std::size_t i = 0;
+  for (auto _ : State) {
+    if (i % ArenaOpsPerReset == 0) {
+      Arena.clear();
+    }
+    const std::string_view Type = Mix[i % Mix.size()];
+    span<char> Buffer = Arena.allocate(Type.size());
+    std::memcpy(Buffer.data(), Type.data(), Type.size() / 2);
+    benchmark::DoNotOptimize(Arena.finalize(Buffer, Type.size() / 2));
+    ++i;
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ArenaAllocateFinalize);
+
+// ---- toString ----
+
+void BM_ToString(benchmark::State &State) {
+  ParsedSignature Parsed(Queries[State.range(0)]);
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(toString(Parsed.Sig));
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_ToString)->Arg(0)->Arg(4);
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
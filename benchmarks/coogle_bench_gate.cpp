@@ -0,0 +1,125 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Fails when benchmark results regress against a stored baseline.
+//
+//   ./build/coogle_bench --benchmark_repetitions=5
+//       --benchmark_out=micro.json --benchmark_out_format=json
+//   ./build/coogle_e2e_bench --generate=small --warm-only
+//       --output=e2e.json /tmp/corpus
+//   ./build/coogle_bench_gate --baseline=benchmarks/baseline.json
+//       micro.json e2e.json
+//
+// --update rewrites the baseline from the given results instead (keeping
+// per-benchmark tolerances); run it on the reference machine.
+
+#include "gate.h"
+
+#include <cstdlib>
+#include <fmt/core.h>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+using namespace coogle;
+
+namespace {
+
+void printUsage(const char *ProgramName) {
+  std::cerr << fmt::format(
+      "Usage:\n  {} --baseline=FILE [--update] [--noise-sigmas=X] "
+      "RESULTS.json...\n",
+      ProgramName);
+}
+
+std::optional<std::string> readFile(const std::string &Path) {
+  std::ifstream In(Path, std::ios::binary);
+  if (!In) {
+    std::cerr << fmt::format("✖ Error: Cannot open '{}'\n", Path);
+    return std::nullopt;
+  }
+  std::ostringstream Contents;
+  Contents << In.rdbuf();
+  return Contents.str();
+}
+
+} // anonymous namespace
+
+int main(int Argc, char *Argv[]) {
+  std::string BaselinePath;
+  bool Update = false;
+  double NoiseSigmas = bench::DefaultNoiseSigmas;
+  std::vector<std::string> ResultPaths;
+  for (int i = 1; i < Argc; ++i) {
+    std::string_view Arg = Argv[i];
+    if (Arg.substr(0, 11) == "--baseline=") {
+      BaselinePath = Arg.substr(11);
+    } else if (Arg == "--update") {
+      Update = true;
+    } else if (Arg.substr(0, 15) == "--noise-sigmas=") {
+      const std::string Value(Arg.substr(15));
+      char *End = nullptr;
+      NoiseSigmas = std::strtod(Value.c_str(), &End);
+      if (Value.empty() || *End != '\0' || NoiseSigmas < 0) {
+        std::cerr << fmt::format(
+            "✖ Error: Invalid --noise-sigmas value '{}'\n", Value);
+        return 1;
+      }
+    } else if (Arg.substr(0, 2) == "--") {
+      std::cerr << fmt::format("✖ Error: Unknown option '{}'\n\n", Arg);
+      printUsage(Argv[0]);
+      return 1;
+    } else {
+      ResultPaths.emplace_back(Arg);
+    }
+  }
+  if (BaselinePath.empty() || ResultPaths.empty()) {
+    printUsage(Argv[0]);
+    return 1;
+  }
+
+  std::vector<bench::BenchResult> Results;
+  for (const std::string &Path : ResultPaths) {
+    auto Text = readFile(Path);
+    auto Parsed = Text ? bench::parseBenchResults(*Text) : std::nullopt;
+    if (!Parsed) {
+      std::cerr << fmt::format("✖ Error: Cannot read results from '{}'\n",
+                               Path);
+      return 1;
+    }
+    Results.insert(Results.end(), Parsed->begin(), Parsed->end());
+  }
+
+  // A missing baseline is only acceptable when creating one
+  bench::Baseline Base;
+  if (std::ifstream(BaselinePath) || !Update) {
+    auto Text = readFile(BaselinePath);
+    auto Parsed = Text ? bench::parseBaseline(*Text) : std::nullopt;
+    if (!Parsed) {
+      return 1;
+    }
+    Base = std::move(*Parsed);
+  }
+
+  if (Update) {
+    OutputBuffer Out;
+    bench::formatBaseline(Out, bench::makeBaseline(Results, Base));
+    if (!writeFileContents(BaselinePath, Out, "baseline")) {
+      return 1;
+    }
+    std::cout << fmt::format("Wrote {} benchmarks to {}\n", Results.size(),
+                             BaselinePath);
+    return 0;
+  }
+
+  const auto Comparisons =
+      bench::compareToBaseline(Base, Results, NoiseSigmas);
+  OutputBuffer Out;
+  bench::formatComparison(Out, Comparisons);
+  OutputWriter(STDOUT_FILENO).write(Out);
+  return bench::gateFailed(Comparisons) ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Differential tester: every search path against an independent reference.
+//
+//   ./build/coogle_difftest test/inputs
+//   ./build/coogle_difftest --generate=small --files=200 /tmp/difftest
+//   ./build/coogle_difftest --query='void(*)' ~/src/llvm-project/llvm/lib
+//
+// Prints one line per differing match (path, query, file:line:column and
+// function name) and exits non-zero if any path disagrees with the
+// reference. With --generate the synthetic corpus is written first and
+// the reference itself is also checked against the generator's expected
+// match counts.
+
+#include "cli.h"
+#include "corpus.h"
+#include "difftest.h"
+
+#include "coogle/search.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+using namespace coogle;
+using bench::parseValue;
+
+namespace {
+
+void printUsage(const char *ProgramName) {
+  std::cerr << fmt::format("Usage:\n  {} [options] <path>\n\n", ProgramName);
+  std::cerr << "Options:\n"
+               "  --query=SIG         Query to compare (repeatable; default: "
+               "the corpus queries)\n"
+               "  --threads=N         Workers for the parallel paths "
+               "(default 4)\n"
+               "  --generate=PRESET   Write a synthetic corpus to <path> "
+               "first\n"
+               "  --seed=N            Seed for --generate\n"
+               "  --files=N           File count for --generate\n";
+}
+
+struct Options {
+  bench::DiffConfig Config;
+  std::optional<corpus::CorpusConfig> Generate;
+  std::optional<std::uint64_t> Seed;
+  std::optional<std::size_t> NumFiles;
+  std::string Path;
+};
+
+std::optional<Options> parseArgs(int Argc, char *Argv[]) {
+  Options Opts;
+  std::vector<std::string_view> Positional;
+  for (int i = 1; i < Argc; ++i) {
+    std::string_view Arg = Argv[i];
+    if (Arg == "--help" || Arg == "-h") {
+      printUsage(Argv[0]);
+      std::exit(0);
+    }
+    if (Arg.substr(0, 2) != "--") {
+      Positional.push_back(Arg);
+      continue;
+    }
+
+    const std::size_t Eq = Arg.find('=');
+    const std::string_view Name = Arg.substr(0, Eq);
+    const std::string_view Value =
+        Eq == std::string_view::npos ? std::string_view() : Arg.substr(Eq + 1);
+    bool Ok = Eq != std::string_view::npos;
+    if (Name == "--query") {
+      Opts.Config.Queries.emplace_back(Value);
+    } else if (Name == "--threads") {
+      Ok = Ok && parseValue(Value, Opts.Config.NumThreads) &&
+           Opts.Config.NumThreads > 0;
+    } else if (Name == "--generate") {
+      Opts.Generate = corpus::corpusPreset(Value);
+      Ok = Ok && Opts.Generate.has_value();
+    } else if (Name == "--seed") {
+      Opts.Seed.emplace();
+      Ok = Ok && parseValue(Value, *Opts.Seed);
+    } else if (Name == "--files") {
+      Opts.NumFiles.emplace();
+      Ok = Ok && parseValue(Value, *Opts.NumFiles);
+    } else {
+      std::cerr << fmt::format("✖ Error: Unknown option '{}'\n\n", Arg);
+      printUsage(Argv[0]);
+      return std::nullopt;
+    }
+    if (!Ok) {
+      std::cerr << fmt::format("✖ Error: Invalid {} value '{}'\n", Name,
+                               Value);
+      return std::nullopt;
+    }
+  }
+
+  if (Positional.size() != 1) {
+    std::cerr << "✖ Error: Incorrect number of arguments.\n\n";
+    printUsage(Argv[0]);
+    return std::nullopt;
+  }
+  Opts.Path = Positional[0];
+  if (Opts.Generate) {
+    Opts.Generate->Seed = Opts.Seed.value_or(Opts.Generate->Seed);
+    Opts.Generate->NumFiles = Opts.NumFiles.value_or(Opts.Generate->NumFiles);
+  }
+  if (Opts.Config.Queries.empty()) {
+    Opts.Config.Queries = corpus::defaultCorpusQueries();
+  }
+  return Opts;
+}
+
+} // anonymous namespace
+
+int main(int Argc, char *Argv[]) {
+  auto Opts = parseArgs(Argc, Argv);
+  if (!Opts) {
+    return 1;
+  }
+
+  std::optional<corpus::CorpusSummary> Summary;
+  if (Opts->Generate) {
+    Summary = corpus::writeCorpus(*Opts->Generate, Opts->Config.Queries,
+                                  Opts->Path);
+    if (!Summary) {
+      return 1;
+    }
+  }
+
+  std::vector<std::string> Files = findSourceFiles(Opts->Path);
+  std::sort(Files.begin(), Files.end());
+  auto Report = bench::runDiffTest(Files, Opts->Config);
+  if (!Report) {
+    return 1;
+  }
+
+  // The generator knows the answer independently of every path
+  bool Ok = Report->Mismatches.empty();
+  if (Summary) {
+    std::size_t Expected = 0;
+    for (const auto &[Query, Count] : Summary->Expected) {
+      Expected += Count;
+    }
+    if (Report->ReferenceMatches != Expected) {
+      std::cerr << fmt::format(
+          "✖ Error: The reference matched {} functions, the corpus expects "
+          "{}\n",
+          Report->ReferenceMatches, Expected);
+      Ok = false;
+    }
+  }
+
+  OutputBuffer Out;
+  bench::formatDiffReport(Out, *Report);
+  OutputWriter(STDOUT_FILENO).write(Out);
+  return Ok ? 0 : 1;
+}
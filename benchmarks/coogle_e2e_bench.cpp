@@ -0,0 +1,213 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// End-to-end search benchmark over a corpus, reported as JSON.
+//
+//   ./build/coogle_e2e_bench /tmp/corpus > e2e.json
+//   ./build/coogle_e2e_bench --generate=llvm --files=2000 /tmp/corpus
+//   ./build/coogle_e2e_bench --scaling=16 /tmp/corpus > scaling.json
+//
+// With --generate the synthetic corpus is written first and every query's
+// match count is checked against the generator's expectation. --scaling
+// sweeps the worker count instead and reports speedup, efficiency and idle
+// time for the first query.
+
+#include "cli.h"
+#include "corpus.h"
+#include "e2e.h"
+
+#include "coogle/search.h"
+
+#include <fmt/core.h>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+using namespace coogle;
+using bench::parseValue;
+
+namespace {
+
+void printUsage(const char *ProgramName) {
+  std::cerr << fmt::format("Usage:\n  {} [options] <corpus_directory>\n\n",
+                           ProgramName);
+  std::cerr << "Options:\n"
+               "  --repetitions=N     Timed runs per query and cache state "
+               "(default 5)\n"
+               "  --threads=N         Worker count (default: all cores)\n"
+               "  --warm-only         Skip the cold-cache runs\n"
+               "  --scaling[=MAX]     Sweep 1, 2, 4 ... MAX workers (default: "
+               "all cores)\n"
+               "  --query=SIG         Query to time (repeatable)\n"
+               "  --generate=PRESET   Write a synthetic corpus first and "
+               "verify matches\n"
+               "  --seed=N            Seed for --generate\n"
+               "  --files=N           File count for --generate\n"
+               "  --output=FILE       Write the JSON report to FILE instead "
+               "of stdout\n";
+}
+
+struct Options {
+  bench::E2EConfig Config;
+  std::optional<corpus::CorpusConfig> Generate;
+  std::optional<std::uint64_t> Seed;
+  std::optional<std::size_t> NumFiles;
+  std::optional<std::size_t> ScalingMax; // --scaling[=MAX]
+  std::string OutputPath;
+  std::string Corpus;
+};
+
+std::optional<Options> parseArgs(int Argc, char *Argv[]) {
+  Options Opts;
+  std::vector<std::string_view> Positional;
+  for (int i = 1; i < Argc; ++i) {
+    std::string_view Arg = Argv[i];
+    if (Arg == "--help" || Arg == "-h") {
+      printUsage(Argv[0]);
+      std::exit(0);
+    }
+    if (Arg.substr(0, 2) != "--") {
+      Positional.push_back(Arg);
+      continue;
+    }
+
+    const std::size_t Eq = Arg.find('=');
+    const std::string_view Name = Arg.substr(0, Eq);
+    const std::string_view Value =
+        Eq == std::string_view::npos ? std::string_view() : Arg.substr(Eq + 1);
+    bool Ok = Eq != std::string_view::npos;
+    if (Arg == "--warm-only") {
+      Opts.Config.Cold = false;
+      Ok = true;
+    } else if (Arg == "--scaling") {
+      Opts.ScalingMax = defaultThreadCount();
+      Ok = true;
+    } else if (Name == "--scaling") {
+      Opts.ScalingMax.emplace();
+      Ok = Ok && parseValue(Value, *Opts.ScalingMax) && *Opts.ScalingMax > 0;
+    } else if (Name == "--repetitions") {
+      Ok = Ok && parseValue(Value, Opts.Config.Repetitions) &&
+           Opts.Config.Repetitions > 0;
+    } else if (Name == "--threads") {
+      Ok = Ok && parseValue(Value, Opts.Config.NumThreads);
+    } else if (Name == "--query") {
+      Opts.Config.Queries.emplace_back(Value);
+    } else if (Name == "--generate") {
+      Opts.Generate = corpus::corpusPreset(Value);
+      Ok = Ok && Opts.Generate.has_value();
+    } else if (Name == "--seed") {
+      Opts.Seed.emplace();
+      Ok = Ok && parseValue(Value, *Opts.Seed);
+    } else if (Name == "--files") {
+      Opts.NumFiles.emplace();
+      Ok = Ok && parseValue(Value, *Opts.NumFiles);
+    } else if (Name == "--output") {
+      Opts.OutputPath = Value;
+    } else {
+      std::cerr << fmt::format("✖ Error: Unknown option '{}'\n\n", Arg);
+      printUsage(Argv[0]);
+      return std::nullopt;
+    }
+    if (!Ok) {
+      std::cerr << fmt::format("✖ Error: Invalid {} value '{}'\n", Name,
+                               Value);
+      return std::nullopt;
+    }
+  }
+
+  if (Positional.size() != 1) {
+    std::cerr << "✖ Error: Incorrect number of arguments.\n\n";
+    printUsage(Argv[0]);
+    return std::nullopt;
+  }
+  Opts.Corpus = Positional[0];
+  if (Opts.Generate) {
+    Opts.Generate->Seed = Opts.Seed.value_or(Opts.Generate->Seed);
+    Opts.Generate->NumFiles = Opts.NumFiles.value_or(Opts.Generate->NumFiles);
+  }
+  if (Opts.Config.Queries.empty()) {
+    Opts.Config.Queries = corpus::defaultCorpusQueries();
+  }
+  return Opts;
+}
+
+// Compares measured match counts with the generator's expectations.
+bool verifyMatches(const bench::E2EReport &Report,
+                   const corpus::CorpusSummary &Summary) {
+  bool Ok = true;
+  for (std::size_t i = 0; i < Report.Queries.size(); ++i) {
+    const auto &[Query, Expected] = Summary.Expected[i];
+    if (Report.Queries[i].Matches != Expected) {
+      std::cerr << fmt::format(
+          "✖ Error: '{}' matched {} functions, the corpus expects {}\n",
+          Query, Report.Queries[i].Matches, Expected);
+      Ok = false;
+    }
+  }
+  return Ok;
+}
+
+// Writes Out to --output or stdout.
+bool emitReport(const Options &Opts, OutputBuffer &Out) {
+  if (!Opts.OutputPath.empty()) {
+    return writeFileContents(Opts.OutputPath, Out, "report");
+  }
+  return OutputWriter(STDOUT_FILENO).write(Out);
+}
+
+// --scaling: table on stderr, JSON on stdout (or --output).
+bool runScalingSweep(const Options &Opts) {
+  auto Report = bench::runScaling(Opts.Corpus, Opts.Config.Queries.front(),
+                                  bench::scalingThreadCounts(*Opts.ScalingMax),
+                                  Opts.Config.Repetitions);
+  if (!Report) {
+    return false;
+  }
+  OutputBuffer Table;
+  bench::formatScalingTable(Table, *Report);
+  OutputWriter(STDERR_FILENO).write(Table);
+
+  OutputBuffer Out;
+  bench::formatScalingJson(Out, *Report);
+  return emitReport(Opts, Out);
+}
+
+} // anonymous namespace
+
+int main(int Argc, char *Argv[]) {
+  auto Opts = parseArgs(Argc, Argv);
+  if (!Opts) {
+    return 1;
+  }
+
+  std::optional<corpus::CorpusSummary> Summary;
+  if (Opts->Generate) {
+    Summary = corpus::writeCorpus(*Opts->Generate, Opts->Config.Queries,
+                                  Opts->Corpus);
+    if (!Summary) {
+      return 1;
+    }
+  }
+
+  if (Opts->ScalingMax) {
+    return runScalingSweep(*Opts) ? 0 : 1;
+  }
+
+  auto Report = bench::runE2E(Opts->Corpus, Opts->Config);
+  if (!Report) {
+    return 1;
+  }
+  if (Summary && !verifyMatches(*Report, *Summary)) {
+    return 1;
+  }
+  if (Opts->Config.Cold && !Report->ColdEvicted) {
+    std::cerr << "✖ Warning: Could not evict the corpus from the page "
+                 "cache; cold runs are warm\n";
+  }
+
+  OutputBuffer Out;
+  bench::formatE2EJson(Out, *Report);
+  return emitReport(*Opts, Out) ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Large-scale stress test of the search pipeline (ctest -L stress).
+//
+//   ./build/coogle_stress /tmp/stress             # 100k-file synthetic tree
+//   ./build/coogle_stress --files=20000 /tmp/stress
+//   ./build/coogle_stress --existing ~/src/llvm-project
+//
+// Writes a synthetic corpus (the "llvm" preset) to the directory, searches
+// it in growing prefixes and exits non-zero if any limit in stress.h is
+// exceeded. --existing skips generation and stresses the files already
+// there; the match count is then not checked.
+
+#include "cli.h"
+#include "corpus.h"
+#include "stress.h"
+
+#include "coogle/search.h"
+
+#include <algorithm>
+#include <fmt/core.h>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+using namespace coogle;
+using bench::parseValue;
+
+namespace {
+
+void printUsage(const char *ProgramName) {
+  std::cerr << fmt::format("Usage:\n  {} [options] <directory>\n\n",
+                           ProgramName);
+  std::cerr << "Options:\n"
+               "  --files=N             Files to generate (default 100000)\n"
+               "  --seed=N              Corpus seed\n"
+               "  --existing            Stress the files already in the "
+               "directory\n"
+               "  --threads=N           Worker count (default: all cores)\n"
+               "  --query=SIG           Query to run (default 'void(*)')\n"
+               "  --steps=N             Prefix sizes to time (default 4)\n"
+               "  --max-slowdown=X      Per-file cost limit relative to the "
+               "smallest step\n"
+               "  --max-rss-growth=MIB  Peak RSS growth limit\n"
+               "  --max-idle=X          Worker idle fraction limit\n";
+}
+
+struct Options {
+  bench::StressConfig Config;
+  corpus::CorpusConfig Corpus = *corpus::corpusPreset("llvm");
+  bool Existing = false;
+  std::string Directory;
+};
+
+std::optional<Options> parseArgs(int Argc, char *Argv[]) {
+  Options Opts;
+  Opts.Corpus.NumFiles = 100000;
+  std::vector<std::string_view> Positional;
+  for (int i = 1; i < Argc; ++i) {
+    std::string_view Arg = Argv[i];
+    if (Arg == "--help" || Arg == "-h") {
+      printUsage(Argv[0]);
+      std::exit(0);
+    }
+    if (Arg.substr(0, 2) != "--") {
+      Positional.push_back(Arg);
+      continue;
+    }
+
+    const std::size_t Eq = Arg.find('=');
+    const std::string_view Name = Arg.substr(0, Eq);
+    const std::string_view Value =
+        Eq == std::string_view::npos ? std::string_view() : Arg.substr(Eq + 1);
+    bool Ok = Eq != std::string_view::npos;
+    std::uint64_t RssMiB = 0;
+    if (Arg == "--existing") {
+      Opts.Existing = true;
+      Ok = true;
+    } else if (Name == "--files") {
+      Ok = Ok && parseValue(Value, Opts.Corpus.NumFiles) &&
+           Opts.Corpus.NumFiles > 0;
+    } else if (Name == "--seed") {
+      Ok = Ok && parseValue(Value, Opts.Corpus.Seed);
+    } else if (Name == "--threads") {
+      Ok = Ok && parseValue(Value, Opts.Config.NumThreads);
+    } else if (Name == "--query") {
+      Opts.Config.Query = Value;
+    } else if (Name == "--steps") {
+      Ok = Ok && parseValue(Value, Opts.Config.Steps) && Opts.Config.Steps > 0;
+    } else if (Name == "--max-slowdown") {
+      Ok = Ok && parseValue(Value, Opts.Config.MaxSlowdown);
+    } else if (Name == "--max-rss-growth") {
+      Ok = Ok && parseValue(Value, RssMiB);
+      Opts.Config.MaxRssGrowthBytes = RssMiB << 20;
+    } else if (Name == "--max-idle") {
+      Ok = Ok && parseValue(Value, Opts.Config.MaxIdle);
+    } else {
+      std::cerr << fmt::format("✖ Error: Unknown option '{}'\n\n", Arg);
+      printUsage(Argv[0]);
+      return std::nullopt;
+    }
+    if (!Ok) {
+      std::cerr << fmt::format("✖ Error: Invalid {} value '{}'\n", Name,
+                               Value);
+      return std::nullopt;
+    }
+  }
+
+  if (Positional.size() != 1) {
+    std::cerr << "✖ Error: Incorrect number of arguments.\n\n";
+    printUsage(Argv[0]);
+    return std::nullopt;
+  }
+  Opts.Directory = Positional[0];
+  return Opts;
+}
+
+} // anonymous namespace
+
+int main(int Argc, char *Argv[]) {
+  auto Opts = parseArgs(Argc, Argv);
+  if (!Opts) {
+    return 1;
+  }
+
+  std::optional<std::size_t> Expected;
+  if (!Opts->Existing) {
+    auto Summary = corpus::writeCorpus(Opts->Corpus, {Opts->Config.Query},
+                                       Opts->Directory);
+    if (!Summary) {
+      return 1;
+    }
+    Expected = Summary->Expected.front().second;
+  }
+
+  // Sorted so that every prefix is the same set of files on every run
+  std::vector<std::string> Files = findSourceFiles(Opts->Directory);
+  std::sort(Files.begin(), Files.end());
+  if (Expected && Files.size() != Opts->Corpus.NumFiles) {
+    std::cerr << fmt::format("✖ Error: Found {} files, generated {}\n",
+                             Files.size(), Opts->Corpus.NumFiles);
+    return 1;
+  }
+
+  auto Report = bench::runStress(Files, Opts->Config);
+  if (!Report) {
+    return 1;
+  }
+  OutputBuffer Out;
+  bench::formatStressTable(Out, *Report);
+  OutputWriter(STDOUT_FILENO).write(Out);
+
+  const auto Violations = bench::checkStress(*Report, Opts->Config, Expected);
+  for (const std::string &Violation : Violations) {
+    std::cerr << fmt::format("✖ Error: {}\n", Violation);
+  }
+  return Violations.empty() ? 0 : 1;
+}
@@ -0,0 +1,526 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Deterministic synthetic C++ corpus generator.
+
+#include "corpus.h"
+
+#include "coogle/parser.h"
+
+#include <array>
+#include <cmath>
+#include <fmt/core.h>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace coogle::corpus {
+
+namespace {
+// SplitMix64: tiny, fast and fully specified, unlike std:: distributions.
+class Rng {
+  std::uint64_t State_;
+
+public:
+  explicit Rng(std::uint64_t Seed) : State_(Seed) {}
+
+  std::uint64_t next() {
+    std::uint64_t Z = (State_ += 0x9E3779B97F4A7C15ULL);
+    Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBULL;
+    return Z ^ (Z >> 31);
+  }
+
+  // Uniform integer in [0, N).
+  std::size_t uniform(std::size_t N) {
+    return N == 0 ? 0 : static_cast<std::size_t>(next() % N);
+  }
+
+  // Uniform real in [0, 1).
+  double real() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+  bool chance(double P) { return real() < P; }
+
+  // Standard normal deviate (Box-Muller).
+  double normal() {
+    const double U1 = 1.0 - real(); // (0, 1]
+    const double U2 = real();
+    return std::sqrt(-2.0 * std::log(U1)) * std::cos(2.0 * M_PI * U2);
+  }
+
+  template <typename T, std::size_t N>
+  const T &pick(const std::array<T, N> &A) {
+    return A[uniform(N)];
+  }
+};
+
+// A builtin type and the alias the corpus declares for it. Repeated entries
+// weight the draw towards the types real code uses most.
+struct Builtin {
+  std::string_view Canonical; // Spelling of the canonical type
+  std::string_view Alias;
+};
+
+constexpr std::array<Builtin, 14> Builtins = {{
+    {"int", "Index"},
+    {"int", "Index"},
+    {"int", "Index"},
+    {"unsigned int", "Count"},
+    {"long", "Offset"},
+    {"unsigned long", "Size"},
+    {"unsigned long", "Size"},
+    {"double", "Real"},
+    {"float", "Ratio"},
+    {"bool", "Flag"},
+    {"char", "Byte"},
+    {"const char *", "CStr"},
+    {"const char *", "CStr"},
+    {"void *", "Handle"},
+}};
+
+constexpr std::array<std::string_view, 8> NamespaceNames = {
+    "core", "detail", "support", "impl", "v1", "util", "analysis", "codegen"};
+
+constexpr std::array<std::string_view, 6> StructParams = {
+    "const Widget &", "Widget *", "const Gadget &",
+    "Gadget &",       "Node *",   "const Node *"};
+
+constexpr std::array<std::string_view, 4> StructReturns = {
+    "Widget *", "const Gadget *", "Node *", "Widget"};
+
+// Stand-in canonical type for anything that is not a builtin. It never
+// equals a builtin, so only wildcards can match it.
+constexpr std::string_view OpaqueType = "corpus::Opaque";
+
+// A type as written in the source plus its canonical spelling.
+struct TypeChoice {
+  std::string Spelling;
+  std::string Canonical;
+};
+
+class FileGenerator {
+  const CorpusConfig &Config_;
+  Rng &Rng_;
+  std::string Out_;
+  std::vector<std::string> Signatures_; // Canonical "ret(args)" per function
+  std::size_t NextName_ = 0;
+
+public:
+  FileGenerator(const CorpusConfig &Config, Rng &R)
+      : Config_(Config), Rng_(R) {}
+
+  std::string &text() { return Out_; }
+  const std::vector<std::string> &signatures() const { return Signatures_; }
+
+  void generate(std::size_t FileIndex, std::size_t NumFunctions) {
+    Out_ += fmt::format("// Generated by coogle_corpus (seed {}, file {}). "
+                        "Do not edit.\n\n",
+                        Config_.Seed, FileIndex);
+
+    std::string Closing;
+    Out_ += "namespace corpus {\n";
+    Closing = "} // namespace corpus\n";
+    for (std::size_t i = 0; i < Config_.NamespaceDepth; ++i) {
+      std::string_view Name = Rng_.pick(NamespaceNames);
+      Out_ += fmt::format("namespace {} {{\n", Name);
+      Closing = fmt::format("}} // namespace {}\n", Name) + Closing;
+    }
+    Out_ += '\n';
+    emitPrelude();
+
+    std::size_t Emitted = 0;
+    std::size_t ClassIndex = 0;
+    while (Emitted < NumFunctions) {
+      if (Rng_.chance(Config_.MethodRatio)) {
+        const std::size_t Methods =
+            std::min(NumFunctions - Emitted, 1 + Rng_.uniform(6));
+        emitClass(ClassIndex++, Methods);
+        Emitted += Methods;
+      } else {
+        emitFreeFunction();
+        Emitted++;
+      }
+      // Function templates are not indexed; they only add parse work
+      if (Rng_.chance(0.05)) {
+        emitFunctionTemplate();
+      }
+    }
+
+    Out_ += '\n';
+    Out_ += Closing;
+  }
+
+private:
+  void emitPrelude() {
+    Out_ += "struct Widget { int id; };\n"
+            "struct Gadget { double weight; };\n"
+            "struct Node { Node *next; };\n"
+            "template <typename T> struct Box { T value; };\n"
+            "template <typename A, typename B> struct Pair { A first; "
+            "B second; };\n\n";
+    std::string_view Last;
+    for (const Builtin &B : Builtins) {
+      if (B.Alias == Last) {
+        continue;
+      }
+      Last = B.Alias;
+      if (Rng_.chance(0.5)) {
+        Out_ += fmt::format("typedef {} {};\n", B.Canonical, B.Alias);
+      } else {
+        Out_ += fmt::format("using {} = {};\n", B.Alias, B.Canonical);
+      }
+    }
+    Out_ += '\n';
+  }
+
+  TypeChoice builtinType() {
+    const Builtin &B = Rng_.pick(Builtins);
+    const bool UseAlias = Rng_.chance(Config_.TypedefRatio);
+    return {std::string(UseAlias ? B.Alias : B.Canonical),
+            std::string(B.Canonical)};
+  }
+
+  // Spelling of a class-template instantiation nested up to Depth levels.
+  std::string templateSpelling(std::size_t Depth) {
+    if (Depth == 0) {
+      return builtinType().Spelling;
+    }
+    if (Rng_.chance(0.5)) {
+      return fmt::format("Box<{}>", templateSpelling(Depth - 1));
+    }
+    return fmt::format("Pair<{}, {}>", templateSpelling(Depth - 1),
+                       templateSpelling(Rng_.uniform(Depth)));
+  }
+
+  TypeChoice paramType() {
+    const double R = Rng_.real();
+    if (R < Config_.TemplateRatio && Config_.TemplateDepth > 0) {
+      const std::size_t Depth = 1 + Rng_.uniform(Config_.TemplateDepth);
+      return {fmt::format("const {} &", templateSpelling(Depth)),
+              std::string(OpaqueType)};
+    }
+    if (R < Config_.TemplateRatio + 0.2) {
+      return {std::string(Rng_.pick(StructParams)), std::string(OpaqueType)};
+    }
+    return builtinType();
+  }
+
+  TypeChoice returnType() {
+    const double R = Rng_.real();
+    if (R < 0.4) {
+      return {"void", "void"};
+    }
+    if (R < 0.85) {
+      return builtinType();
+    }
+    if (R < 0.95 || Config_.TemplateDepth == 0) {
+      return {std::string(Rng_.pick(StructReturns)), std::string(OpaqueType)};
+    }
+    return {templateSpelling(1), std::string(OpaqueType)};
+  }
+
+  std::size_t arity() {
+    const double R = Rng_.real();
+    return R < 0.15 ? 0 : R < 0.50 ? 1 : R < 0.80 ? 2 : R < 0.95 ? 3 : 4;
+  }
+
+  // Emits "name(params)" and records the canonical signature.
+  std::string declarator(const TypeChoice &Ret) {
+    std::string Params;
+    std::string Canonical = Ret.Canonical + "(";
+    const std::size_t N = arity();
+    for (std::size_t i = 0; i < N; ++i) {
+      const TypeChoice T = paramType();
+      if (i > 0) {
+        Params += ", ";
+        Canonical += ", ";
+      }
+      const char Last = T.Spelling.back();
+      Params += fmt::format("{}{}a{}", T.Spelling,
+                            Last == '*' || Last == '&' ? "" : " ", i);
+      Canonical += T.Canonical;
+    }
+    Canonical += ')';
+    Signatures_.push_back(std::move(Canonical));
+    return fmt::format("fn{}({})", NextName_++, Params);
+  }
+
+  static std::string body(const TypeChoice &Ret) {
+    return Ret.Spelling == "void" ? "{}" : "{ return {}; }";
+  }
+
+  void emitFreeFunction() {
+    const TypeChoice Ret = returnType();
+    const std::string Decl = declarator(Ret);
+    switch (Rng_.uniform(3)) {
+    case 0:
+      Out_ += fmt::format("{} {};\n", Ret.Spelling, Decl);
+      break;
+    case 1:
+      Out_ += fmt::format("static {} {} {}\n", Ret.Spelling, Decl, body(Ret));
+      break;
+    default:
+      Out_ += fmt::format("inline {} {} {}\n", Ret.Spelling, Decl, body(Ret));
+      break;
+    }
+  }
+
+  void emitClass(std::size_t Index, std::size_t Methods) {
+    Out_ += fmt::format("\nclass Service{} {{\npublic:\n", Index);
+    for (std::size_t i = 0; i < Methods; ++i) {
+      const TypeChoice Ret = returnType();
+      const std::string Decl = declarator(Ret);
+      switch (Rng_.uniform(3)) {
+      case 0:
+        Out_ += fmt::format("  {} {} const;\n", Ret.Spelling, Decl);
+        break;
+      case 1:
+        Out_ += fmt::format("  static {} {};\n", Ret.Spelling, Decl);
+        break;
+      default:
+        Out_ += fmt::format("  {} {} {}\n", Ret.Spelling, Decl, body(Ret));
+        break;
+      }
+    }
+    Out_ += "};\n\n";
+  }
+
+  void emitFunctionTemplate() {
+    Out_ += fmt::format(
+        "template <typename T> T pick{}(T a0, T a1) {{ return a0; }}\n",
+        NextName_++);
+  }
+};
+
+// Functions in one file: log-normal around the configured mean.
+std::size_t functionCount(const CorpusConfig &Config, Rng &R) {
+  if (Config.SizeSigma <= 0) {
+    return std::max<std::size_t>(1, std::lround(Config.FunctionsPerFile));
+  }
+  const double Mu = std::log(Config.FunctionsPerFile) -
+                    Config.SizeSigma * Config.SizeSigma / 2;
+  const double N = std::exp(Mu + Config.SizeSigma * R.normal());
+  return std::max<std::size_t>(1, std::lround(N));
+}
+
+void appendConfigField(OutputBuffer &Out, std::string_view Name, double Value,
+                       bool First = false) {
+  if (!First) {
+    Out.append(',');
+  }
+  appendJsonString(Out, Name);
+  Out.append(fmt::format(":{}", Value));
+}
+// True for the entries writeCorpus() creates directly under the root:
+// manifest.json and the dNNN directories.
+bool isCorpusEntry(const fs::path &Entry) {
+  const std::string Name = Entry.filename().string();
+  if (Name == "manifest.json") {
+    return true;
+  }
+  return Name.size() > 1 && Name[0] == 'd' &&
+         Name.find_first_not_of("0123456789", 1) == std::string::npos;
+}
+
+// Removes a corpus generated earlier under Root, so a smaller one written
+// over it does not inherit its extra files. Prints an error and returns
+// false if Root holds anything else.
+bool clearCorpusDirectory(const fs::path &Root) {
+  std::error_code Ec;
+  if (!fs::exists(Root, Ec)) {
+    return true;
+  }
+  std::vector<fs::path> Entries;
+  for (const auto &Entry : fs::directory_iterator(Root, Ec)) {
+    if (!isCorpusEntry(Entry.path())) {
+      std::cerr << fmt::format("✖ Error: '{}' is not empty and does not "
+                               "hold a generated corpus\n",
+                               Root.string());
+      return false;
+    }
+    Entries.push_back(Entry.path());
+  }
+  if (Ec) {
+    std::cerr << fmt::format("✖ Error: Cannot read '{}'\n", Root.string());
+    return false;
+  }
+  for (const fs::path &Entry : Entries) {
+    fs::remove_all(Entry, Ec);
+    if (Ec) {
+      std::cerr << fmt::format("✖ Error: Cannot remove '{}'\n",
+                               Entry.string());
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+std::optional<CorpusConfig> corpusPreset(std::string_view Name) {
+  CorpusConfig Config;
+  if (Name == "small") {
+    Config.NumFiles = 20;
+    Config.FunctionsPerFile = 20;
+  } else if (Name == "llvm") {
+    Config.NumFiles = 2000;
+    Config.FunctionsPerFile = 60;
+    Config.SizeSigma = 1.0;
+    Config.NamespaceDepth = 2;
+    Config.TemplateDepth = 2;
+    Config.TypedefRatio = 0.25;
+    Config.MethodRatio = 0.5;
+    Config.TemplateRatio = 0.15;
+    Config.HeaderRatio = 0.35;
+  } else if (Name == "boost") {
+    Config.NumFiles = 1000;
+    Config.FunctionsPerFile = 30;
+    Config.SizeSigma = 1.2;
+    Config.NamespaceDepth = 3;
+    Config.TemplateDepth = 4;
+    Config.TypedefRatio = 0.4;
+    Config.MethodRatio = 0.4;
+    Config.TemplateRatio = 0.35;
+    Config.HeaderRatio = 0.9;
+  } else {
+    return std::nullopt;
+  }
+  return Config;
+}
+
+const std::vector<std::string> &defaultCorpusQueries() {
+  static const std::vector<std::string> Queries = {
+      "void(*)",
+      "void(*, *)",
+      "int(int, int)",
+      "void(int)",
+      "bool(const char *)",
+      "double(double, double)",
+      "unsigned long(const char *, unsigned long)",
+      "int()",
+  };
+  return Queries;
+}
+
+CorpusSummary generateCorpus(const CorpusConfig &Config,
+                             const std::vector<std::string> &Queries,
+                             const FileSink &Sink) {
+  // Parse queries once; each keeps its own storage
+  std::vector<SignatureStorage> QueryStorage(Queries.size());
+  std::vector<std::optional<Signature>> QuerySigs;
+  for (std::size_t i = 0; i < Queries.size(); ++i) {
+    QuerySigs.push_back(parseFunctionSignature(QueryStorage[i], Queries[i]));
+  }
+
+  CorpusSummary Summary;
+  std::vector<std::size_t> Matches(Queries.size(), 0);
+  Rng R(Config.Seed);
+
+  for (std::size_t FileIndex = 0; FileIndex < Config.NumFiles; ++FileIndex) {
+    FileGenerator Gen(Config, R);
+    Gen.generate(FileIndex, functionCount(Config, R));
+
+    const bool IsHeader = R.chance(Config.HeaderRatio);
+    const std::string Path = fmt::format(
+        "d{:03}/f{:05}.{}",
+        FileIndex / std::max<std::size_t>(1, Config.FilesPerDirectory),
+        FileIndex, IsHeader ? "hpp" : "cpp");
+
+    for (const std::string &Canonical : Gen.signatures()) {
+      SignatureStorage Storage;
+      auto Actual = parseFunctionSignature(Storage, Canonical);
+      for (std::size_t q = 0; q < Queries.size(); ++q) {
+        if (Actual && QuerySigs[q] &&
+            isSignatureMatch(*QuerySigs[q], *Actual)) {
+          Matches[q]++;
+        }
+      }
+    }
+
+    Summary.Files++;
+    Summary.Functions += Gen.signatures().size();
+    Summary.Bytes += Gen.text().size();
+    Sink(Path, Gen.text());
+  }
+
+  for (std::size_t q = 0; q < Queries.size(); ++q) {
+    Summary.Expected.emplace_back(Queries[q], Matches[q]);
+  }
+  return Summary;
+}
+
+void formatManifest(OutputBuffer &Out, const CorpusConfig &Config,
+                    const CorpusSummary &Summary) {
+  Out.append("{\"generator\":\"coogle_corpus\",\"seed\":");
+  Out.appendUnsigned(Config.Seed);
+  Out.append(",\"config\":{");
+  appendConfigField(Out, "files_per_directory",
+                    static_cast<double>(Config.FilesPerDirectory), true);
+  appendConfigField(Out, "functions_per_file", Config.FunctionsPerFile);
+  appendConfigField(Out, "size_sigma", Config.SizeSigma);
+  appendConfigField(Out, "namespace_depth",
+                    static_cast<double>(Config.NamespaceDepth));
+  appendConfigField(Out, "template_depth",
+                    static_cast<double>(Config.TemplateDepth));
+  appendConfigField(Out, "typedef_ratio", Config.TypedefRatio);
+  appendConfigField(Out, "method_ratio", Config.MethodRatio);
+  appendConfigField(Out, "template_ratio", Config.TemplateRatio);
+  appendConfigField(Out, "header_ratio", Config.HeaderRatio);
+  Out.append("},\"files\":");
+  Out.appendUnsigned(Summary.Files);
+  Out.append(",\"functions\":");
+  Out.appendUnsigned(Summary.Functions);
+  Out.append(",\"bytes\":");
+  Out.appendUnsigned(Summary.Bytes);
+  Out.append(",\"expected\":[");
+  for (std::size_t i = 0; i < Summary.Expected.size(); ++i) {
+    Out.append(i == 0 ? "\n  " : ",\n  ");
+    Out.append("{\"query\":");
+    appendJsonString(Out, Summary.Expected[i].first);
+    Out.append(",\"matches\":");
+    Out.appendUnsigned(Summary.Expected[i].second);
+    Out.append('}');
+  }
+  Out.append("\n]}\n");
+}
+
+std::optional<CorpusSummary>
+writeCorpus(const CorpusConfig &Config, const std::vector<std::string> &Queries,
+            const fs::path &Root) {
+  if (!clearCorpusDirectory(Root)) {
+    return std::nullopt;
+  }
+
+  bool Ok = true;
+  CorpusSummary Summary = generateCorpus(
+      Config, Queries, [&](const std::string &Path, const std::string &Text) {
+        if (!Ok) {
+          return;
+        }
+        const fs::path File = Root / Path;
+        std::error_code Ec;
+        fs::create_directories(File.parent_path(), Ec);
+        std::ofstream Stream(File, std::ios::binary | std::ios::trunc);
+        Stream << Text;
+        if (Ec || !Stream) {
+          std::cerr << fmt::format("✖ Error: Cannot write '{}'\n",
+                                   File.string());
+          Ok = false;
+        }
+      });
+  if (!Ok) {
+    return std::nullopt;
+  }
+
+  OutputBuffer Manifest;
+  formatManifest(Manifest, Config, Summary);
+  if (!writeFileContents((Root / "manifest.json").string(), Manifest,
+                         "manifest")) {
+    return std::nullopt;
+  }
+  return Summary;
+}
+
+} // namespace coogle::corpus
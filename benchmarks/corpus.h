@@ -0,0 +1,81 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Deterministic synthetic C++ corpus for offline end-to-end benchmarks.
+//
+// Every file is self-contained (coogle parses with -nostdinc and without
+// following includes): it declares its own structs, class templates and
+// typedef aliases inside nested namespaces, followed by free functions,
+// methods and a few function templates. Because the generator knows the
+// canonical type of every parameter it emits, it can also report how many
+// functions each benchmark query must match.
+//
+// The pseudo-random stream is a private SplitMix64, so a given seed and
+// config produce byte-identical corpora regardless of the standard library.
+
+#pragma once
+
+#include "coogle/output.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle::corpus {
+
+// Knobs shaping the generated code.
+struct CorpusConfig {
+  std::uint64_t Seed = 1;
+  std::size_t NumFiles = 100;
+  std::size_t FilesPerDirectory = 50;
+  double FunctionsPerFile = 40; // Mean of the per-file function count
+  double SizeSigma = 0.8;       // Log-normal spread of file sizes (0 = equal)
+  std::size_t NamespaceDepth = 2;
+  std::size_t TemplateDepth = 2; // Max nesting of template arguments
+  double TypedefRatio = 0.2;     // Parameters spelled through an alias
+  double MethodRatio = 0.3;      // Functions declared inside classes
+  double TemplateRatio = 0.15;   // Parameters of class-template type
+  double HeaderRatio = 0.2;      // Files written as .hpp instead of .cpp
+};
+
+// Named presets: "small", "llvm" and "boost".
+std::optional<CorpusConfig> corpusPreset(std::string_view Name);
+
+// Queries whose expected match counts are recorded by default.
+const std::vector<std::string> &defaultCorpusQueries();
+
+// Totals for a generated corpus.
+struct CorpusSummary {
+  std::size_t Files = 0;
+  std::size_t Functions = 0; // Function and method declarations coogle sees
+  std::uint64_t Bytes = 0;
+  std::vector<std::pair<std::string, std::size_t>> Expected; // Query, matches
+};
+
+// Receives each generated file as (path relative to the corpus root,
+// contents).
+using FileSink =
+    std::function<void(const std::string &Path, const std::string &Contents)>;
+
+// Generates the corpus described by Config, handing every file to Sink, and
+// counts the functions each of Queries matches.
+CorpusSummary generateCorpus(const CorpusConfig &Config,
+                             const std::vector<std::string> &Queries,
+                             const FileSink &Sink);
+
+// Appends the corpus manifest (config, totals and expected matches) as JSON.
+void formatManifest(OutputBuffer &Out, const CorpusConfig &Config,
+                    const CorpusSummary &Summary);
+
+// Generates the corpus under Root and writes Root/manifest.json. A corpus
+// generated there before is removed first; any other content is left alone
+// and is an error. Prints an error and returns nullopt on I/O failure.
+std::optional<CorpusSummary>
+writeCorpus(const CorpusConfig &Config, const std::vector<std::string> &Queries,
+            const std::filesystem::path &Root);
+
+} // namespace coogle::corpus
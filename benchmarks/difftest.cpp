@@ -0,0 +1,506 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+
+#include "difftest.h"
+
+#include "coogle/clang_raii.h"
+#include "coogle/colors.h"
+#include "coogle/dump.h"
+#include "coogle/profile.h"
+#include "coogle/search.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fmt/core.h>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <tuple>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace coogle::bench {
+
+namespace {
+
+bool consume(std::string_view &In, std::string_view Prefix) {
+  if (In.substr(0, Prefix.size()) != Prefix) {
+    return false;
+  }
+  In.remove_prefix(Prefix.size());
+  return true;
+}
+
+bool readUnsigned(std::string_view &In, unsigned &Out) {
+  auto [Ptr, Ec] = std::from_chars(In.data(), In.data() + In.size(), Out);
+  if (Ec != std::errc()) {
+    return false;
+  }
+  In.remove_prefix(Ptr - In.data());
+  return true;
+}
+
+// Reads a string literal as written by appendJsonString().
+bool readJsonString(std::string_view &In, std::string &Out) {
+  if (!consume(In, "\"")) {
+    return false;
+  }
+  Out.clear();
+  while (!In.empty()) {
+    const char C = In.front();
+    In.remove_prefix(1);
+    if (C == '"') {
+      return true;
+    }
+    if (C != '\\') {
+      Out += C;
+      continue;
+    }
+    if (In.empty()) {
+      return false;
+    }
+    const char Escape = In.front();
+    In.remove_prefix(1);
+    switch (Escape) {
+    case 'n':
+      Out += '\n';
+      break;
+    case 't':
+      Out += '\t';
+      break;
+    case 'r':
+      Out += '\r';
+      break;
+    case 'b':
+      Out += '\b';
+      break;
+    case 'f':
+      Out += '\f';
+      break;
+    case 'u': {
+      // Only control characters are escaped this way
+      unsigned Code = 0;
+      auto [Ptr, Ec] = std::from_chars(
+          In.data(), In.data() + std::min<std::size_t>(In.size(), 4), Code,
+          16);
+      if (Ec != std::errc() || Ptr != In.data() + 4 || Code > 0x7f) {
+        return false;
+      }
+      Out += static_cast<char>(Code);
+      In.remove_prefix(4);
+      break;
+    }
+    default:
+      Out += Escape; // \" and \\ .
+      break;
+    }
+  }
+  return false;
+}
+
+std::string formatKey(const MatchKey &Key) {
+  return fmt::format("{}:{}:{} {}", Key.File, Key.Line, Key.Column, Key.Name);
+}
+
+// Search settings for a path. Everything is NDJSON so the output can be
+// read back.
+WorkerSettings settingsFor(ResultMode Mode, std::size_t FlushThreshold) {
+  return WorkerSettings{Mode, OutputFormat::Ndjson, colors::palette(false),
+                        FlushThreshold};
+}
+
+// Runs a path against a temporary file and returns everything it wrote:
+// the records flushed by the workers, then their remaining buffers.
+template <typename RunFn>
+std::optional<std::string> captureOutput(RunFn Run) {
+  std::FILE *Tmp = std::tmpfile();
+  if (!Tmp) {
+    std::cerr << "✖ Error: Cannot create a temporary file\n";
+    return std::nullopt;
+  }
+  const int Fd = ::fileno(Tmp);
+  {
+    OutputWriter Writer(Fd);
+    std::vector<TaskResult> Results = Run(Writer);
+    std::vector<OutputBuffer *> Pending;
+    for (TaskResult &Result : Results) {
+      Pending.push_back(&Result.Output);
+    }
+    Writer.write(span<OutputBuffer *>(Pending.data(), Pending.size()));
+  }
+
+  std::string Contents;
+  char Chunk[64 * 1024];
+  ssize_t Read = 0;
+  ::lseek(Fd, 0, SEEK_SET);
+  while ((Read = ::read(Fd, Chunk, sizeof(Chunk))) > 0) {
+    Contents.append(Chunk, static_cast<std::size_t>(Read));
+  }
+  std::fclose(Tmp);
+  if (Read < 0) {
+    std::cerr << "✖ Error: Cannot read back the search output\n";
+    return std::nullopt;
+  }
+  return Contents;
+}
+
+// Parses NDJSON match records, one per line.
+std::optional<std::vector<MatchKey>> parseMatches(std::string_view Text) {
+  std::vector<MatchKey> Keys;
+  while (!Text.empty()) {
+    const std::size_t End = std::min(Text.find('\n'), Text.size());
+    const std::string_view Line = Text.substr(0, End);
+    Text.remove_prefix(std::min(End + 1, Text.size()));
+    if (Line.empty()) {
+      continue;
+    }
+    auto Key = parseMatchLine(Line);
+    if (!Key) {
+      std::cerr << fmt::format("✖ Error: Unexpected output line '{}'\n",
+                               Line);
+      return std::nullopt;
+    }
+    Keys.push_back(std::move(*Key));
+  }
+  return Keys;
+}
+
+// Parses --files-with-matches NDJSON records ({"file":...}).
+std::optional<std::set<std::string>> parseFiles(std::string_view Text) {
+  std::set<std::string> Files;
+  while (!Text.empty()) {
+    const std::size_t End = std::min(Text.find('\n'), Text.size());
+    std::string_view Line = Text.substr(0, End);
+    Text.remove_prefix(std::min(End + 1, Text.size()));
+    if (Line.empty()) {
+      continue;
+    }
+    std::string File;
+    if (!consume(Line, "{\"file\":") || !readJsonString(Line, File) ||
+        Line != "}") {
+      return std::nullopt;
+    }
+    Files.insert(std::move(File));
+  }
+  return Files;
+}
+
+// Builds the Signature of a decoded dump record, as extractSignature()
+// does from the cursor.
+Signature signatureOf(const DumpRecord &Record, SignatureStorage &Storage) {
+  Storage.clear();
+  Signature Sig;
+  Sig.RetType = Storage.internString(Record.RetType);
+  Sig.RetTypeNorm = normalizeType(Storage.arena(), Sig.RetType);
+  Storage.reserveArgs(Record.ArgTypes.size());
+  for (const std::string &Arg : Record.ArgTypes) {
+    const std::string_view Interned = Storage.internString(Arg);
+    Storage.addArg(Interned, normalizeType(Storage.arena(), Interned));
+  }
+  Sig.ArgTypes = Storage.getArgs();
+  Sig.ArgTypesNorm = Storage.getArgsNorm();
+  Sig.VariadicTail = Record.Variadic;
+  return Sig;
+}
+
+// Decodes a binary dump stream (without the magic).
+std::optional<std::vector<DumpRecord>> decodeDump(std::string_view In) {
+  std::vector<DumpRecord> Records;
+  while (!In.empty()) {
+    auto Record = decodeDumpRecord(In);
+    if (!Record) {
+      std::cerr << "✖ Error: Malformed dump record\n";
+      return std::nullopt;
+    }
+    Records.push_back(std::move(*Record));
+  }
+  return Records;
+}
+
+// Reference visitor context.
+struct OracleContext {
+  const Signature *Target;
+  const std::string *CurrentFile;
+  SignatureStorage *Scratch;
+  std::vector<MatchKey> *Matches;
+};
+
+// Reports a function the way the search visitor does, but matches it with
+// isSignatureMatch() instead of the compiled MatchProgram.
+CXChildVisitResult oracleVisitor(CXCursor Cursor,
+                                 [[maybe_unused]] CXCursor Parent,
+                                 CXClientData ClientData) {
+  auto *Ctx = static_cast<OracleContext *>(ClientData);
+  if (!isFunctionCursor(clang_getCursorKind(Cursor))) {
+    return CXChildVisit_Recurse;
+  }
+  Ctx->Scratch->clear();
+  if (!isSignatureMatch(*Ctx->Target,
+                        extractSignature(Cursor, *Ctx->Scratch))) {
+    return CXChildVisit_Recurse;
+  }
+  CXSourceLocation Location = clang_getCursorLocation(Cursor);
+  if (clang_Location_isInSystemHeader(Location)) {
+    return CXChildVisit_Continue;
+  }
+  if (!clang_Location_isFromMainFile(Location)) {
+    return CXChildVisit_Recurse;
+  }
+  MatchKey Key{*Ctx->CurrentFile, 0, 0, {}};
+  clang_getSpellingLocation(Location, nullptr, &Key.Line, &Key.Column,
+                            nullptr);
+  CXStringRAII Name(clang_getCursorSpelling(Cursor));
+  Key.Name = Name.c_str() ? Name.c_str() : "";
+  Ctx->Matches->push_back(std::move(Key));
+  return CXChildVisit_Recurse;
+}
+
+// The reference: every file parsed in turn on this thread and every
+// function matched with isSignatureMatch(). It shares only
+// extractSignature() with the search paths, so a bug in MatchProgram, the
+// worker loop or the output formatting shows up as a mismatch. Files that
+// do not parse are skipped, as the search paths skip them.
+std::optional<std::vector<MatchKey>>
+referenceMatches(const std::vector<std::string> &Files,
+                 const Signature &Target,
+                 const std::vector<const char *> &ClangArgs) {
+  CXIndexRAII Index;
+  if (!Index.isValid()) {
+    std::cerr << "✖ Error: Cannot create a Clang index\n";
+    return std::nullopt;
+  }
+  std::vector<MatchKey> Matches;
+  SignatureStorage Scratch;
+  for (const std::string &File : Files) {
+    CXTranslationUnitRAII TU(clang_parseTranslationUnit(
+        Index, File.c_str(), ClangArgs.data(),
+        static_cast<int>(ClangArgs.size()), nullptr, 0, ParseOptions));
+    if (!TU.isValid()) {
+      continue;
+    }
+    OracleContext Ctx{&Target, &File, &Scratch, &Matches};
+    clang_visitChildren(clang_getTranslationUnitCursor(TU), oracleVisitor,
+                        &Ctx);
+  }
+  return Matches;
+}
+
+} // anonymous namespace
+
+bool MatchKey::operator<(const MatchKey &Other) const {
+  return std::tie(File, Line, Column, Name) <
+         std::tie(Other.File, Other.Line, Other.Column, Other.Name);
+}
+
+bool MatchKey::operator==(const MatchKey &Other) const {
+  return std::tie(File, Line, Column, Name) ==
+         std::tie(Other.File, Other.Line, Other.Column, Other.Name);
+}
+
+std::optional<MatchKey> parseMatchLine(std::string_view Line) {
+  MatchKey Key;
+  if (!consume(Line, "{\"file\":") || !readJsonString(Line, Key.File) ||
+      !consume(Line, ",\"line\":") || !readUnsigned(Line, Key.Line) ||
+      !consume(Line, ",\"column\":") || !readUnsigned(Line, Key.Column) ||
+      !consume(Line, ",\"name\":") || !readJsonString(Line, Key.Name)) {
+    return std::nullopt;
+  }
+  return Key;
+}
+
+void diffMatches(std::vector<MatchKey> &Reference,
+                 std::vector<MatchKey> &Actual, std::string_view Path,
+                 std::string_view Query, std::vector<Mismatch> &Out) {
+  std::sort(Reference.begin(), Reference.end());
+  std::sort(Actual.begin(), Actual.end());
+
+  // Multiset difference, so duplicated records are reported too
+  std::vector<MatchKey> Missing;
+  std::vector<MatchKey> Extra;
+  std::set_difference(Reference.begin(), Reference.end(), Actual.begin(),
+                      Actual.end(), std::back_inserter(Missing));
+  std::set_difference(Actual.begin(), Actual.end(), Reference.begin(),
+                      Reference.end(), std::back_inserter(Extra));
+  for (const MatchKey &Key : Missing) {
+    Out.push_back({std::string(Path), std::string(Query),
+                   "missing " + formatKey(Key)});
+  }
+  for (const MatchKey &Key : Extra) {
+    Out.push_back({std::string(Path), std::string(Query),
+                   "extra " + formatKey(Key)});
+  }
+}
+
+std::optional<DiffReport> runDiffTest(const std::vector<std::string> &Files,
+                                      const DiffConfig &Config) {
+  if (Files.empty()) {
+    std::cerr << "✖ Error: No C/C++ files to test\n";
+    return std::nullopt;
+  }
+
+  DiffReport Report;
+  Report.Files = Files.size();
+  Report.Queries = Config.Queries.size();
+  Report.Paths = {"serial", "parallel", "cost-partitioned", "count",
+                  "files-with-matches", "dump"};
+
+  const std::vector<std::string> ArgsVec = defaultClangArgs();
+  std::vector<const char *> ClangArgs;
+  for (const auto &S : ArgsVec) {
+    ClangArgs.push_back(S.c_str());
+  }
+  const std::size_t NumThreads = std::max<std::size_t>(Config.NumThreads, 1);
+
+  CostMap Costs;
+  for (const std::string &File : Files) {
+    std::error_code Ec;
+    Costs[File] = fs::file_size(File, Ec);
+  }
+
+  // The dump does not depend on the query: export once, match per query
+  auto DumpText = captureOutput([&](OutputWriter &Writer) {
+    std::vector<TaskResult> Results;
+    const WorkerSettings Binary{ResultMode::List, OutputFormat::Binary,
+                                colors::palette(false), OutputFlushThreshold};
+    Results.push_back(dumpFiles(Files, ClangArgs, Writer, Binary));
+    return Results;
+  });
+  auto Dump = DumpText ? decodeDump(*DumpText) : std::nullopt;
+  if (!Dump) {
+    return std::nullopt;
+  }
+
+  for (const std::string &Query : Config.Queries) {
+    SignatureStorage TargetStorage;
+    auto Target = parseFunctionSignature(TargetStorage, Query);
+    if (!Target) {
+      std::cerr << fmt::format("✖ Error: Invalid query '{}'\n", Query);
+      return std::nullopt;
+    }
+    auto Search = [&](const std::vector<std::string> &Chunk,
+                      OutputWriter &Writer, const WorkerSettings &Settings) {
+      return processFiles(Chunk, *Target, ClangArgs, Writer, Settings);
+    };
+    const WorkerSettings List = settingsFor(ResultMode::List,
+                                            OutputFlushThreshold);
+    const WorkerSettings Streaming = settingsFor(ResultMode::List, 0);
+
+    auto Reference = referenceMatches(Files, *Target, ClangArgs);
+    if (!Reference) {
+      return std::nullopt;
+    }
+    Report.ReferenceMatches += Reference->size();
+
+    auto SerialText = captureOutput([&](OutputWriter &Writer) {
+      std::vector<TaskResult> Results;
+      Results.push_back(Search(Files, Writer, List));
+      return Results;
+    });
+
+    auto ParallelText = captureOutput([&](OutputWriter &Writer) {
+      return runChunked(Files, NumThreads,
+                        [&](const std::vector<std::string> &Chunk) {
+                          return Search(Chunk, Writer, Streaming);
+                        });
+    });
+    auto PartitionedText = captureOutput([&](OutputWriter &Writer) {
+      return runPartitioned(partitionByCost(Files, Costs, NumThreads),
+                            [&](const std::vector<std::string> &Chunk) {
+                              return Search(Chunk, Writer, List);
+                            });
+    });
+    auto Serial = SerialText ? parseMatches(*SerialText) : std::nullopt;
+    auto Parallel = ParallelText ? parseMatches(*ParallelText) : std::nullopt;
+    auto Partitioned =
+        PartitionedText ? parseMatches(*PartitionedText) : std::nullopt;
+    if (!Serial || !Parallel || !Partitioned) {
+      return std::nullopt;
+    }
+    diffMatches(*Reference, *Serial, "serial", Query, Report.Mismatches);
+    diffMatches(*Reference, *Parallel, "parallel", Query, Report.Mismatches);
+    diffMatches(*Reference, *Partitioned, "cost-partitioned", Query,
+                Report.Mismatches);
+
+    // Count: per-file totals
+    std::map<std::string, std::size_t> RefCounts;
+    for (const MatchKey &Key : *Reference) {
+      RefCounts[Key.File]++;
+    }
+    const WorkerSettings Count = settingsFor(ResultMode::Count, 0);
+    for (const std::string &File : Files) {
+      OutputWriter Discard(-1); // Count mode writes nothing per file
+      const std::size_t Counted =
+          Search({File}, Discard, Count).MatchCount;
+      const auto It = RefCounts.find(File);
+      const std::size_t Expected = It == RefCounts.end() ? 0 : It->second;
+      if (Counted != Expected) {
+        Report.Mismatches.push_back(
+            {"count", Query,
+             fmt::format("{}: {} matches, reference {}", File, Counted,
+                         Expected)});
+      }
+    }
+
+    // Files with matches: the set of files
+    auto FilesText = captureOutput([&](OutputWriter &Writer) {
+      std::vector<TaskResult> Results;
+      Results.push_back(Search(
+          Files, Writer, settingsFor(ResultMode::FilesWithMatches, 0)));
+      return Results;
+    });
+    auto MatchedFiles = FilesText ? parseFiles(*FilesText) : std::nullopt;
+    if (!MatchedFiles) {
+      std::cerr << "✖ Error: Cannot parse --files-with-matches output\n";
+      return std::nullopt;
+    }
+    for (const auto &[File, N] : RefCounts) {
+      if (!MatchedFiles->count(File)) {
+        Report.Mismatches.push_back({"files-with-matches", Query,
+                                     "missing " + File});
+      }
+    }
+    for (const std::string &File : *MatchedFiles) {
+      if (!RefCounts.count(File)) {
+        Report.Mismatches.push_back({"files-with-matches", Query,
+                                     "extra " + File});
+      }
+    }
+
+    // Dump: offline matching of the exported signatures
+    std::vector<MatchKey> Dumped;
+    SignatureStorage Storage;
+    for (const DumpRecord &Record : *Dump) {
+      if (isSignatureMatch(*Target, signatureOf(Record, Storage))) {
+        Dumped.push_back({Record.FileName, Record.Line, Record.Column,
+                          Record.FunctionName});
+      }
+    }
+    diffMatches(*Reference, Dumped, "dump", Query, Report.Mismatches);
+  }
+  return Report;
+}
+
+void formatDiffReport(OutputBuffer &Out, const DiffReport &Report) {
+  for (const Mismatch &M : Report.Mismatches) {
+    Out.append(fmt::format("✖ {} '{}': {}\n", M.Path, M.Query, M.Detail));
+  }
+  std::string Paths;
+  for (const std::string &Path : Report.Paths) {
+    Paths += Paths.empty() ? Path : ", " + Path;
+  }
+  if (Report.Mismatches.empty()) {
+    Out.append(fmt::format(
+        "✓ {} paths agree with the reference on {} queries over {} files "
+        "({} matches): {}\n",
+        Report.Paths.size(), Report.Queries, Report.Files,
+        Report.ReferenceMatches, Paths));
+  } else {
+    Out.append(fmt::format("✖ {} differences from the reference ({})\n",
+                           Report.Mismatches.size(), Paths));
+  }
+}
+
+} // namespace coogle::bench
@@ -0,0 +1,89 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Differential testing of the search paths.
+//
+// The reference is an oracle independent of the search pipeline: each
+// file parsed in turn with the same libclang options and every function
+// matched with isSignatureMatch(), the uncompiled matcher. Every search
+// path is run over the same files and queries and its result set compared
+// with the reference:
+//
+//   serial               processFiles() on a single worker (compiled
+//                        MatchProgram), NDJSON with the default flush
+//                        threshold
+//   parallel             several workers, contiguous chunks, streaming
+//   cost-partitioned     several workers balanced by partitionByCost()
+//                        (--load-profile), file sizes as costs
+//   count                ResultMode::Count, file by file
+//   files-with-matches   ResultMode::FilesWithMatches (stops at the first
+//                        match of a file)
+//   dump                 one `coogle dump` binary export, decoded and
+//                        matched offline with isSignatureMatch()
+//
+// New accelerated paths (indexes, caches, prefilters) add themselves to
+// runDiffTest() so they cannot land while silently dropping matches.
+
+#pragma once
+
+#include "coogle/output.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle::bench {
+
+// Identity of one match; the signature follows from the location.
+struct MatchKey {
+  std::string File;
+  unsigned Line = 0;
+  unsigned Column = 0;
+  std::string Name;
+
+  bool operator<(const MatchKey &Other) const;
+  bool operator==(const MatchKey &Other) const;
+};
+
+// Parses one NDJSON search or dump record. Returns nullopt if Line is not
+// an object starting with the file, line, column and name fields.
+std::optional<MatchKey> parseMatchLine(std::string_view Line);
+
+// A result-set difference between a path and the reference.
+struct Mismatch {
+  std::string Path;  // Path under test, e.g. "parallel"
+  std::string Query;
+  std::string Detail; // "missing a.cpp:12:5 foo", "extra ...", ...
+};
+
+// Appends one "missing" Mismatch for every key of Reference absent from
+// Actual and one "extra" for every key of Actual absent from Reference.
+// Both lists are sorted in place.
+void diffMatches(std::vector<MatchKey> &Reference,
+                 std::vector<MatchKey> &Actual, std::string_view Path,
+                 std::string_view Query, std::vector<Mismatch> &Out);
+
+struct DiffConfig {
+  std::vector<std::string> Queries;
+  std::size_t NumThreads = 4; // Workers for the parallel paths
+};
+
+struct DiffReport {
+  std::size_t Files = 0;
+  std::size_t Queries = 0;
+  std::size_t ReferenceMatches = 0; // Summed over all queries
+  std::vector<std::string> Paths;   // Paths compared with the reference
+  std::vector<Mismatch> Mismatches;
+};
+
+// Runs every query through the reference and every other path over Files.
+// Prints an error and returns nullopt if Files is empty, a query does not
+// parse or a path's output cannot be read back.
+std::optional<DiffReport> runDiffTest(const std::vector<std::string> &Files,
+                                      const DiffConfig &Config);
+
+// Appends one line per mismatch and a summary line.
+void formatDiffReport(OutputBuffer &Out, const DiffReport &Report);
+
+} // namespace coogle::bench
@@ -0,0 +1,390 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// In-process end-to-end benchmark of the search pipeline.
+
+#include "e2e.h"
+
+#include "coogle/colors.h"
+#include "coogle/search.h"
+#include "coogle/stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/core.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace coogle::bench {
+
+namespace {
+// Nearest-rank percentile of sorted samples.
+std::uint64_t percentile(const std::vector<std::uint64_t> &Sorted, double P) {
+  const double Rank = P * static_cast<double>(Sorted.size());
+  std::size_t Index = static_cast<std::size_t>(Rank);
+  if (static_cast<double>(Index) == Rank && Index > 0) {
+    Index--;
+  }
+  return Sorted[std::min(Index, Sorted.size() - 1)];
+}
+
+void appendMs(OutputBuffer &Out, std::string_view Name, std::uint64_t Ns) {
+  Out.append(fmt::format(",\"{}\":{:.3f}", Name, Ns / 1e6));
+}
+
+// Appends one cache state's statistics as a JSON object.
+void appendTimings(OutputBuffer &Out, const std::vector<std::uint64_t> &Ns,
+                   const E2EReport &Report) {
+  const Percentiles P = summarize(Ns);
+  Out.append("{\"runs\":");
+  Out.appendUnsigned(Ns.size());
+  appendMs(Out, "min_ms", P.MinNs);
+  appendMs(Out, "median_ms", P.MedianNs);
+  appendMs(Out, "p90_ms", P.P90Ns);
+  appendMs(Out, "p99_ms", P.P99Ns);
+  appendMs(Out, "max_ms", P.MaxNs);
+  Out.append(fmt::format(",\"stddev_ms\":{:.3f}", P.StddevNs / 1e6));
+  const double Seconds = P.MedianNs / 1e9;
+  Out.append(fmt::format(",\"files_per_sec\":{:.1f}",
+                         Seconds > 0 ? Report.Files / Seconds : 0.0));
+  Out.append(fmt::format(",\"functions_per_sec\":{:.1f}}}",
+                         Seconds > 0 ? Report.Functions / Seconds : 0.0));
+}
+} // anonymous namespace
+
+Percentiles summarize(std::vector<std::uint64_t> Samples) {
+  Percentiles P;
+  if (Samples.empty()) {
+    return P;
+  }
+  std::sort(Samples.begin(), Samples.end());
+  P.MinNs = Samples.front();
+  P.MedianNs = percentile(Samples, 0.5);
+  P.P90Ns = percentile(Samples, 0.9);
+  P.P99Ns = percentile(Samples, 0.99);
+  P.MaxNs = Samples.back();
+  if (Samples.size() > 1) {
+    double Mean = 0;
+    for (std::uint64_t Ns : Samples) {
+      Mean += static_cast<double>(Ns);
+    }
+    Mean /= static_cast<double>(Samples.size());
+    double SumSq = 0;
+    for (std::uint64_t Ns : Samples) {
+      SumSq += (Ns - Mean) * (Ns - Mean);
+    }
+    P.StddevNs = std::sqrt(SumSq / static_cast<double>(Samples.size() - 1));
+  }
+  return P;
+}
+
+std::optional<SearchRun>
+runSearchOnce(const std::vector<std::string> &Files, std::string_view Query,
+              std::size_t NumThreads, bool CollectStats,
+              std::size_t FlushThreshold, const CostMap *Costs) {
+  const std::uint64_t StartNs = wallNowNs();
+  const ProcessUsage StartUsage = currentProcessUsage();
+
+  SignatureStorage TargetStorage;
+  auto TargetSig = parseFunctionSignature(TargetStorage, Query);
+  if (!TargetSig) {
+    return std::nullopt;
+  }
+
+  const std::vector<std::string> ArgsVec = defaultClangArgs();
+  std::vector<const char *> ClangArgs;
+  for (const auto &S : ArgsVec) {
+    ClangArgs.push_back(S.c_str());
+  }
+
+  // Same settings as a plain text search; the bytes go to /dev/null
+  const int NullFd = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+  OutputWriter Writer(NullFd);
+  const WorkerSettings Settings{ResultMode::List, OutputFormat::Text,
+                                colors::palette(false), FlushThreshold,
+                                CollectStats};
+
+  OutputBuffer Header;
+  formatSearchHeader(Header, Settings.Colors, *TargetSig);
+  Writer.write(Header);
+
+  const std::uint64_t ParallelStartNs = wallNowNs();
+  const std::size_t Workers =
+      NumThreads == 0 ? defaultThreadCount() : NumThreads;
+  auto Task = [&](const std::vector<std::string> &Chunk) {
+    return processFiles(Chunk, *TargetSig, ClangArgs, Writer, Settings);
+  };
+  std::vector<TaskResult> AllResults =
+      Costs ? runPartitioned(partitionByCost(Files, *Costs, Workers), Task)
+            : runChunked(Files, Workers, Task);
+
+  SearchRun Run;
+  Run.ParallelWallNs = wallNowNs() - ParallelStartNs;
+  std::vector<OutputBuffer *> Pending;
+  for (auto &TaskRes : AllResults) {
+    Run.Matches += TaskRes.MatchCount;
+    Run.Functions += TaskRes.Stats.FunctionsVisited;
+    Run.Failures += TaskRes.Failures.size();
+    if (CollectStats) {
+      Run.Workers.push_back(TaskRes.Stats);
+    }
+    Pending.push_back(&TaskRes.Output);
+  }
+  OutputBuffer Trailer;
+  formatSummary(Trailer, Run.Matches);
+  Pending.push_back(&Trailer);
+  const std::uint64_t FlushStartNs = wallNowNs();
+  Writer.write(span<OutputBuffer *>(Pending.data(), Pending.size()));
+  Run.FlushNs = wallNowNs() - FlushStartNs;
+  if (NullFd >= 0) {
+    ::close(NullFd);
+  }
+
+  Run.WallNs = wallNowNs() - StartNs;
+  const ProcessUsage EndUsage = currentProcessUsage();
+  Run.CpuNs = EndUsage.UserCpuNs + EndUsage.SystemCpuNs -
+              StartUsage.UserCpuNs - StartUsage.SystemCpuNs;
+  return Run;
+}
+
+double workerIdleFraction(const SearchRun &Run, const WorkerStats &Worker) {
+  return Run.ParallelWallNs > Worker.BusyNs
+             ? static_cast<double>(Run.ParallelWallNs - Worker.BusyNs) /
+                   static_cast<double>(Run.ParallelWallNs)
+             : 0.0;
+}
+
+bool evictFromPageCache(const std::vector<std::string> &Files) {
+#if defined(POSIX_FADV_DONTNEED)
+  bool Ok = true;
+  for (const auto &File : Files) {
+    const int Fd = ::open(File.c_str(), O_RDONLY | O_CLOEXEC);
+    if (Fd < 0) {
+      Ok = false;
+      continue;
+    }
+    Ok = ::posix_fadvise(Fd, 0, 0, POSIX_FADV_DONTNEED) == 0 && Ok;
+    ::close(Fd);
+  }
+  return Ok;
+#else
+  (void)Files;
+  return false;
+#endif
+}
+
+std::optional<E2EReport> runE2E(const std::string &Corpus,
+                                const E2EConfig &Config) {
+  E2EReport Report;
+  Report.Corpus = Corpus;
+  Report.NumThreads =
+      Config.NumThreads == 0 ? defaultThreadCount() : Config.NumThreads;
+  Report.Repetitions = Config.Repetitions;
+
+  const std::vector<std::string> Files = findSourceFiles(Corpus);
+  if (Files.empty()) {
+    std::cerr << fmt::format("✖ Error: No C/C++ files found in: {}\n",
+                             Corpus);
+    return std::nullopt;
+  }
+  Report.Files = Files.size();
+  for (const auto &File : Files) {
+    std::error_code Ec;
+    const auto Size = fs::file_size(File, Ec);
+    Report.Bytes += Ec ? 0 : Size;
+  }
+
+  Report.ColdEvicted = Config.Cold;
+  for (const std::string &Query : Config.Queries) {
+    // Untimed pass: counts functions and validates the query
+    auto Probe = runSearchOnce(Files, Query, Report.NumThreads, true);
+    if (!Probe) {
+      std::cerr << fmt::format("✖ Error: Invalid query '{}'\n", Query);
+      return std::nullopt;
+    }
+    Report.Functions = Probe->Functions;
+
+    QueryTiming Timing;
+    Timing.Query = Query;
+    Timing.Matches = Probe->Matches;
+    for (std::size_t i = 0; Config.Cold && i < Config.Repetitions; ++i) {
+      Report.ColdEvicted = evictFromPageCache(Files) && Report.ColdEvicted;
+      Timing.ColdNs.push_back(
+          runSearchOnce(Files, Query, Report.NumThreads)->WallNs);
+    }
+    for (std::size_t i = 0; i < Config.Repetitions; ++i) {
+      Timing.WarmNs.push_back(
+          runSearchOnce(Files, Query, Report.NumThreads)->WallNs);
+    }
+    Report.Queries.push_back(std::move(Timing));
+  }
+
+  Report.PeakRssBytes = currentProcessUsage().PeakRssBytes;
+  return Report;
+}
+
+void formatE2EJson(OutputBuffer &Out, const E2EReport &Report) {
+  Out.append("{\"corpus\":");
+  appendJsonString(Out, Report.Corpus);
+  Out.append(",\"files\":");
+  Out.appendUnsigned(Report.Files);
+  Out.append(",\"functions\":");
+  Out.appendUnsigned(Report.Functions);
+  Out.append(",\"bytes\":");
+  Out.appendUnsigned(Report.Bytes);
+  Out.append(",\"threads\":");
+  Out.appendUnsigned(Report.NumThreads);
+  Out.append(",\"repetitions\":");
+  Out.appendUnsigned(Report.Repetitions);
+  Out.append(",\"cold_evicted\":");
+  Out.append(Report.ColdEvicted ? "true" : "false");
+  Out.append(",\"peak_rss_bytes\":");
+  Out.appendUnsigned(Report.PeakRssBytes);
+  Out.append(",\"queries\":[");
+  for (std::size_t i = 0; i < Report.Queries.size(); ++i) {
+    const QueryTiming &Q = Report.Queries[i];
+    Out.append(i == 0 ? "\n  " : ",\n  ");
+    Out.append("{\"query\":");
+    appendJsonString(Out, Q.Query);
+    Out.append(",\"matches\":");
+    Out.appendUnsigned(Q.Matches);
+    if (!Q.ColdNs.empty()) {
+      Out.append(",\"cold\":");
+      appendTimings(Out, Q.ColdNs, Report);
+    }
+    Out.append(",\"warm\":");
+    appendTimings(Out, Q.WarmNs, Report);
+    Out.append('}');
+  }
+  Out.append("\n]}\n");
+}
+
+std::vector<std::size_t> scalingThreadCounts(std::size_t MaxThreads) {
+  std::vector<std::size_t> Counts;
+  for (std::size_t N = 1; N < MaxThreads; N *= 2) {
+    Counts.push_back(N);
+  }
+  Counts.push_back(std::max<std::size_t>(1, MaxThreads));
+  return Counts;
+}
+
+std::optional<ScalingReport>
+runScaling(const std::string &Corpus, const std::string &Query,
+           const std::vector<std::size_t> &ThreadCounts,
+           std::size_t Repetitions) {
+  ScalingReport Report;
+  Report.Corpus = Corpus;
+  Report.Query = Query;
+  Report.Repetitions = Repetitions;
+
+  const std::vector<std::string> Files = findSourceFiles(Corpus);
+  if (Files.empty()) {
+    std::cerr << fmt::format("✖ Error: No C/C++ files found in: {}\n",
+                             Corpus);
+    return std::nullopt;
+  }
+  Report.Files = Files.size();
+
+  // Warm-up: fills the page cache and validates the query
+  if (!runSearchOnce(Files, Query, 1)) {
+    std::cerr << fmt::format("✖ Error: Invalid query '{}'\n", Query);
+    return std::nullopt;
+  }
+
+  for (std::size_t NumThreads : ThreadCounts) {
+    ScalingPoint Point;
+    Point.NumThreads = NumThreads;
+    double IdleSum = 0;
+    std::size_t IdleCount = 0;
+    std::uint64_t WallSumNs = 0;
+    std::uint64_t CpuSumNs = 0;
+    std::vector<std::uint64_t> OutputNs;
+    for (std::size_t i = 0; i < Repetitions; ++i) {
+      SearchRun Run = *runSearchOnce(Files, Query, NumThreads, true);
+      Point.WallNs.push_back(Run.WallNs);
+      WallSumNs += Run.WallNs;
+      CpuSumNs += Run.CpuNs;
+
+      std::uint64_t RunOutputNs = Run.FlushNs;
+      for (const WorkerStats &Worker : Run.Workers) {
+        const double Idle = workerIdleFraction(Run, Worker);
+        IdleSum += Idle;
+        IdleCount++;
+        Point.MaxIdle = std::max(Point.MaxIdle, Idle);
+        RunOutputNs += Worker[Phase::Output].WallNs;
+      }
+      OutputNs.push_back(RunOutputNs);
+    }
+    Point.MeanIdle = IdleCount ? IdleSum / static_cast<double>(IdleCount) : 0;
+    Point.CpuUtilization =
+        WallSumNs ? static_cast<double>(CpuSumNs) /
+                        (static_cast<double>(WallSumNs) *
+                         static_cast<double>(NumThreads))
+                  : 0;
+    Point.OutputNs = summarize(OutputNs).MedianNs;
+    Report.Points.push_back(std::move(Point));
+  }
+
+  // Speedup relative to the first (smallest) worker count
+  const double BaseNs =
+      Report.Points.empty()
+          ? 0
+          : static_cast<double>(summarize(Report.Points[0].WallNs).MedianNs);
+  for (ScalingPoint &Point : Report.Points) {
+    const double MedianNs =
+        static_cast<double>(summarize(Point.WallNs).MedianNs);
+    Point.Speedup = MedianNs > 0 ? BaseNs / MedianNs : 0;
+    Point.Efficiency = Point.Speedup / static_cast<double>(Point.NumThreads) *
+                       static_cast<double>(Report.Points[0].NumThreads);
+  }
+  return Report;
+}
+
+void formatScalingJson(OutputBuffer &Out, const ScalingReport &Report) {
+  Out.append("{\"corpus\":");
+  appendJsonString(Out, Report.Corpus);
+  Out.append(",\"query\":");
+  appendJsonString(Out, Report.Query);
+  Out.append(",\"files\":");
+  Out.appendUnsigned(Report.Files);
+  Out.append(",\"repetitions\":");
+  Out.appendUnsigned(Report.Repetitions);
+  Out.append(",\"points\":[");
+  for (std::size_t i = 0; i < Report.Points.size(); ++i) {
+    const ScalingPoint &P = Report.Points[i];
+    const Percentiles Wall = summarize(P.WallNs);
+    Out.append(i == 0 ? "\n  " : ",\n  ");
+    Out.append("{\"threads\":");
+    Out.appendUnsigned(P.NumThreads);
+    Out.append(fmt::format(",\"median_ms\":{:.3f}", Wall.MedianNs / 1e6));
+    Out.append(fmt::format(",\"p90_ms\":{:.3f}", Wall.P90Ns / 1e6));
+    Out.append(fmt::format(",\"speedup\":{:.3f}", P.Speedup));
+    Out.append(fmt::format(",\"efficiency\":{:.3f}", P.Efficiency));
+    Out.append(fmt::format(",\"mean_idle\":{:.3f}", P.MeanIdle));
+    Out.append(fmt::format(",\"max_idle\":{:.3f}", P.MaxIdle));
+    Out.append(fmt::format(",\"cpu_utilization\":{:.3f}", P.CpuUtilization));
+    Out.append(fmt::format(",\"output_ms\":{:.3f}}}", P.OutputNs / 1e6));
+  }
+  Out.append("\n]}\n");
+}
+
+void formatScalingTable(OutputBuffer &Out, const ScalingReport &Report) {
+  Out.append(fmt::format("Thread scaling: {} files, query '{}', median of "
+                         "{} runs\n\n",
+                         Report.Files, Report.Query, Report.Repetitions));
+  Out.append(fmt::format("{:>8} {:>12} {:>8} {:>10} {:>10} {:>10} {:>10}\n",
+                         "threads", "median ms", "speedup", "efficiency",
+                         "mean idle", "max idle", "cpu util"));
+  for (const ScalingPoint &P : Report.Points) {
+    Out.append(fmt::format(
+        "{:>8} {:>12.2f} {:>7.2f}x {:>9.0f}% {:>9.0f}% {:>9.0f}% {:>9.0f}%\n",
+        P.NumThreads, summarize(P.WallNs).MedianNs / 1e6, P.Speedup,
+        P.Efficiency * 100, P.MeanIdle * 100, P.MaxIdle * 100,
+        P.CpuUtilization * 100));
+  }
+}
+
+} // namespace coogle::bench
@@ -0,0 +1,151 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// In-process end-to-end benchmark of the search pipeline.
+//
+// Each query runs the same discovery-free path as `coogle DIR QUERY`
+// (parse the query, fan the files out to workers, format every match and
+// write it to /dev/null) several times. Cold runs first evict the corpus
+// from the page cache with posix_fadvise(POSIX_FADV_DONTNEED); warm runs
+// follow without eviction.
+
+#pragma once
+
+#include "coogle/output.h"
+#include "coogle/profile.h"
+#include "coogle/stats.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle::bench {
+
+// Order statistics of a set of wall times (nearest-rank percentiles).
+struct Percentiles {
+  std::uint64_t MinNs = 0;
+  std::uint64_t MedianNs = 0;
+  std::uint64_t P90Ns = 0;
+  std::uint64_t P99Ns = 0;
+  std::uint64_t MaxNs = 0;
+  double StddevNs = 0; // Sample standard deviation
+};
+
+// Summarizes Samples (which need not be sorted). All zero when empty.
+Percentiles summarize(std::vector<std::uint64_t> Samples);
+
+// Outcome of a single search over the corpus.
+struct SearchRun {
+  std::uint64_t WallNs = 0;
+  std::uint64_t ParallelWallNs = 0; // From worker launch to the last join
+  std::size_t Matches = 0;
+  std::size_t Functions = 0; // Only counted with CollectStats
+  std::size_t Failures = 0;  // Files libclang could not parse
+  std::uint64_t FlushNs = 0; // Final write of the worker buffers
+  std::uint64_t CpuNs = 0;   // Process user + system time
+  std::vector<WorkerStats> Workers; // Only filled with CollectStats
+};
+
+// Runs Query over Files with NumThreads workers. Output is formatted as
+// for a plain text search and discarded. CollectStats turns on the
+// per-worker statistics (function counts, phase times, busy time), which
+// adds timer overhead to every function. A FlushThreshold of zero writes
+// after every file, as `coogle --stream` does. With Costs the files are
+// split by partitionByCost(), as `coogle --load-profile` does, instead of
+// into contiguous chunks. Returns nullopt when the query does not parse.
+std::optional<SearchRun>
+runSearchOnce(const std::vector<std::string> &Files, std::string_view Query,
+              std::size_t NumThreads, bool CollectStats = false,
+              std::size_t FlushThreshold = OutputFlushThreshold,
+              const CostMap *Costs = nullptr);
+
+// Fraction of Run's parallel section that Worker spent idle after
+// finishing its chunk (0 = busy until the last worker joined).
+double workerIdleFraction(const SearchRun &Run, const WorkerStats &Worker);
+
+// Drops the cached pages of Files. Returns false if any file could not be
+// evicted (or the platform has no posix_fadvise).
+bool evictFromPageCache(const std::vector<std::string> &Files);
+
+// What to measure.
+struct E2EConfig {
+  std::vector<std::string> Queries;
+  std::size_t Repetitions = 5; // Timed runs per query and cache state
+  std::size_t NumThreads = 0;  // 0 = defaultThreadCount()
+  bool Cold = true;            // Also time cold-cache runs
+};
+
+struct QueryTiming {
+  std::string Query;
+  std::size_t Matches = 0;
+  std::vector<std::uint64_t> ColdNs; // Empty when cold runs are disabled
+  std::vector<std::uint64_t> WarmNs;
+};
+
+struct E2EReport {
+  std::string Corpus;
+  std::size_t Files = 0;
+  std::size_t Functions = 0;
+  std::uint64_t Bytes = 0;
+  std::size_t NumThreads = 0;
+  std::size_t Repetitions = 0;
+  bool ColdEvicted = false; // Page-cache eviction worked for cold runs
+  std::uint64_t PeakRssBytes = 0;
+  std::vector<QueryTiming> Queries;
+};
+
+// Benchmarks every query of Config over the source files under Corpus.
+// Prints an error and returns nullopt if the corpus is empty or a query
+// does not parse.
+std::optional<E2EReport> runE2E(const std::string &Corpus,
+                                const E2EConfig &Config);
+
+// Appends Report as JSON: per query and cache state the min, median, p90,
+// p99, max and standard deviation of the wall time in milliseconds plus
+// files/sec and functions/sec at the median.
+void formatE2EJson(OutputBuffer &Out, const E2EReport &Report);
+
+// One worker count of a thread-scaling sweep. Runs collect per-worker
+// statistics, so every point pays the same instrumentation overhead.
+struct ScalingPoint {
+  std::size_t NumThreads = 0;
+  std::vector<std::uint64_t> WallNs;
+  double Speedup = 0;    // Median wall time at the first point / here
+  double Efficiency = 0; // Speedup per worker (1 = perfect scaling)
+  double MeanIdle = 0;   // Mean fraction of the parallel section a worker
+                         // spent idle (finished early)
+  double MaxIdle = 0;    // Largest such fraction
+  // Process CPU time / (wall time * workers). Well below 1 - MeanIdle
+  // means busy workers were blocked (locks, I/O) or descheduled.
+  double CpuUtilization = 0;
+  std::uint64_t OutputNs = 0; // Median time spent writing results
+};
+
+struct ScalingReport {
+  std::string Corpus;
+  std::string Query;
+  std::size_t Files = 0;
+  std::size_t Repetitions = 0;
+  std::vector<ScalingPoint> Points;
+};
+
+// Worker counts 1, 2, 4, ... up to and including MaxThreads.
+std::vector<std::size_t> scalingThreadCounts(std::size_t MaxThreads);
+
+// Times Query over Corpus (warm cache) at every worker count. Prints an
+// error and returns nullopt if the corpus is empty or the query does not
+// parse.
+std::optional<ScalingReport>
+runScaling(const std::string &Corpus, const std::string &Query,
+           const std::vector<std::size_t> &ThreadCounts,
+           std::size_t Repetitions);
+
+// Appends Report as JSON, one object per worker count.
+void formatScalingJson(OutputBuffer &Out, const ScalingReport &Report);
+
+// Appends Report as a human-readable table.
+void formatScalingTable(OutputBuffer &Out, const ScalingReport &Report);
+
+} // namespace coogle::bench
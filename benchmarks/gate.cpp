@@ -0,0 +1,480 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Benchmark regression gate.
+
+#include "gate.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace coogle::bench {
+
+namespace {
+// Just enough JSON for benchmark reports: no duplicate-key or depth
+// checks, numbers as double.
+struct JsonValue {
+  enum class Kind { Null, Bool, Number, String, Array, Object };
+
+  Kind K = Kind::Null;
+  bool Bool = false;
+  double Number = 0;
+  std::string String;
+  std::vector<JsonValue> Items;
+  std::vector<std::pair<std::string, JsonValue>> Members;
+
+  // Member Key of an object, or null.
+  const JsonValue *get(std::string_view Key) const {
+    for (const auto &[Name, Value] : Members) {
+      if (Name == Key) {
+        return &Value;
+      }
+    }
+    return nullptr;
+  }
+
+  std::optional<double> number(std::string_view Key) const {
+    const JsonValue *V = get(Key);
+    return V && V->K == Kind::Number ? std::optional<double>(V->Number)
+                                     : std::nullopt;
+  }
+
+  std::string_view string(std::string_view Key) const {
+    const JsonValue *V = get(Key);
+    return V && V->K == Kind::String ? std::string_view(V->String)
+                                     : std::string_view();
+  }
+};
+
+class JsonParser {
+  std::string_view Text_;
+  std::size_t Pos_ = 0;
+
+  void skipSpace() {
+    while (Pos_ < Text_.size() &&
+           (Text_[Pos_] == ' ' || Text_[Pos_] == '\n' || Text_[Pos_] == '\t' ||
+            Text_[Pos_] == '\r')) {
+      Pos_++;
+    }
+  }
+
+  bool consume(char C) {
+    skipSpace();
+    if (Pos_ < Text_.size() && Text_[Pos_] == C) {
+      Pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  bool consumeWord(std::string_view Word) {
+    if (Text_.substr(Pos_, Word.size()) != Word) {
+      return false;
+    }
+    Pos_ += Word.size();
+    return true;
+  }
+
+  static void appendUtf8(std::string &Out, unsigned Code) {
+    if (Code < 0x80) {
+      Out += static_cast<char>(Code);
+    } else if (Code < 0x800) {
+      Out += static_cast<char>(0xC0 | (Code >> 6));
+      Out += static_cast<char>(0x80 | (Code & 0x3F));
+    } else {
+      Out += static_cast<char>(0xE0 | (Code >> 12));
+      Out += static_cast<char>(0x80 | ((Code >> 6) & 0x3F));
+      Out += static_cast<char>(0x80 | (Code & 0x3F));
+    }
+  }
+
+  bool parseString(std::string &Out) {
+    if (!consume('"')) {
+      return false;
+    }
+    while (Pos_ < Text_.size()) {
+      const char C = Text_[Pos_++];
+      if (C == '"') {
+        return true;
+      }
+      if (C != '\\') {
+        Out += C;
+        continue;
+      }
+      if (Pos_ >= Text_.size()) {
+        return false;
+      }
+      const char E = Text_[Pos_++];
+      switch (E) {
+      case 'n':
+        Out += '\n';
+        break;
+      case 't':
+        Out += '\t';
+        break;
+      case 'r':
+        Out += '\r';
+        break;
+      case 'b':
+        Out += '\b';
+        break;
+      case 'f':
+        Out += '\f';
+        break;
+      case 'u': {
+        if (Pos_ + 4 > Text_.size()) {
+          return false;
+        }
+        const std::string Hex(Text_.substr(Pos_, 4));
+        char *End = nullptr;
+        const unsigned long Code = std::strtoul(Hex.c_str(), &End, 16);
+        if (*End != '\0') {
+          return false;
+        }
+        appendUtf8(Out, static_cast<unsigned>(Code));
+        Pos_ += 4;
+        break;
+      }
+      default: // '"', '\\' and '/'
+        Out += E;
+        break;
+      }
+    }
+    return false;
+  }
+
+  bool parseValue(JsonValue &V) {
+    skipSpace();
+    if (Pos_ >= Text_.size()) {
+      return false;
+    }
+    const char C = Text_[Pos_];
+    if (C == '{') {
+      V.K = JsonValue::Kind::Object;
+      Pos_++;
+      if (consume('}')) {
+        return true;
+      }
+      do {
+        std::string Key;
+        JsonValue Member;
+        if (!parseString(Key) || !consume(':') || !parseValue(Member)) {
+          return false;
+        }
+        V.Members.emplace_back(std::move(Key), std::move(Member));
+      } while (consume(','));
+      return consume('}');
+    }
+    if (C == '[') {
+      V.K = JsonValue::Kind::Array;
+      Pos_++;
+      if (consume(']')) {
+        return true;
+      }
+      do {
+        V.Items.emplace_back();
+        if (!parseValue(V.Items.back())) {
+          return false;
+        }
+      } while (consume(','));
+      return consume(']');
+    }
+    if (C == '"') {
+      V.K = JsonValue::Kind::String;
+      return parseString(V.String);
+    }
+    if (consumeWord("true") || consumeWord("false")) {
+      V.K = JsonValue::Kind::Bool;
+      V.Bool = C == 't';
+      return true;
+    }
+    if (consumeWord("null")) {
+      return true;
+    }
+    const std::string Rest(Text_.substr(Pos_, 64));
+    char *End = nullptr;
+    V.Number = std::strtod(Rest.c_str(), &End);
+    if (End == Rest.c_str()) {
+      return false;
+    }
+    V.K = JsonValue::Kind::Number;
+    Pos_ += static_cast<std::size_t>(End - Rest.c_str());
+    return true;
+  }
+
+public:
+  explicit JsonParser(std::string_view Text) : Text_(Text) {}
+
+  std::optional<JsonValue> parse() {
+    JsonValue V;
+    if (!parseValue(V)) {
+      return std::nullopt;
+    }
+    skipSpace();
+    if (Pos_ != Text_.size()) {
+      return std::nullopt;
+    }
+    return V;
+  }
+};
+
+double nsPerUnit(std::string_view Unit) {
+  return Unit == "us" ? 1e3 : Unit == "ms" ? 1e6 : Unit == "s" ? 1e9 : 1.0;
+}
+
+double median(std::vector<double> Values) {
+  std::sort(Values.begin(), Values.end());
+  const std::size_t N = Values.size();
+  return N % 2 ? Values[N / 2] : (Values[N / 2 - 1] + Values[N / 2]) / 2;
+}
+
+// Google Benchmark report: prefers the median/stddev aggregates and falls
+// back to the median of the individual iterations.
+std::vector<BenchResult> microResults(const JsonValue &Benchmarks) {
+  struct Runs {
+    std::optional<double> Median;
+    std::optional<double> Stddev;
+    std::vector<double> Iterations;
+  };
+  std::map<std::string, Runs> ByName;
+  for (const JsonValue &B : Benchmarks.Items) {
+    const std::string_view RunName = B.string("run_name");
+    const std::optional<double> Cpu = B.number("cpu_time");
+    if (RunName.empty() || !Cpu || B.get("error_occurred")) {
+      continue;
+    }
+    const double Ns = *Cpu * nsPerUnit(B.string("time_unit"));
+    Runs &R = ByName[std::string(RunName)];
+    const std::string_view Aggregate = B.string("aggregate_name");
+    if (B.string("run_type") != "aggregate") {
+      R.Iterations.push_back(Ns);
+    } else if (Aggregate == "median") {
+      R.Median = Ns;
+    } else if (Aggregate == "stddev") {
+      R.Stddev = Ns;
+    }
+  }
+
+  std::vector<BenchResult> Results;
+  for (const auto &[Name, R] : ByName) {
+    if (!R.Median && R.Iterations.empty()) {
+      continue;
+    }
+    Results.push_back({Name, R.Median ? *R.Median : median(R.Iterations),
+                       R.Stddev.value_or(0)});
+  }
+  return Results;
+}
+
+// coogle_e2e_bench report: the warm runs of every query.
+std::vector<BenchResult> e2eResults(const JsonValue &Queries) {
+  std::vector<BenchResult> Results;
+  for (const JsonValue &Q : Queries.Items) {
+    const JsonValue *Warm = Q.get("warm");
+    const std::optional<double> Median =
+        Warm ? Warm->number("median_ms") : std::nullopt;
+    if (!Median) {
+      continue;
+    }
+    Results.push_back({fmt::format("e2e/{}", Q.string("query")),
+                       *Median * 1e6,
+                       Warm->number("stddev_ms").value_or(0) * 1e6});
+  }
+  return Results;
+}
+
+// Duration with a unit that keeps three significant digits readable.
+std::string formatNs(double Ns) {
+  if (Ns < 1e3) {
+    return fmt::format("{:.1f} ns", Ns);
+  }
+  if (Ns < 1e6) {
+    return fmt::format("{:.1f} us", Ns / 1e3);
+  }
+  if (Ns < 1e9) {
+    return fmt::format("{:.1f} ms", Ns / 1e6);
+  }
+  return fmt::format("{:.2f} s", Ns / 1e9);
+}
+
+const char *statusName(GateStatus Status) {
+  switch (Status) {
+  case GateStatus::Ok:
+    return "ok";
+  case GateStatus::Regressed:
+    return "REGRESSED";
+  case GateStatus::Improved:
+    return "improved";
+  case GateStatus::Missing:
+    return "MISSING";
+  case GateStatus::New:
+    return "new";
+  }
+  return "unknown";
+}
+} // anonymous namespace
+
+std::optional<std::vector<BenchResult>>
+parseBenchResults(std::string_view Json) {
+  auto Root = JsonParser(Json).parse();
+  if (Root) {
+    if (const JsonValue *B = Root->get("benchmarks");
+        B && B->K == JsonValue::Kind::Array && Root->get("context")) {
+      return microResults(*B);
+    }
+    if (const JsonValue *Q = Root->get("queries");
+        Q && Q->K == JsonValue::Kind::Array) {
+      return e2eResults(*Q);
+    }
+  }
+  std::cerr << "✖ Error: Not a Google Benchmark or coogle_e2e_bench JSON "
+               "report\n";
+  return std::nullopt;
+}
+
+std::optional<Baseline> parseBaseline(std::string_view Json) {
+  auto Root = JsonParser(Json).parse();
+  const JsonValue *Benchmarks = Root ? Root->get("benchmarks") : nullptr;
+  if (!Benchmarks || Benchmarks->K != JsonValue::Kind::Array) {
+    std::cerr << "✖ Error: Malformed baseline (expected "
+                 "{\"benchmarks\":[...]})\n";
+    return std::nullopt;
+  }
+
+  Baseline Base;
+  for (const JsonValue &B : Benchmarks->Items) {
+    const std::optional<double> Median = B.number("median_ns");
+    if (B.string("name").empty() || !Median) {
+      std::cerr << "✖ Error: Baseline entry without name or median_ns\n";
+      return std::nullopt;
+    }
+    BaselineEntry Entry;
+    Entry.Result = {std::string(B.string("name")), *Median,
+                    B.number("stddev_ns").value_or(0)};
+    Entry.Tolerance = B.number("tolerance").value_or(DefaultTolerance);
+    Base.Entries.push_back(std::move(Entry));
+  }
+  return Base;
+}
+
+void formatBaseline(OutputBuffer &Out, const Baseline &Base) {
+  Out.append("{\"benchmarks\":[");
+  for (std::size_t i = 0; i < Base.Entries.size(); ++i) {
+    const BaselineEntry &E = Base.Entries[i];
+    Out.append(i == 0 ? "\n  " : ",\n  ");
+    Out.append("{\"name\":");
+    appendJsonString(Out, E.Result.Name);
+    Out.append(fmt::format(
+        ",\"median_ns\":{:.2f},\"stddev_ns\":{:.2f},\"tolerance\":{}}}",
+        E.Result.MedianNs, E.Result.StddevNs, E.Tolerance));
+  }
+  Out.append("\n]}\n");
+}
+
+Baseline makeBaseline(const std::vector<BenchResult> &Results,
+                      const Baseline &Previous) {
+  std::unordered_map<std::string, double> Tolerances;
+  for (const BaselineEntry &E : Previous.Entries) {
+    Tolerances[E.Result.Name] = E.Tolerance;
+  }
+  Baseline Base;
+  for (const BenchResult &R : Results) {
+    auto It = Tolerances.find(R.Name);
+    Base.Entries.push_back(
+        {R, It == Tolerances.end() ? DefaultTolerance : It->second});
+  }
+  return Base;
+}
+
+std::vector<GateComparison>
+compareToBaseline(const Baseline &Base, const std::vector<BenchResult> &Results,
+                  double NoiseSigmas) {
+  std::unordered_map<std::string_view, const BenchResult *> ByName;
+  for (const BenchResult &R : Results) {
+    ByName[R.Name] = &R;
+  }
+
+  std::vector<GateComparison> Comparisons;
+  for (const BaselineEntry &E : Base.Entries) {
+    GateComparison C;
+    C.Name = E.Result.Name;
+    C.BaselineNs = E.Result.MedianNs;
+    auto It = ByName.find(E.Result.Name);
+    if (It == ByName.end()) {
+      C.Status = GateStatus::Missing;
+      Comparisons.push_back(std::move(C));
+      continue;
+    }
+    const BenchResult &Cur = *It->second;
+    ByName.erase(It);
+    C.CurrentNs = Cur.MedianNs;
+    C.LimitNs = E.Result.MedianNs * (1 + E.Tolerance) +
+                NoiseSigmas * std::max(E.Result.StddevNs, Cur.StddevNs);
+    if (C.CurrentNs > C.LimitNs) {
+      C.Status = GateStatus::Regressed;
+    } else if (C.CurrentNs < E.Result.MedianNs * (1 - E.Tolerance)) {
+      C.Status = GateStatus::Improved;
+    }
+    Comparisons.push_back(std::move(C));
+  }
+
+  // Results without a baseline, in report order
+  for (const BenchResult &R : Results) {
+    if (ByName.count(R.Name)) {
+      Comparisons.push_back({R.Name, 0, R.MedianNs, 0, GateStatus::New});
+    }
+  }
+  return Comparisons;
+}
+
+bool gateFailed(const std::vector<GateComparison> &Comparisons) {
+  return std::any_of(Comparisons.begin(), Comparisons.end(), [](const auto &C) {
+    return C.Status == GateStatus::Regressed ||
+           C.Status == GateStatus::Missing;
+  });
+}
+
+void formatComparison(OutputBuffer &Out,
+                      const std::vector<GateComparison> &Comparisons) {
+  std::size_t NameWidth = 9;
+  for (const GateComparison &C : Comparisons) {
+    NameWidth = std::max(NameWidth, C.Name.size());
+  }
+
+  Out.append(fmt::format("{:<{}}  {:>10}  {:>10}  {:>8}  {:>10}  {}\n",
+                         "benchmark", NameWidth, "baseline", "current",
+                         "change", "limit", "status"));
+  std::size_t Failed = 0;
+  for (const GateComparison &C : Comparisons) {
+    const bool Measured = C.Status != GateStatus::Missing;
+    const bool HasBaseline = C.Status != GateStatus::New;
+    const std::string Change =
+        Measured && HasBaseline && C.BaselineNs > 0
+            ? fmt::format("{:+.1f}%",
+                          (C.CurrentNs / C.BaselineNs - 1) * 100)
+            : "-";
+    Out.append(fmt::format(
+        "{:<{}}  {:>10}  {:>10}  {:>8}  {:>10}  {}\n", C.Name, NameWidth,
+        HasBaseline ? formatNs(C.BaselineNs) : "-",
+        Measured ? formatNs(C.CurrentNs) : "-", Change,
+        HasBaseline && Measured ? formatNs(C.LimitNs) : "-",
+        statusName(C.Status)));
+    Failed += C.Status == GateStatus::Regressed ||
+              C.Status == GateStatus::Missing;
+  }
+
+  if (Failed) {
+    Out.append(fmt::format(
+        "\n✖ {} of {} benchmarks regressed or are missing from the results\n",
+        Failed, Comparisons.size()));
+  } else {
+    Out.append(fmt::format("\n✔ {} benchmarks within tolerance\n",
+                           Comparisons.size()));
+  }
+}
+
+} // namespace coogle::bench
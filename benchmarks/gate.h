@@ -0,0 +1,93 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Benchmark regression gate: compares fresh results with a checked-in
+// baseline (benchmarks/baseline.json).
+//
+// Results come from the Google Benchmark JSON of coogle_bench (run with
+// repetitions, so median and stddev aggregates are present) and from the
+// coogle_e2e_bench report (warm runs, named "e2e/<query>"). A benchmark
+// regresses when its median exceeds
+//
+//   baseline median * (1 + tolerance) + NoiseSigmas * max(stddevs)
+//
+// so noisy kernels get proportionally more headroom than stable ones.
+
+#pragma once
+
+#include "coogle/output.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle::bench {
+
+// Default relative headroom for benchmarks without their own tolerance.
+constexpr double DefaultTolerance = 0.25;
+
+// Standard deviations of extra headroom granted on top of the tolerance.
+constexpr double DefaultNoiseSigmas = 3.0;
+
+// One measured benchmark.
+struct BenchResult {
+  std::string Name;
+  double MedianNs = 0;
+  double StddevNs = 0;
+};
+
+// Reads results from a Google Benchmark or coogle_e2e_bench JSON report.
+// Returns nullopt (after printing an error) if the text is not either.
+std::optional<std::vector<BenchResult>>
+parseBenchResults(std::string_view Json);
+
+struct BaselineEntry {
+  BenchResult Result;
+  double Tolerance = DefaultTolerance;
+};
+
+struct Baseline {
+  std::vector<BaselineEntry> Entries;
+};
+
+// Parses benchmarks/baseline.json. Prints an error and returns nullopt on
+// malformed input.
+std::optional<Baseline> parseBaseline(std::string_view Json);
+
+// Appends Baseline as JSON, one benchmark per line.
+void formatBaseline(OutputBuffer &Out, const Baseline &Base);
+
+// Builds a baseline from Results, keeping the tolerances of Previous.
+Baseline makeBaseline(const std::vector<BenchResult> &Results,
+                      const Baseline &Previous);
+
+enum class GateStatus {
+  Ok,
+  Regressed, // Slower than the limit
+  Improved,  // Faster by more than the tolerance; consider --update
+  Missing,   // In the baseline but not measured
+  New,       // Measured but not in the baseline
+};
+
+struct GateComparison {
+  std::string Name;
+  double BaselineNs = 0;
+  double CurrentNs = 0;
+  double LimitNs = 0;
+  GateStatus Status = GateStatus::Ok;
+};
+
+// Compares every baseline entry (and every unknown result) with Results.
+std::vector<GateComparison>
+compareToBaseline(const Baseline &Base, const std::vector<BenchResult> &Results,
+                  double NoiseSigmas = DefaultNoiseSigmas);
+
+// True if any comparison is Regressed or Missing.
+bool gateFailed(const std::vector<GateComparison> &Comparisons);
+
+// Appends a table of baseline, current, change, limit and status.
+void formatComparison(OutputBuffer &Out,
+                      const std::vector<GateComparison> &Comparisons);
+
+} // namespace coogle::bench
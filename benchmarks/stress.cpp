@@ -0,0 +1,138 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Large-scale stress run: growing prefixes of a corpus and their limits.
+
+#include "stress.h"
+#include "e2e.h"
+
+#include "coogle/search.h"
+#include "coogle/stats.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fmt/core.h>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace coogle::bench {
+
+std::vector<std::size_t> stressStepSizes(std::size_t NumFiles,
+                                         std::size_t Steps) {
+  std::vector<std::size_t> Sizes;
+  std::size_t Size = NumFiles;
+  for (std::size_t i = 0; i < Steps && Size > 0; ++i) {
+    Sizes.push_back(Size);
+    Size /= 2;
+  }
+  std::reverse(Sizes.begin(), Sizes.end());
+  return Sizes;
+}
+
+std::optional<StressReport> runStress(const std::vector<std::string> &Files,
+                                      const StressConfig &Config) {
+  if (Files.empty()) {
+    std::cerr << "✖ Error: No C/C++ files to stress\n";
+    return std::nullopt;
+  }
+
+  StressReport Report;
+  Report.Query = Config.Query;
+  const std::size_t NumThreads =
+      Config.NumThreads == 0 ? defaultThreadCount() : Config.NumThreads;
+
+  // Generated file sizes are log-normal, so contiguous chunks leave workers
+  // idle for load-balance reasons alone; balance them by size instead
+  CostMap Costs;
+  for (const std::string &File : Files) {
+    std::error_code Ec;
+    Costs[File] = fs::file_size(File, Ec);
+  }
+  for (std::size_t Size : stressStepSizes(Files.size(), Config.Steps)) {
+    const std::vector<std::string> Prefix(Files.begin(),
+                                          Files.begin() + Size);
+    auto Run = runSearchOnce(Prefix, Config.Query, NumThreads,
+                             /*CollectStats=*/true, /*FlushThreshold=*/0,
+                             &Costs);
+    if (!Run) {
+      std::cerr << fmt::format("✖ Error: Invalid query '{}'\n", Config.Query);
+      return std::nullopt;
+    }
+
+    StressStep Step;
+    Step.Files = Size;
+    Step.Functions = Run->Functions;
+    Step.Matches = Run->Matches;
+    Step.Failures = Run->Failures;
+    Step.Workers = Run->Workers.size();
+    Step.WallNs = Run->WallNs;
+    Step.PeakRssBytes = currentProcessUsage().PeakRssBytes;
+    for (const WorkerStats &Worker : Run->Workers) {
+      Step.MaxIdle = std::max(Step.MaxIdle, workerIdleFraction(*Run, Worker));
+    }
+    Report.Steps.push_back(Step);
+  }
+  return Report;
+}
+
+std::vector<std::string>
+checkStress(const StressReport &Report, const StressConfig &Config,
+            std::optional<std::size_t> ExpectedMatches) {
+  std::vector<std::string> Violations;
+  if (Report.Steps.empty()) {
+    Violations.push_back("no steps ran");
+    return Violations;
+  }
+
+  const StressStep &First = Report.Steps.front();
+  const StressStep &Last = Report.Steps.back();
+  for (const StressStep &Step : Report.Steps) {
+    if (Step.Failures != 0) {
+      Violations.push_back(fmt::format("{} of {} files failed to parse",
+                                       Step.Failures, Step.Files));
+    }
+    const double Slowdown =
+        First.nsPerFile() > 0 ? Step.nsPerFile() / First.nsPerFile() : 1;
+    if (Slowdown > Config.MaxSlowdown) {
+      Violations.push_back(fmt::format(
+          "{} files cost {:.2f}x more per file than {} files (limit {:.2f}x)",
+          Step.Files, Slowdown, First.Files, Config.MaxSlowdown));
+    }
+    if (Step.Workers > 1 && Step.MaxIdle > Config.MaxIdle) {
+      Violations.push_back(fmt::format(
+          "a worker idled {:.0f}% of the {}-file run (limit {:.0f}%)",
+          Step.MaxIdle * 100, Step.Files, Config.MaxIdle * 100));
+    }
+  }
+
+  const std::uint64_t Growth = Last.PeakRssBytes > First.PeakRssBytes
+                                   ? Last.PeakRssBytes - First.PeakRssBytes
+                                   : 0;
+  if (Growth > Config.MaxRssGrowthBytes) {
+    Violations.push_back(fmt::format(
+        "peak RSS grew by {} MiB from {} to {} files (limit {} MiB)",
+        Growth >> 20, First.Files, Last.Files,
+        Config.MaxRssGrowthBytes >> 20));
+  }
+  if (ExpectedMatches && Last.Matches != *ExpectedMatches) {
+    Violations.push_back(
+        fmt::format("'{}' matched {} functions, the corpus expects {}",
+                    Report.Query, Last.Matches, *ExpectedMatches));
+  }
+  return Violations;
+}
+
+void formatStressTable(OutputBuffer &Out, const StressReport &Report) {
+  Out.append(fmt::format("Stress: '{}'\n", Report.Query));
+  Out.append(fmt::format("{:>8} {:>10} {:>8} {:>10} {:>10} {:>10} {:>9}\n",
+                         "files", "functions", "matches", "wall ms",
+                         "us/file", "peak MiB", "max idle"));
+  for (const StressStep &Step : Report.Steps) {
+    Out.append(fmt::format(
+        "{:>8} {:>10} {:>8} {:>10.1f} {:>10.1f} {:>10} {:>8.0f}%\n",
+        Step.Files, Step.Functions, Step.Matches, Step.WallNs / 1e6,
+        Step.nsPerFile() / 1e3, Step.PeakRssBytes >> 20, Step.MaxIdle * 100));
+  }
+}
+
+} // namespace coogle::bench
@@ -0,0 +1,84 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Large-scale stress run of the search pipeline.
+//
+// The corpus file list is searched in growing prefixes (N/8, N/4, N/2, N
+// files by default), every step in streaming mode with per-worker
+// statistics and the files balanced across workers by size. The steps
+// are then checked for pathologies that only show up at scale: per-file
+// cost growing with the file count, resident memory growing with it
+// despite streaming, parse failures, dropped matches and workers idling
+// while others still have files.
+
+#pragma once
+
+#include "coogle/output.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace coogle::bench {
+
+// Workload and limits.
+struct StressConfig {
+  std::string Query = "void(*)";
+  std::size_t NumThreads = 0; // 0 = defaultThreadCount()
+  std::size_t Steps = 4;      // Prefix sizes N / 2^(Steps-1), ..., N
+
+  // Largest allowed ratio of per-file wall time between any step and the
+  // smallest one.
+  double MaxSlowdown = 1.5;
+  // Largest allowed peak RSS growth from the smallest step to the last.
+  std::uint64_t MaxRssGrowthBytes = 256ull << 20;
+  // Largest allowed idle fraction of any worker (only checked with more
+  // than one worker). Steps split the files by size with
+  // partitionByCost(), so idling past this means a stalled worker, not an
+  // unlucky chunk.
+  double MaxIdle = 0.25;
+};
+
+// One prefix of the file list.
+struct StressStep {
+  std::size_t Files = 0;
+  std::size_t Functions = 0;
+  std::size_t Matches = 0;
+  std::size_t Failures = 0;
+  std::size_t Workers = 0;
+  std::uint64_t WallNs = 0;
+  std::uint64_t PeakRssBytes = 0; // Process peak after the step
+  double MaxIdle = 0;
+
+  double nsPerFile() const {
+    return Files ? static_cast<double>(WallNs) / static_cast<double>(Files)
+                 : 0;
+  }
+};
+
+struct StressReport {
+  std::string Query;
+  std::vector<StressStep> Steps;
+};
+
+// Prefix sizes for NumFiles files: NumFiles halved Steps-1 times, then
+// doubled back, smallest first. Sizes below one file are dropped.
+std::vector<std::size_t> stressStepSizes(std::size_t NumFiles,
+                                         std::size_t Steps);
+
+// Runs every step over the leading files of Files. Prints an error and
+// returns nullopt if Files is empty or the query does not parse.
+std::optional<StressReport> runStress(const std::vector<std::string> &Files,
+                                      const StressConfig &Config);
+
+// Returns one message per violated limit. ExpectedMatches, when known, is
+// the match count of the last (full) step.
+std::vector<std::string>
+checkStress(const StressReport &Report, const StressConfig &Config,
+            std::optional<std::size_t> ExpectedMatches = std::nullopt);
+
+// Appends Report as a human-readable table.
+void formatStressTable(OutputBuffer &Out, const StressReport &Report);
+
+} // namespace coogle::bench
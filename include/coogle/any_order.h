@@ -0,0 +1,84 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Argument-order-insensitive matching (--any-order).
+//
+// "A function taking a Foo& and an int, in some order" is a question about
+// the multiset of argument types, not their sequence. Rather than trying
+// every permutation of the query, each signature's arguments are reduced
+// to an ArgMultiset:
+//
+//   - the sorted type IDs of the arguments (TypeNode::Id in a TypeTable)
+//   - a 64-bit hash of the multiset: the sum of a mixed hash of every
+//     normalized argument type. Addition ignores the order, and the hash
+//     depends on the type text only, not on any table, so it is the same
+//     in every worker and every run and can key an index of signatures.
+//
+// A query of concrete types matches a candidate when the hashes agree and
+// a linear merge of the sorted IDs confirms it. With "*" arguments or a
+// variadic tail the merge becomes a containment test (the query's types
+// must all appear, the rest is absorbed), and structural patterns like
+// std::vector<*> and type variables then claim the arguments left over.
+
+#pragma once
+
+#include "match.h"
+#include "parser.h"
+#include "type_tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+// Hash of one normalized type, independent of any TypeTable.
+std::uint64_t typeHash(std::string_view NormType);
+
+// Order-insensitive hash of normalized argument types.
+std::uint64_t argMultisetHash(span<std::string_view> ArgTypesNorm);
+
+// The arguments of one signature, order removed.
+struct ArgMultiset {
+  std::uint64_t Hash = 0;         // argMultisetHash()
+  std::vector<std::uint32_t> Ids; // Sorted
+};
+
+// Fills Out from normalized argument types, interning them into Types.
+void buildArgMultiset(TypeTable &Types, span<std::string_view> ArgTypesNorm,
+                      ArgMultiset &Out);
+
+// Reference: true if some order of Actual's arguments matches Query
+// (see isSignatureMatch()).
+bool isAnyOrderMatch(const Signature &Query, const Signature &Actual);
+
+// A query compiled for --any-order: an ArgMultiset of the arguments without
+// a wildcard, which every candidate must contain, and the structural
+// arguments that then claim what is left. A candidate's arguments become
+// sorted IDs in Types_, in scratch buffers kept between calls.
+class AnyOrderQuery {
+  TypeTable Types_;
+  const TypeNode *RetType_ = nullptr; // Null for a "*" return type
+  ArgMultiset Required_;              // Arguments without a wildcard
+  std::vector<const TypeNode *> Patterns_; // Structural arguments
+  std::size_t Arity_ = 0;
+  bool VariadicTail_ = false;
+  bool Closed_ = false; // Only Required_: the hashes must be equal
+
+  // Scratch reused for every candidate
+  std::vector<std::uint32_t> CandidateIds_;
+  std::vector<std::string_view> Leftover_;
+
+public:
+  // Compiles Query. Its strings must outlive the query.
+  explicit AnyOrderQuery(const Signature &Query);
+
+  // Same result as isAnyOrderMatch(Query, Actual).
+  bool matches(const Signature &Actual);
+
+  const ArgMultiset &required() const { return Required_; }
+  // Number of distinct types interned so far.
+  std::size_t typeCount() const { return Types_.size(); }
+};
+
+} // namespace coogle
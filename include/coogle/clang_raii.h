@@ -3,6 +3,7 @@
 // RAII wrappers for libclang resources to ensure proper cleanup.
 
 #pragma once
+#include "instrument.h"
 #include <clang-c/Index.h>
 
 // RAII wrapper for CXIndex to ensure proper resource cleanup.
@@ -10,11 +11,11 @@ class CXIndexRAII {
   CXIndex Index_;
 
 public:
-  CXIndexRAII() : Index_(clang_createIndex(0, 0)) {}
+  CXIndexRAII() : Index_(COOGLE_CLANG(clang_createIndex, 0, 0)) {}
 
   ~CXIndexRAII() {
     if (Index_) {
-      clang_disposeIndex(Index_);
+      COOGLE_CLANG(clang_disposeIndex, Index_);
     }
   }
 
@@ -30,7 +31,7 @@ public:
   CXIndexRAII &operator=(CXIndexRAII &&Other) noexcept {
     if (this != &Other) {
       if (Index_) {
-        clang_disposeIndex(Index_);
+        COOGLE_CLANG(clang_disposeIndex, Index_);
       }
       Index_ = Other.Index_;
       Other.Index_ = nullptr;
@@ -58,7 +59,7 @@ public:
 
   ~CXTranslationUnitRAII() {
     if (TU_) {
-      clang_disposeTranslationUnit(TU_);
+      COOGLE_CLANG(clang_disposeTranslationUnit, TU_);
     }
   }
 
@@ -75,7 +76,7 @@ public:
   CXTranslationUnitRAII &operator=(CXTranslationUnitRAII &&Other) noexcept {
     if (this != &Other) {
       if (TU_) {
-        clang_disposeTranslationUnit(TU_);
+        COOGLE_CLANG(clang_disposeTranslationUnit, TU_);
       }
       TU_ = Other.TU_;
       Other.TU_ = nullptr;
@@ -100,7 +101,7 @@ class CXStringRAII {
 public:
   explicit CXStringRAII(CXString Str) : Str_(Str) {}
 
-  ~CXStringRAII() { clang_disposeString(Str_); }
+  ~CXStringRAII() { COOGLE_CLANG(clang_disposeString, Str_); }
 
   // Delete copy constructor and assignment operator
   CXStringRAII(const CXStringRAII &) = delete;
@@ -113,7 +114,7 @@ public:
 
   CXStringRAII &operator=(CXStringRAII &&Other) noexcept {
     if (this != &Other) {
-      clang_disposeString(Str_);
+      COOGLE_CLANG(clang_disposeString, Str_);
       Str_ = Other.Str_;
       Other.Str_ = {nullptr, 0};
     }
@@ -121,7 +122,7 @@ public:
   }
 
   // Get C string (can return nullptr)
-  const char *c_str() const { return clang_getCString(Str_); }
+  const char *c_str() const { return COOGLE_CLANG(clang_getCString, Str_); }
 
   // Implicit conversion to CXString for use with libclang API
   operator CXString() const { return Str_; }
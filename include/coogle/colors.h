@@ -16,4 +16,25 @@ constexpr std::string_view Blue = "\033[34m";
 constexpr std::string_view Cyan = "\033[36m";
 constexpr std::string_view Grey = "\033[90m";
 
+// Set of escape codes used by the output formatters.
+// A disabled palette holds empty strings, so formatting code never branches
+// on whether color is enabled.
+struct Palette {
+  std::string_view Reset;
+  std::string_view Bold;
+  std::string_view Green;
+  std::string_view Yellow;
+  std::string_view Blue;
+  std::string_view Cyan;
+  std::string_view Grey;
+};
+
+constexpr Palette palette(bool Enabled) {
+  if (!Enabled) {
+    return Palette{};
+  }
+  return Palette{colors::Reset, colors::Bold, colors::Green, colors::Yellow,
+                 colors::Blue,  colors::Cyan, colors::Grey};
+}
+
 } // namespace coogle::colors
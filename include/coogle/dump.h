@@ -0,0 +1,66 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Record encodings for `coogle dump`, which exports every extracted
+// function signature for use by other tools.
+//
+// NDJSON records carry the same fields as search matches plus the
+// structured return and argument types:
+//
+//   {"file":"a.cpp","line":6,"column":5,"name":"add",
+//    "signature":"int(int, int)","kind":"function",
+//    "return":"int","args":["int","int"]}
+//
+// A C variadic function such as printf adds "variadic":true after "args";
+// the field is left out otherwise.
+//
+// The binary stream starts with the 8-byte magic "CGLDUMP1" followed by
+// length-prefixed records. All integers are little-endian:
+//
+//   u32 payload size (bytes after this field)
+//   u32 line
+//   u32 column
+//   u8  kind (0 = function, 1 = method)
+//   u8  flags (bit 0 = variadic; other bits 0)
+//   u16 argument count
+//   str file, str name, str return type, str args[argument count]
+//
+// where each str is a u32 byte length followed by the bytes (no
+// terminator).
+
+#pragma once
+
+#include "output.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+constexpr std::string_view DumpBinaryMagic = "CGLDUMP1";
+
+// Appends one NDJSON dump object (no trailing separator or newline).
+void formatDumpJson(OutputBuffer &Out, const MatchRecord &Record);
+
+// Appends one binary dump record (see file comment for the layout).
+void encodeDumpRecord(OutputBuffer &Out, const MatchRecord &Record);
+
+// A decoded binary dump record (owns its strings).
+struct DumpRecord {
+  std::string FileName;
+  std::uint32_t Line = 0;
+  std::uint32_t Column = 0;
+  std::string FunctionName;
+  std::string Kind; // "function" or "method"
+  std::string RetType;
+  std::vector<std::string> ArgTypes;
+  bool Variadic = false; // Declared with a "..." tail
+};
+
+// Decodes the next record from In and advances In past it.
+// Returns nullopt if In does not start with a complete, well-formed record.
+std::optional<DumpRecord> decodeDumpRecord(std::string_view &In);
+
+} // namespace coogle
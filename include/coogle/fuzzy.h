@@ -0,0 +1,105 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Typo-tolerant type matching (--fuzzy-types[=N]).
+//
+// A misremembered type name (raw_ostram, StringReff) fails the exact
+// comparison. With --fuzzy-types a query type without a wildcard or type
+// variable also matches candidate types within a small edit (Levenshtein)
+// distance of it, measured on the normalized strings. The allowance grows
+// with the length of the type, one edit per FuzzyCharsPerEdit characters
+// and at most N, so "int" stays exact while "StringReff" takes two edits.
+// Wildcards, structural patterns and type variables keep their meaning.
+//
+// Distances use Myers' bit-parallel algorithm: a query type is compiled
+// once into a bit mask per character (FuzzyPattern), after which each
+// candidate character costs a few word operations, and the scan stops as
+// soon as the distance can no longer come back under the limit. Functions
+// repeat the same few types, so FuzzyQuery interns candidate types into
+// its own TypeTable and caches distances by TypeNode::Id: every distinct
+// type is scored once per query type, not once per function.
+
+#pragma once
+
+#include "match.h"
+#include "parser.h"
+#include "type_tree.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+// Edits allowed per type by --fuzzy-types without a value.
+constexpr unsigned DefaultFuzzyEdits = 2;
+
+// Largest value accepted for --fuzzy-types.
+constexpr unsigned MaxFuzzyEdits = 8;
+
+// Query type characters per allowed edit.
+constexpr std::size_t FuzzyCharsPerEdit = 4;
+
+// Edits allowed for one normalized query type (0 keeps it exact).
+unsigned fuzzyEditLimit(std::string_view QueryType, unsigned MaxEdits);
+
+// Reference Levenshtein distance (dynamic programming).
+unsigned editDistance(std::string_view A, std::string_view B);
+
+// A string preprocessed for Myers' bit-parallel edit distance.
+class FuzzyPattern {
+  std::array<std::uint64_t, 256> Peq_{}; // Bit i: Pattern_[i] is the char
+  std::string_view Pattern_;
+
+public:
+  // Pattern must outlive this object.
+  explicit FuzzyPattern(std::string_view Pattern);
+
+  // The edit distance from the pattern to Text if it is at most Limit,
+  // otherwise some value above Limit. Patterns longer than 64 characters
+  // fall back to editDistance().
+  unsigned distance(std::string_view Text, unsigned Limit) const;
+};
+
+// Reference: isSignatureMatch(), except that a query type without
+// hasTypeWildcard() also matches within fuzzyEditLimit(Type, MaxEdits)
+// edits.
+bool isFuzzyMatch(const Signature &Query, const Signature &Actual,
+                  unsigned MaxEdits);
+
+// A query compiled for --fuzzy-types: a FuzzyPattern for every query type
+// that allows edits, and per query type the distances already computed,
+// keyed by the candidate type's ID in Types_.
+class FuzzyQuery {
+  // One query type: the return type, then each argument.
+  struct TypeCheck {
+    std::string_view Expected;         // Normalized query type
+    const TypeNode *Pattern = nullptr; // Set for hasTypeWildcard() types
+    unsigned Limit = 0;                // Edits allowed, 0 for exact
+    std::size_t Fuzzy = 0;             // Index into Patterns_ (Limit > 0)
+    // Candidate TypeNode::Id -> distance, capped at Limit + 1
+    std::vector<std::uint8_t> Distances;
+  };
+
+  TypeTable Types_;
+  std::vector<FuzzyPattern> Patterns_;
+  std::vector<TypeCheck> Checks_;
+  std::size_t Arity_ = 0;
+  bool VariadicTail_ = false;
+
+  bool checkType(TypeCheck &Check, std::string_view ActualNorm,
+                 TypeBindings &Bindings);
+
+public:
+  // Compiles Query. Its strings must outlive the query.
+  FuzzyQuery(const Signature &Query, unsigned MaxEdits);
+
+  // Same result as isFuzzyMatch(Query, Actual, MaxEdits).
+  bool matches(const Signature &Actual);
+
+  // Number of distinct types interned so far.
+  std::size_t typeCount() const { return Types_.size(); }
+};
+
+} // namespace coogle
@@ -0,0 +1,136 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Compile-time optional instrumentation of libclang calls.
+//
+// Wrap a libclang call as
+//
+//   CXType Canonical = COOGLE_CLANG(clang_getCanonicalType, Type);
+//
+// and, when built with -DCOOGLE_INSTRUMENT=ON, every wrapped function
+// accumulates a call count and inclusive wall time. The per-function table
+// is printed to stderr by COOGLE_INSTRUMENT_REPORT(). In normal builds the
+// macros expand to the plain call (or to nothing), so there is no cost at
+// all.
+//
+// Counters are relaxed atomics shared by all workers. They are cheap enough
+// for profiling runs but are not meant to be always on.
+
+#pragma once
+
+#ifdef COOGLE_INSTRUMENT
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fmt/core.h>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace coogle::instrument {
+
+// Accumulated cost of one instrumented function (all call sites).
+struct Counter {
+  const char *Name;
+  std::atomic<std::uint64_t> Calls{0};
+  std::atomic<std::uint64_t> Ns{0};
+
+  explicit Counter(const char *Name) : Name(Name) {}
+};
+
+// Registry of counters, keyed by function name. Counters are never removed,
+// so references stay valid for the life of the process.
+class Registry {
+  std::mutex Mutex_;
+  std::unordered_map<std::string, std::unique_ptr<Counter>> Counters_;
+
+public:
+  static Registry &get() {
+    static Registry Instance;
+    return Instance;
+  }
+
+  Counter &counter(const char *Name) {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    auto &Slot = Counters_[Name];
+    if (!Slot) {
+      Slot = std::make_unique<Counter>(Name);
+    }
+    return *Slot;
+  }
+
+  // Prints every counter, most expensive first.
+  void report(std::ostream &OS) {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    std::vector<const Counter *> Sorted;
+    for (const auto &Entry : Counters_) {
+      Sorted.push_back(Entry.second.get());
+    }
+    std::sort(Sorted.begin(), Sorted.end(),
+              [](const Counter *A, const Counter *B) { return A->Ns > B->Ns; });
+
+    OS << fmt::format("\n── libclang calls ──\n{:<36} {:>12} {:>12} {:>10}\n",
+                      "function", "calls", "total ms", "ns/call");
+    for (const Counter *C : Sorted) {
+      const std::uint64_t Calls = C->Calls.load(std::memory_order_relaxed);
+      const std::uint64_t Ns = C->Ns.load(std::memory_order_relaxed);
+      OS << fmt::format("{:<36} {:>12} {:>12.2f} {:>10}\n", C->Name, Calls,
+                        static_cast<double>(Ns) / 1e6,
+                        Calls ? Ns / Calls : 0);
+    }
+  }
+};
+
+// Charges its lifetime to a counter.
+class ScopedTimer {
+  Counter &Counter_;
+  std::chrono::steady_clock::time_point Start_;
+
+public:
+  explicit ScopedTimer(Counter &C)
+      : Counter_(C), Start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedTimer() {
+    const auto Elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - Start_);
+    Counter_.Calls.fetch_add(1, std::memory_order_relaxed);
+    Counter_.Ns.fetch_add(static_cast<std::uint64_t>(Elapsed.count()),
+                          std::memory_order_relaxed);
+  }
+
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+// Runs Call under a ScopedTimer and forwards its result.
+template <typename CallFn>
+decltype(auto) timed(Counter &C, CallFn &&Call) {
+  ScopedTimer Timer(C);
+  return Call();
+}
+
+} // namespace coogle::instrument
+
+// The static local resolves the counter once per call site.
+#define COOGLE_CLANG(Fn, ...)                                                  \
+  ::coogle::instrument::timed(                                                 \
+      []() -> ::coogle::instrument::Counter & {                                \
+        static ::coogle::instrument::Counter &C =                              \
+            ::coogle::instrument::Registry::get().counter(#Fn);                \
+        return C;                                                              \
+      }(),                                                                     \
+      [&]() -> decltype(auto) { return Fn(__VA_ARGS__); })
+
+#define COOGLE_INSTRUMENT_REPORT()                                             \
+  ::coogle::instrument::Registry::get().report(std::cerr)
+
+#else
+
+#define COOGLE_CLANG(Fn, ...) Fn(__VA_ARGS__)
+#define COOGLE_INSTRUMENT_REPORT() ((void)0)
+
+#endif // COOGLE_INSTRUMENT
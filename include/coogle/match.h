@@ -0,0 +1,114 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Compiled queries for repeated signature matching.
+//
+// isSignatureMatch() re-reads the query on every call: it compares sizes,
+// walks every argument and tests each one against "*". A search asks the
+// same question for every function of every file, so the query is compiled
+// once into a MatchProgram instead:
+//
+//   - the arity to compare first (the cheapest and most common rejection);
+//     with a variadic tail only the minimum arity, still one comparison
+//   - a bitmask of wildcard positions, which produce no check at all (nor
+//     does a "*" return type)
+//   - one check per remaining position (return type included), ordered so
+//     the most selective types are compared first
+//   - one pattern check per type with a structural wildcard (std::vector<*>)
+//     or a type variable (?T), compiled to a hash-consed type tree and run
+//     after the plain checks; variables bind in one TypeBindings table per
+//     candidate, so the first conflicting use rejects it
+//   - a matcher specialized for the number of checks (0 to 5, i.e. queries
+//     of arity 0 to 4) and for the tail, falling back to a loop for larger
+//     queries
+
+#pragma once
+
+#include "parser.h"
+#include "type_tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+// Rough likelihood that a normalized type does NOT match an arbitrary
+// function's type at the same position (higher = rejects more often).
+// Common builtins score lowest; longer, more qualified names score higher.
+unsigned typeSelectivity(std::string_view NormType);
+
+// True if a candidate taking ActualArity arguments has the arity of a
+// query with Arity fixed arguments: exactly that many, or at least that
+// many with a variadic tail. Shared by every matcher.
+inline bool isArityMatch(std::size_t Arity, bool VariadicTail,
+                         std::size_t ActualArity) {
+  return VariadicTail ? ActualArity >= Arity : ActualArity == Arity;
+}
+
+// True if a query type is the "*" wildcard, which any candidate type
+// matches. Shared by every matcher.
+inline bool isWildcardType(std::string_view Type) { return Type == "*"; }
+
+class MatchProgram {
+public:
+  // Position of the return type in a Check.
+  static constexpr std::uint32_t ReturnPosition = ~0u;
+
+  // One type comparison against the candidate.
+  struct Check {
+    std::string_view Expected; // Normalized query type
+    std::uint32_t Position;    // Argument index or ReturnPosition
+  };
+
+  // One structural comparison against the candidate.
+  struct PatternCheck {
+    const TypeNode *Pattern; // Owned by the program
+    std::uint32_t Position;  // Argument index or ReturnPosition
+  };
+
+  // Compiles Query. Its strings must outlive the program.
+  explicit MatchProgram(const Signature &Query);
+
+  // Same result as isSignatureMatch(Query, Actual).
+  bool matches(const Signature &Actual) const {
+    return Matcher_(*this, Actual);
+  }
+
+  // Number of fixed arguments (the minimum with a variadic tail).
+  std::size_t arity() const { return Arity_; }
+  bool variadicTail() const { return VariadicTail_; }
+  // Bit i is set if argument i is a wildcard (first 64 arguments).
+  std::uint64_t wildcardMask() const { return WildcardMask_; }
+  // Checks in execution order.
+  const std::vector<Check> &checks() const { return Checks_; }
+  // Pattern checks in execution order, after all checks().
+  const std::vector<PatternCheck> &patternChecks() const {
+    return PatternChecks_;
+  }
+
+private:
+  using MatcherFn = bool (*)(const MatchProgram &, const Signature &);
+
+  template <bool Tail>
+  static bool arityMatches(const MatchProgram &Program,
+                           const Signature &Actual);
+  template <std::size_t NumChecks, bool Tail>
+  static bool matchFixed(const MatchProgram &Program,
+                         const Signature &Actual);
+  template <bool Tail>
+  static bool matchLoop(const MatchProgram &Program, const Signature &Actual);
+  template <bool Tail>
+  static bool matchPatterns(const MatchProgram &Program,
+                            const Signature &Actual);
+
+  std::size_t Arity_ = 0;
+  bool VariadicTail_ = false;
+  std::uint64_t WildcardMask_ = 0;
+  std::vector<Check> Checks_;
+  TypeTable Types_;
+  std::vector<PatternCheck> PatternChecks_;
+  MatcherFn Matcher_ = nullptr;
+};
+
+} // namespace coogle
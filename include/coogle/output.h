@@ -0,0 +1,167 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Buffered output writer and result formatters.
+//
+// Workers format matches into their own OutputBuffer and hand complete
+// buffers to a shared OutputWriter, which issues a single write()/writev()
+// per flush. This keeps formatting off the main thread and avoids one
+// syscall per printed line.
+
+#pragma once
+
+#include "colors.h"
+#include "parser.h"
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+// Default reservation for a per-worker output buffer.
+constexpr std::size_t OutputBufferCapacity = 64 * 1024;
+
+// Workers hand their buffer to the writer once it grows past this size.
+constexpr std::size_t OutputFlushThreshold = 1024 * 1024;
+
+// When to emit ANSI color codes (--color=auto|always|never).
+enum class ColorMode { Auto, Always, Never };
+
+// Parses the value of --color. Returns nullopt for unknown values.
+std::optional<ColorMode> parseColorMode(std::string_view Value);
+
+// Result encoding (--format=text|json|ndjson|binary).
+//   Text:   human-readable, grouped by file
+//   Json:   a single JSON array with one object per match
+//   Ndjson: one JSON object per line, suitable for streaming consumers
+//   Binary: length-prefixed records (coogle dump only, see dump.h)
+enum class OutputFormat { Text, Json, Ndjson, Binary };
+
+// Parses the value of --format. Returns nullopt for unknown values.
+std::optional<OutputFormat> parseOutputFormat(std::string_view Value);
+
+// Separator emitted before every record of a JSON array.
+constexpr std::string_view JsonRecordSeparator = ",\n";
+
+// Resolves a color mode against a file descriptor.
+// Auto enables color only when Fd refers to a terminal.
+bool shouldUseColor(ColorMode Mode, int Fd);
+
+// Growable byte buffer for formatted output.
+// Appends never touch the file descriptor; see OutputWriter.
+class OutputBuffer {
+  std::vector<char> Data_;
+
+public:
+  OutputBuffer() { Data_.reserve(OutputBufferCapacity); }
+
+  void append(std::string_view Str) {
+    Data_.insert(Data_.end(), Str.begin(), Str.end());
+  }
+
+  void append(char C) { Data_.push_back(C); }
+
+  // Appends the decimal representation of Value without allocating.
+  void appendUnsigned(unsigned long long Value);
+
+  std::string_view view() const {
+    return std::string_view(Data_.data(), Data_.size());
+  }
+
+  std::size_t size() const { return Data_.size(); }
+  bool empty() const { return Data_.empty(); }
+
+  // Drops the contents but keeps the capacity for reuse.
+  void clear() { Data_.clear(); }
+};
+
+// Serializes output buffers to a file descriptor.
+// Safe to call from multiple worker threads; each call is written
+// atomically with respect to other calls on the same writer.
+class OutputWriter {
+  int Fd_;
+  std::mutex Mutex_;
+  std::string_view LeadingSeparator_;
+  bool SeparatorStripped_ = false;
+
+  // Drops LeadingSeparator_ from the first chunk written. Caller holds
+  // Mutex_.
+  std::string_view stripLeadingSeparator(std::string_view Chunk);
+
+public:
+  explicit OutputWriter(int Fd) : Fd_(Fd) {}
+
+  // Records written after this call are each prefixed by Separator.
+  // The writer strips it from the first chunk it emits, so workers can
+  // prefix every record unconditionally and the stream still forms a
+  // valid list (used for --format=json).
+  void setLeadingSeparator(std::string_view Separator) {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    LeadingSeparator_ = Separator;
+  }
+
+  // Writes the buffer with a single write() (retrying on short writes)
+  // and clears it. Returns false on I/O error.
+  bool write(OutputBuffer &Buffer);
+
+  // Writes several buffers in order with writev() and clears them.
+  // Returns false on I/O error.
+  bool write(span<OutputBuffer *> Buffers);
+
+  int fd() const { return Fd_; }
+
+  OutputWriter(const OutputWriter &) = delete;
+  OutputWriter &operator=(const OutputWriter &) = delete;
+};
+
+// Replaces the contents of the file at Path with Buffer and clears it.
+// Prints an error naming What (e.g. "trace") and returns false on failure.
+bool writeFileContents(const std::string &Path, OutputBuffer &Buffer,
+                       std::string_view What);
+
+// Appends a signature as "ret(arg1, arg2)", matching toString().
+void appendSignature(OutputBuffer &Out, const Signature &Sig);
+
+// Appends Str as a quoted JSON string, escaping quotes, backslashes and
+// control characters. Other bytes (including UTF-8) are copied verbatim.
+void appendJsonString(OutputBuffer &Out, std::string_view Str);
+
+// A single search hit, as seen by the machine-readable formatters.
+struct MatchRecord {
+  std::string_view FileName;
+  unsigned Line;
+  unsigned Column;
+  std::string_view FunctionName;
+  std::string_view Kind; // "function" or "method"
+  const Signature *Sig;
+};
+
+// Appends one JSON object for Match (no trailing separator or newline).
+void formatMatchJson(OutputBuffer &Out, const MatchRecord &Match);
+
+// Appends the fields of formatMatchJson() without the enclosing braces,
+// for records that extend the match object.
+void formatMatchJsonFields(OutputBuffer &Out, const MatchRecord &Match);
+
+// Formatters for --files-with-matches and --count.
+void formatMatchedFile(OutputBuffer &Out, const colors::Palette &Colors,
+                       std::string_view FileName);
+void formatMatchedFileJson(OutputBuffer &Out, std::string_view FileName);
+void formatCountJson(OutputBuffer &Out, std::size_t Count);
+
+// Human-readable formatters used by the default text output.
+void formatSearchHeader(OutputBuffer &Out, const colors::Palette &Colors,
+                        const Signature &Query);
+void formatFileHeader(OutputBuffer &Out, const colors::Palette &Colors,
+                      std::string_view FileName);
+void formatMatch(OutputBuffer &Out, const colors::Palette &Colors,
+                 unsigned Line, std::string_view FunctionName,
+                 const Signature &Sig);
+void formatParseFailure(OutputBuffer &Out, const colors::Palette &Colors,
+                        std::string_view FileName);
+void formatSummary(OutputBuffer &Out, std::size_t TotalMatches);
+
+} // namespace coogle
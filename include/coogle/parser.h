@@ -18,11 +18,18 @@ namespace coogle {
 //
 // Pre-normalized types are stored for O(1) matching without repeated
 // normalization.
+//
+// Queries may use "*" for the return type or any argument, and end the
+// argument list with "..." (or "..") to accept zero or more further
+// arguments, including the variadic part of C functions like printf.
+// A "*" inside a type is a structural pattern (see type_tree.h).
 struct Signature {
   std::string_view RetType;            // Original return type
   std::string_view RetTypeNorm;        // Normalized return type
   span<std::string_view> ArgTypes;     // Original argument types
   span<std::string_view> ArgTypesNorm; // Normalized argument types
+  bool VariadicTail = false;           // Ends with "..." (C variadic)
+  bool HasTypeVariables = false;       // Query uses a type variable ("?T")
 };
 
 // Helper class to manage signature storage with arena-backed strings.
@@ -64,6 +71,13 @@ public:
 
   // Gets access to the underlying arena for custom operations.
   StringArena &arena() { return Strings_; }
+
+  // Drops all strings and arguments, keeping the capacity for reuse.
+  void clear() {
+    Strings_.clear();
+    ArgBuffer_.clear();
+    ArgNormBuffer_.clear();
+  }
 };
 
 // Parses a function signature string into a Signature struct.
@@ -85,7 +99,9 @@ std::string_view normalizeType(StringArena &Arena, std::string_view Type);
 
 // Checks if two signatures match.
 // Uses pre-normalized types for O(1) comparison.
-// Supports wildcard matching with "*" in argument types.
+// Supports "*" for the return and argument types of UserSig, structural
+// patterns like std::vector<*> inside them, and a variadic tail that
+// accepts any further arguments of ActualSig.
 bool isSignatureMatch(const Signature &UserSig, const Signature &ActualSig);
 
 } // namespace coogle
@@ -0,0 +1,103 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Hardware performance counters for --perf-counters (Linux perf_event_open).
+//
+// Each thread opens its own counters (user space only) and installs them
+// with PerfThreadScope; PhaseTimer then samples them around the coarse
+// pipeline phases. When the kernel refuses (containers, missing PMU,
+// perf_event_paranoid) the counters report themselves unavailable and the
+// rest of the run is unaffected.
+//
+// A thread's counters miss work done on other threads, and libclang parses
+// on a helper thread it starts per file unless told otherwise. Workers
+// therefore open their counters with CountChildThreads, so threads they
+// start later (libclang's among them) are counted too once they exit; and
+// --stats runs the parse on the worker thread anyway
+// (parseOnCallingThread()). The main thread does not inherit: its children
+// are the workers, which count themselves.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace coogle {
+
+enum class PerfEvent { Cycles, Instructions, CacheMisses, BranchMisses };
+
+constexpr std::size_t NumPerfEvents =
+    static_cast<std::size_t>(PerfEvent::BranchMisses) + 1;
+
+// Display name of a counter.
+const char *perfEventName(PerfEvent Event);
+
+// A sample (or a difference of samples) of every counter. Counters that
+// could not be opened are reported as zero and flagged in Valid.
+struct PerfCounts {
+  std::array<std::uint64_t, NumPerfEvents> Values{};
+  std::array<bool, NumPerfEvents> Valid{};
+
+  std::uint64_t operator[](PerfEvent Event) const {
+    return Values[static_cast<std::size_t>(Event)];
+  }
+  bool valid(PerfEvent Event) const {
+    return Valid[static_cast<std::size_t>(Event)];
+  }
+  bool anyValid() const {
+    for (bool V : Valid) {
+      if (V) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Accumulates Other; a counter is valid if it was valid in either.
+  PerfCounts &operator+=(const PerfCounts &Other);
+};
+
+// Counter values accumulated between Start and End.
+PerfCounts perfDelta(const PerfCounts &Start, const PerfCounts &End);
+
+// The counters of the calling thread.
+class PerfCounters {
+  std::array<int, NumPerfEvents> Fds_;
+  std::string Error_; // Why the first unavailable counter failed to open
+
+public:
+  // With CountChildThreads, threads the calling thread starts from now on
+  // add their counts to these counters when they exit.
+  explicit PerfCounters(bool CountChildThreads = false);
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // True if at least one counter is running.
+  bool available() const;
+
+  // Reason a counter could not be opened (empty if all opened).
+  const std::string &error() const { return Error_; }
+
+  // Current counter values (one read per counter).
+  PerfCounts read() const;
+};
+
+// Counters installed for the calling thread, or null.
+PerfCounters *threadPerfCounters();
+
+// Installs Counters for the calling thread for the lifetime of the scope.
+class PerfThreadScope {
+  PerfCounters *Previous_;
+
+public:
+  explicit PerfThreadScope(PerfCounters *Counters);
+  ~PerfThreadScope();
+
+  PerfThreadScope(const PerfThreadScope &) = delete;
+  PerfThreadScope &operator=(const PerfThreadScope &) = delete;
+};
+
+} // namespace coogle
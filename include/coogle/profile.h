@@ -0,0 +1,78 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Per-file cost profile for --profile-files.
+//
+// A profile records how expensive each translation unit was to process.
+// It is printed as a "slowest files" report and can be saved and loaded
+// again so later runs balance workers by cost and skip pathological files.
+//
+// Saved profiles are plain tab-separated text:
+//
+//   # coogle profile v1
+//   # file  parse_us  visit_us  memory_bytes  functions
+//   src/a.cpp	1520	85	1048576	12
+//
+// Lines starting with '#' are comments.
+
+#pragma once
+
+#include "output.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace coogle {
+
+constexpr std::string_view ProfileHeader = "# coogle profile v1";
+
+// Rows shown by --profile-files when no count is given.
+constexpr std::size_t DefaultProfileTopN = 10;
+
+// Measured cost of one translation unit.
+struct FileProfile {
+  std::string File;
+  std::uint64_t ParseNs = 0;
+  std::uint64_t VisitNs = 0;
+  std::uint64_t MemoryBytes = 0; // clang_getCXTUResourceUsage total
+  std::uint64_t Functions = 0;
+
+  std::uint64_t costNs() const { return ParseNs + VisitNs; }
+};
+
+// Appends the N most expensive files, slowest first.
+void formatTopFiles(OutputBuffer &Out, std::vector<FileProfile> Profiles,
+                    std::size_t N);
+
+// Appends Profiles in the saved-profile format (see file comment).
+void formatProfile(OutputBuffer &Out, const std::vector<FileProfile> &Profiles);
+
+// Parses a saved profile. Malformed rows are skipped; returns nullopt if
+// Text does not start with ProfileHeader.
+std::optional<std::vector<FileProfile>> parseProfile(std::string_view Text);
+
+// Writes Profiles to Path. Prints an error and returns false on failure.
+bool saveProfile(const std::string &Path,
+                 const std::vector<FileProfile> &Profiles);
+
+// Reads a profile saved by saveProfile. Prints an error and returns nullopt
+// on failure.
+std::optional<std::vector<FileProfile>> loadProfile(const std::string &Path);
+
+// Cost of each profiled file, keyed by path.
+using CostMap = std::unordered_map<std::string, std::uint64_t>;
+
+CostMap makeCostMap(const std::vector<FileProfile> &Profiles);
+
+// Splits Files into NumChunks chunks of roughly equal total cost, placing
+// the most expensive files first (longest-processing-time-first). Files
+// missing from Costs are assumed to cost the average of the known ones.
+std::vector<std::vector<std::string>>
+partitionByCost(const std::vector<std::string> &Files, const CostMap &Costs,
+                std::size_t NumChunks);
+
+} // namespace coogle
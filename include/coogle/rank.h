@@ -0,0 +1,141 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Ranked search (--rank[=K]).
+//
+// Exact matching finds nothing when the query gets the argument order, a
+// reference or one argument slightly wrong. Ranked search scores every
+// function by how far it is from the query instead, Hoogle-style, and
+// reports the K closest. A score is a sum of penalties (RankCosts), so 0
+// is an exact match:
+//
+//   - argument types: equal (const is ignored, as in exact matching), or
+//     relaxed by dropping a reference (T vs const T&) and/or one pointer
+//     level (T vs T*)
+//   - argument order: one penalty per pair of matched arguments that
+//     appears in the opposite order in the candidate
+//   - arity: candidates may take a subset or a superset of the query's
+//     arguments, at a penalty per missing or extra argument
+//   - return type: relaxed like arguments, or a flat penalty if unrelated
+//
+// Wildcards and structural patterns keep their meaning; type variables
+// match like "*" but are only unified within one type. A variadic tail
+// absorbs the candidate's arguments after the last paired one; extras
+// before it still count.
+//
+// Each worker keeps its best K in a bounded heap (TopMatches) and the
+// heaps are merged once all workers are done. A candidate is first
+// checked against a cheap lower bound (arity and return type only); the
+// argument assignment is scored only if that bound could still enter the
+// heap.
+
+#pragma once
+
+#include "colors.h"
+#include "output.h"
+#include "parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle {
+
+// Number of results reported by --rank without a value.
+constexpr std::size_t DefaultRankTopK = 10;
+
+// Largest K accepted by --rank. Every worker may hold K matches.
+constexpr std::size_t MaxRankTopK = 10000;
+
+// Queries and candidates with more arguments than this are scored by
+// position instead of by the best argument assignment.
+constexpr std::size_t MaxRankedArity = 10;
+
+// Penalties that make up a score.
+struct RankCosts {
+  static constexpr unsigned Reference = 1;  // T vs T& or T&&
+  static constexpr unsigned Pointer = 2;    // T vs T*
+  static constexpr unsigned Reorder = 1;    // Per swapped argument pair
+  static constexpr unsigned ExtraArg = 2;   // Candidate argument not queried
+  static constexpr unsigned MissingArg = 3; // Queried argument not taken
+  static constexpr unsigned Return = 4;     // Unrelated return type
+};
+
+// Returned by typeDistance() for types that cannot be paired.
+constexpr unsigned NoTypeMatch = std::numeric_limits<unsigned>::max();
+
+// Penalty for pairing normalized query type Query with Actual, or
+// NoTypeMatch.
+unsigned typeDistance(std::string_view Query, std::string_view Actual);
+
+// A query compiled for scoring. The query's strings must outlive it.
+class RankedQuery {
+  std::string_view RetType_; // Normalized; empty for a "*" return type
+  std::vector<std::string_view> ArgTypes_; // Normalized
+  bool VariadicTail_ = false;
+
+  unsigned returnCost(const Signature &Actual) const;
+  unsigned arityCost(std::size_t ActualArgs) const;
+
+public:
+  explicit RankedQuery(const Signature &Query);
+
+  // Never above score(Actual), and much cheaper.
+  unsigned lowerBound(const Signature &Actual) const;
+
+  // Penalty of Actual against the query; 0 for an exact match.
+  unsigned score(const Signature &Actual) const;
+};
+
+// One ranked result (owns its strings).
+struct RankedMatch {
+  unsigned Score = 0;
+  std::string FileName;
+  std::uint32_t Line = 0;
+  std::uint32_t Column = 0;
+  std::string FunctionName;
+  std::string_view Kind; // cursorKindName()
+  std::string RetType;
+  std::vector<std::string> ArgTypes;
+  bool VariadicTail = false;
+};
+
+// Best first: lower score, then file, line and column, so the results do
+// not depend on how files were spread over workers.
+bool rankedBefore(const RankedMatch &A, const RankedMatch &B);
+
+// Bounded heap of the best K matches of one worker. It grows as matches
+// arrive, so a large K costs nothing until that many functions match.
+class TopMatches {
+  std::size_t K_;
+  std::vector<RankedMatch> Heap_; // Worst match at the front
+
+public:
+  explicit TopMatches(std::size_t K) : K_(K) {}
+
+  // False if no match scoring Score (or more) can enter the heap.
+  bool admits(unsigned Score) const {
+    return Heap_.size() < K_ || (K_ > 0 && Score <= Heap_.front().Score);
+  }
+
+  void offer(RankedMatch Match);
+
+  std::size_t size() const { return Heap_.size(); }
+
+  // Returns the kept matches, best first, and empties the heap.
+  std::vector<RankedMatch> take();
+};
+
+// Merges per-worker results (each best first) into the overall best K.
+std::vector<RankedMatch>
+mergeTopMatches(std::vector<std::vector<RankedMatch>> Lists, std::size_t K);
+
+// Text and JSON formatters for ranked results. The JSON object carries the
+// fields of formatMatchJson() plus "score".
+void formatRankedMatch(OutputBuffer &Out, const colors::Palette &Colors,
+                       const RankedMatch &Match);
+void formatRankedMatchJson(OutputBuffer &Out, const RankedMatch &Match);
+
+} // namespace coogle
@@ -0,0 +1,169 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Search pipeline: source discovery, libclang extraction and the parallel
+// worker loop shared by the search and dump commands.
+
+#pragma once
+
+#include "colors.h"
+#include "output.h"
+#include "parser.h"
+#include "profile.h"
+#include "rank.h"
+#include "stats.h"
+#include "trace.h"
+
+#include <algorithm>
+#include <clang-c/Index.h>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace coogle {
+
+// What to report for each match.
+//   List:             every match with its location and signature
+//   Count:            only the total number of matches (--count)
+//   FilesWithMatches: only the names of files with at least one match
+//                     (--files-with-matches)
+enum class ResultMode { List, Count, FilesWithMatches };
+
+// Settings shared (read-only) by all workers.
+struct WorkerSettings {
+  ResultMode Mode;
+  OutputFormat Format;
+  colors::Palette Colors;
+  std::size_t FlushThreshold;  // Flush a worker buffer once it reaches this
+  bool CollectStats = false;   // Fill TaskResult::Stats (--stats)
+  bool CollectTrace = false;   // Fill TaskResult::Trace (--trace)
+  bool CollectProfile = false; // Fill TaskResult::Profile (--profile-files)
+  bool CollectPerf = false;    // Add hardware counters to Stats
+  bool AnyOrder = false;       // Match arguments in any order (--any-order)
+  unsigned FuzzyEdits = 0;     // Typos allowed per type (--fuzzy-types)
+  bool ShortNames = false;     // Names match in any scope (--short-names)
+};
+
+// Result of a processing task (thread-local storage)
+struct TaskResult {
+  OutputBuffer Output; // Formatted records not yet flushed
+  std::size_t MatchCount = 0;
+  std::vector<std::string> Failures; // Reported on stderr for JSON formats
+  WorkerStats Stats;                 // Only filled when CollectStats is set
+  std::unique_ptr<TraceBuffer> Trace; // Only set when CollectTrace is set
+  std::vector<FileProfile> Profile;   // Only filled when CollectProfile is set
+  std::vector<RankedMatch> Ranked;    // Only filled by rankFiles(), best first
+
+  // Enable move
+  TaskResult() = default;
+  TaskResult(TaskResult &&) = default;
+  TaskResult &operator=(TaskResult &&) = default;
+  TaskResult(const TaskResult &) = delete;
+  TaskResult &operator=(const TaskResult &) = delete;
+};
+
+// Finds all C/C++ source files in the given path (a file or a directory,
+// searched recursively).
+std::vector<std::string> findSourceFiles(const std::filesystem::path &Path);
+
+// Default libclang command line used for every translation unit.
+std::vector<std::string> defaultClangArgs();
+
+// libclang parse options used for every translation unit.
+// - SkipFunctionBodies: We only need signatures
+// - Incomplete: Allow parsing errors (missing headers)
+// - SingleFileParse: Don't process included headers (we don't want them
+// anyway)
+// - KeepGoing: Don't stop at the first fatal error
+constexpr unsigned ParseOptions =
+    CXTranslationUnit_SkipFunctionBodies | CXTranslationUnit_Incomplete |
+    CXTranslationUnit_SingleFileParse | CXTranslationUnit_KeepGoing;
+
+// Makes libclang parse on the calling thread instead of a helper thread it
+// starts per translation unit, so that thread CPU time and hardware
+// counters of the worker cover the parse (--stats). Sets
+// LIBCLANG_NOTHREADS, so call it before any worker starts.
+void parseOnCallingThread();
+
+// Returns true for the cursor kinds whose signatures coogle indexes.
+inline bool isFunctionCursor(CXCursorKind Kind) {
+  return Kind == CXCursor_FunctionDecl || Kind == CXCursor_CXXMethod;
+}
+
+// Human-readable name of a function-like cursor kind.
+inline std::string_view cursorKindName(CXCursorKind Kind) {
+  return Kind == CXCursor_CXXMethod ? "method" : "function";
+}
+
+// Builds the canonical signature of a function cursor.
+// Strings are interned into Storage, which must outlive the result.
+Signature extractSignature(CXCursor Cursor, SignatureStorage &Storage);
+
+// Parses Files and reports every function matching TargetSig.
+TaskResult processFiles(const std::vector<std::string> &Files,
+                        const Signature &TargetSig,
+                        const std::vector<const char *> &ClangArgs,
+                        OutputWriter &Writer, const WorkerSettings &Settings);
+
+// Parses Files and keeps the K functions closest to TargetSig (--rank).
+// Nothing is written; the matches are returned in TaskResult::Ranked.
+TaskResult rankFiles(const std::vector<std::string> &Files,
+                     const Signature &TargetSig, std::size_t K,
+                     const std::vector<const char *> &ClangArgs,
+                     OutputWriter &Writer, const WorkerSettings &Settings);
+
+// Parses Files and emits every extracted function signature
+// (coogle dump). Settings.Format selects NDJSON, JSON or binary records.
+TaskResult dumpFiles(const std::vector<std::string> &Files,
+                     const std::vector<const char *> &ClangArgs,
+                     OutputWriter &Writer, const WorkerSettings &Settings);
+
+// Number of workers used when none is requested explicitly.
+inline std::size_t defaultThreadCount() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Runs Task on each chunk concurrently, one worker per non-empty chunk.
+// Results are returned in chunk order.
+template <typename TaskFn>
+std::vector<TaskResult>
+runPartitioned(std::vector<std::vector<std::string>> Chunks, TaskFn Task) {
+  std::vector<std::future<TaskResult>> Futures;
+
+  // Launch tasks
+  for (auto &ChunkFiles : Chunks) {
+    if (ChunkFiles.empty())
+      continue;
+    Futures.push_back(
+        std::async(std::launch::async, Task, std::move(ChunkFiles)));
+  }
+
+  // Collect results
+  std::vector<TaskResult> AllResults;
+  for (auto &Fut : Futures) {
+    AllResults.push_back(Fut.get());
+  }
+  return AllResults;
+}
+
+// Splits Files into one contiguous chunk per worker and runs Task on each
+// chunk concurrently. Results are returned in chunk order.
+template <typename TaskFn>
+std::vector<TaskResult> runChunked(const std::vector<std::string> &Files,
+                                   std::size_t NumThreads, TaskFn Task) {
+  const std::size_t NumFiles = Files.size();
+  const std::size_t ChunkSize = (NumFiles + NumThreads - 1) / NumThreads;
+
+  std::vector<std::vector<std::string>> Chunks;
+  for (std::size_t Start = 0; Start < NumFiles; Start += ChunkSize) {
+    std::size_t End = std::min(Start + ChunkSize, NumFiles);
+    Chunks.emplace_back(Files.begin() + Start, Files.begin() + End);
+  }
+  return runPartitioned(std::move(Chunks), std::move(Task));
+}
+
+} // namespace coogle
@@ -0,0 +1,117 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Short type names (--short-names).
+//
+// Users write StringRef(StringRef) where the code says
+// llvm::StringRef(llvm::StringRef), and the normalized comparison fails.
+// With --short-names a name in a query matches every type whose qualified
+// name ends with the same scope components: "StringRef" matches
+// "llvm::StringRef", "string" matches "std::string", "Twine" matches
+// neither "llvm::Twines" nor "llvm::Twine::Kind". Names inside pointers,
+// references and template arguments resolve the same way, and so do
+// template names ("vector<StringRef>").
+//
+// Every distinct named type a worker sees is interned into its TypeTable
+// and entered once into a TypeNameIndex, a trie over the reversed "::"
+// components of the qualified names. The node reached by a query name's
+// components holds the IDs of every type ending in them, so the name is
+// resolved to that ID set once, when the query is compiled, and the set
+// keeps growing as extraction enters new names. Matching is then a
+// membership test per name, and the verdict for a whole candidate type is
+// cached by its ID.
+
+#pragma once
+
+#include "match.h"
+#include "parser.h"
+#include "type_tree.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace coogle {
+
+// True if the "::" components of Name end with those of Suffix.
+bool isQualifiedSuffix(std::string_view Suffix, std::string_view Name);
+
+// A set of TypeNode::Id values.
+class TypeIdSet {
+  std::vector<std::uint64_t> Words_;
+
+public:
+  void insert(std::uint32_t Id);
+  bool contains(std::uint32_t Id) const {
+    const std::size_t Word = Id / 64;
+    return Word < Words_.size() && (Words_[Word] >> (Id % 64)) & 1;
+  }
+};
+
+// Suffix index of qualified type names: a trie keyed by the components of
+// each name from the last one back.
+class TypeNameIndex {
+  struct Node {
+    std::unordered_map<std::string_view, std::uint32_t> Children;
+    TypeIdSet Ids; // Names ending with the components on the path here
+  };
+  std::deque<Node> Nodes_; // [0] is the root
+
+  std::uint32_t child(std::uint32_t Parent, std::string_view Component);
+
+public:
+  TypeNameIndex();
+
+  // Enters a qualified name. Name must outlive the index.
+  void insert(std::string_view Name, std::uint32_t Id);
+
+  // The IDs of the names ending with the components of Suffix. The set
+  // stays valid and takes in names inserted later. Suffix must outlive
+  // the index.
+  const TypeIdSet &lookup(std::string_view Suffix);
+};
+
+// Reference: isSignatureMatch(), with names compared by
+// isQualifiedSuffix() instead of equality.
+bool isShortNameMatch(const Signature &Query, const Signature &Actual);
+
+// A query compiled for --short-names: each name in the query resolved to
+// its ID set in Names_, and per query type the verdicts so far, keyed by
+// candidate type ID. Names seen in candidates grow Names_ as they come.
+class ShortNameQuery {
+  // One query type: the return type, then each argument.
+  struct TypeCheck {
+    const TypeNode *Pattern = nullptr; // Null for "*"
+    bool Cached = false;               // No type variables
+    // Candidate TypeNode::Id -> NotChecked, Match or NoMatch
+    std::vector<std::uint8_t> Verdicts;
+  };
+
+  TypeTable Types_;
+  TypeNameIndex Names_;
+  std::size_t Indexed_ = 0; // Nodes of Types_ entered into Names_
+  // Query name node ID -> the IDs it resolves to
+  std::vector<const TypeIdSet *> Resolved_;
+  std::vector<TypeCheck> Checks_;
+  std::size_t Arity_ = 0;
+  bool VariadicTail_ = false;
+
+  const TypeNode &internType(std::string_view NormType);
+  void resolveNames(const TypeNode &Pattern);
+  bool checkType(TypeCheck &Check, std::string_view ActualNorm,
+                 TypeBindings &Bindings);
+
+public:
+  // Compiles Query. Its strings must outlive the query.
+  explicit ShortNameQuery(const Signature &Query);
+
+  // Same result as isShortNameMatch(Query, Actual).
+  bool matches(const Signature &Actual);
+
+  // Number of distinct types interned so far.
+  std::size_t typeCount() const { return Types_.size(); }
+};
+
+} // namespace coogle
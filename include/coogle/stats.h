@@ -0,0 +1,144 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Pipeline instrumentation for --stats.
+//
+// Every worker owns a WorkerStats; nothing is shared while the workers run
+// and the per-worker counters are merged once at the end. Instrumentation
+// points hold a WorkerStats pointer that is null when --stats is off, so a
+// disabled build of the pipeline pays one predictable branch per point.
+
+#pragma once
+
+#include "output.h"
+#include "perf.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coogle {
+
+// Pipeline phases timed by --stats.
+// Visit includes Extract, Match and result formatting.
+enum class Phase {
+  Discovery,  // Finding source files
+  QueryParse, // Parsing the query signature
+  Parse,      // clang_parseTranslationUnit (see parseOnCallingThread())
+  Visit,      // clang_visitChildren
+  Extract,    // Building Signatures from cursors
+  Match,      // isSignatureMatch
+  Output,     // Writing buffers to stdout
+};
+
+constexpr std::size_t NumPhases = static_cast<std::size_t>(Phase::Output) + 1;
+
+// Display name of a phase.
+const char *phaseName(Phase P);
+
+// Whether --perf-counters samples a phase. Extract and Match run once per
+// function, where a counter read (one syscall per counter) would cost more
+// than the work being measured; their counts are included in Visit.
+constexpr bool isPerfSampled(Phase P) {
+  return P != Phase::Extract && P != Phase::Match;
+}
+
+// Accumulated wall-clock and thread CPU time, in nanoseconds.
+struct PhaseTime {
+  std::uint64_t WallNs = 0;
+  std::uint64_t CpuNs = 0;
+};
+
+// Counters owned by a single thread.
+struct WorkerStats {
+  std::array<PhaseTime, NumPhases> Phases{};
+  std::array<PerfCounts, NumPhases> Perf{}; // Only with --perf-counters
+  std::uint64_t FilesParsed = 0;
+  std::uint64_t ParseFailures = 0;
+  std::uint64_t FunctionsVisited = 0;
+  std::uint64_t Matches = 0;
+  std::uint64_t BusyNs = 0; // Wall time from task start to task end
+
+  PhaseTime &operator[](Phase P) {
+    return Phases[static_cast<std::size_t>(P)];
+  }
+  const PhaseTime &operator[](Phase P) const {
+    return Phases[static_cast<std::size_t>(P)];
+  }
+
+  // Adds Other's counters and times into this one.
+  WorkerStats &operator+=(const WorkerStats &Other);
+};
+
+// Monotonic wall clock in nanoseconds.
+std::uint64_t wallNowNs();
+
+// CPU time consumed by the calling thread, in nanoseconds.
+std::uint64_t threadCpuNowNs();
+
+// RAII timer that charges its lifetime to one phase of a WorkerStats.
+// Does nothing when Stats is null.
+// Also samples the thread's hardware counters, if installed, for the
+// phases where isPerfSampled() holds.
+class PhaseTimer {
+  WorkerStats *Stats_;
+  Phase Phase_;
+  std::uint64_t StartWall_ = 0;
+  std::uint64_t StartCpu_ = 0;
+  PerfCounters *Counters_ = nullptr;
+  PerfCounts StartPerf_;
+
+public:
+  PhaseTimer(WorkerStats *Stats, Phase P) : Stats_(Stats), Phase_(P) {
+    if (Stats_) {
+      if (isPerfSampled(P) && (Counters_ = threadPerfCounters())) {
+        StartPerf_ = Counters_->read();
+      }
+      StartWall_ = wallNowNs();
+      StartCpu_ = threadCpuNowNs();
+    }
+  }
+
+  ~PhaseTimer() {
+    if (Stats_) {
+      PhaseTime &Time = (*Stats_)[Phase_];
+      Time.WallNs += wallNowNs() - StartWall_;
+      Time.CpuNs += threadCpuNowNs() - StartCpu_;
+      if (Counters_) {
+        Stats_->Perf[static_cast<std::size_t>(Phase_)] +=
+            perfDelta(StartPerf_, Counters_->read());
+      }
+    }
+  }
+
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+};
+
+// Process-wide resource usage.
+struct ProcessUsage {
+  std::uint64_t UserCpuNs = 0;
+  std::uint64_t SystemCpuNs = 0;
+  std::uint64_t PeakRssBytes = 0;
+};
+
+// Reads the current process resource usage (getrusage).
+ProcessUsage currentProcessUsage();
+
+// Everything needed to print the --stats report.
+struct StatsReport {
+  WorkerStats Main;                 // Phases run on the main thread
+  std::vector<WorkerStats> Workers; // One entry per worker, in launch order
+  std::uint64_t TotalWallNs = 0;    // Whole run
+  std::uint64_t ParallelWallNs = 0; // Workers launched until all joined
+  std::size_t NumFiles = 0;
+  ProcessUsage Usage;
+  bool PerfRequested = false; // --perf-counters
+  std::string PerfError;      // Why counters are unavailable, if they are
+};
+
+// Appends a human-readable report.
+void formatStatsReport(OutputBuffer &Out, const StatsReport &Report);
+
+} // namespace coogle
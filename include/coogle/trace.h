@@ -0,0 +1,100 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Worker timeline export for --trace, in the Chrome trace-event format
+// (loadable in chrome://tracing and ui.perfetto.dev).
+//
+// Each worker records complete ("X") events into its own ring buffer, so
+// recording takes no locks and memory stays bounded however many files are
+// scanned. The ring grows as events arrive, up to TraceBufferCapacity, and
+// events name their file by index into the worker's file list, so a span
+// costs no allocation once the ring has grown. The buffers are serialized
+// once, after all workers have joined, with one track per worker.
+
+#pragma once
+
+#include "output.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace coogle {
+
+// Events kept per worker; older events are overwritten once it is full.
+constexpr std::size_t TraceBufferCapacity = 1 << 16;
+
+// A timed span on one worker's track.
+struct TraceEvent {
+  std::string_view Name;     // Static string: "parse", "visit", ...
+  std::size_t File = 0;      // Index into the worker's file list
+  std::uint64_t StartNs = 0; // wallNowNs() at span start
+  std::uint64_t DurNs = 0;
+  std::uint64_t Bytes = 0;     // Source file size
+  std::uint64_t Functions = 0; // Function cursors visited (visit spans)
+};
+
+// Bounded ring buffer of trace events owned by a single worker.
+class TraceBuffer {
+  std::vector<std::string> Files_; // The worker's files, in scan order
+  std::vector<TraceEvent> Events_;
+  std::size_t Capacity_;
+  std::size_t Next_ = 0;  // Slot written by the next record() once full
+  std::size_t Total_ = 0; // Events recorded, including overwritten ones
+
+public:
+  // Files is the list the worker scans; the chunk it is given only lives
+  // as long as the worker, so the buffer keeps its own copy for export.
+  explicit TraceBuffer(std::vector<std::string> Files,
+                       std::size_t Capacity = TraceBufferCapacity)
+      : Files_(std::move(Files)), Capacity_(Capacity) {}
+
+  // Records Event, overwriting the oldest event when the buffer is full.
+  void record(const TraceEvent &Event) {
+    Total_++;
+    if (Events_.size() < Capacity_) {
+      Events_.push_back(Event);
+      return;
+    }
+    if (Capacity_ == 0) {
+      return;
+    }
+    Events_[Next_] = Event;
+    Next_ = (Next_ + 1) % Capacity_;
+  }
+
+  // File name of Event.
+  std::string_view file(const TraceEvent &Event) const {
+    return Files_[Event.File];
+  }
+
+  // Number of events currently held.
+  std::size_t size() const { return Events_.size(); }
+
+  // Number of events lost to wrap-around.
+  std::size_t dropped() const { return Total_ - size(); }
+
+  // Calls Callback on every held event, oldest first.
+  template <typename CallbackFn> void forEach(CallbackFn &&Callback) const {
+    const std::size_t Count = size();
+    for (std::size_t i = 0; i < Count; ++i) {
+      Callback(Events_[(Next_ + i) % Count]);
+    }
+  }
+};
+
+// Appends a complete Chrome trace document. Tracks[i] becomes the thread
+// "worker i"; timestamps are microseconds relative to EpochNs.
+void formatChromeTrace(OutputBuffer &Out,
+                       const std::vector<const TraceBuffer *> &Tracks,
+                       std::uint64_t EpochNs);
+
+// Writes the trace document to Path. Prints an error and returns false on
+// failure.
+bool writeChromeTrace(const std::string &Path,
+                      const std::vector<const TraceBuffer *> &Tracks,
+                      std::uint64_t EpochNs);
+
+} // namespace coogle
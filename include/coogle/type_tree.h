@@ -0,0 +1,150 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Structural type patterns over normalized types.
+//
+// A query type may hold "*" wherever a whole type could appear inside a
+// larger one: a template argument (std::vector<*>, std::map<std::string,*>)
+// or under pointer and reference layers ("* *" is any pointer, "const *&"
+// any lvalue reference, since normalization drops const). Such a type is
+// parsed into a small tree of layers:
+//
+//   std::map<std::string,*>&   LValueRef
+//                                └─ Template std::map
+//                                     ├─ Leaf std::string
+//                                     └─ Wildcard
+//
+// and matched against the candidate's normalized string layer by layer.
+// Subtrees without a wildcard are compared as one string, so a pattern
+// costs a string compare per wildcard-free part and a query without
+// patterns keeps the plain comparison.
+//
+// Anything else (function types, arrays, nested names after a template) is
+// one Leaf compared literally, so a "*" there is not a wildcard.
+//
+// A '?' and a capital letter in the same places is a type variable: like
+// "*" it matches any type, but every use of the same letter in a query must
+// match the same type ("?T(?T,?T)", "void(?T*,size_t,?T*)"). The sigil
+// keeps plain names such as "A" or a template parameter "T" literal. The
+// types bound so far live in a TypeBindings table with one slot per letter;
+// a later use compares against its slot, so the first conflict ends the
+// match.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace coogle {
+
+enum class TypeKind : std::uint8_t {
+  Leaf,      // Compared as a whole
+  Wildcard,  // "*": any type
+  Pointer,   // T*
+  LValueRef, // T&
+  RValueRef, // T&&
+  Template,  // Name<Args...>
+  Variable,  // "?T": any type, the same at every use
+};
+
+// Type variables are the sigil followed by one of the letters A to Z.
+constexpr char TypeVariableSigil = '?';
+constexpr std::size_t MaxTypeVariables = 26;
+
+struct TypeNode {
+  TypeKind Kind = TypeKind::Leaf;
+  bool HasWildcard = false; // A Wildcard or Variable in this subtree
+  std::uint8_t Slot = 0;    // TypeBindings slot (Variable only)
+  std::uint32_t Id = 0;     // Dense, in interning order
+  std::string_view Text;    // Normalized spelling of the whole subtree
+  std::string_view Name;    // Template name (Template only)
+  // The pointee or referent, or the template arguments
+  std::vector<const TypeNode *> Children;
+};
+
+// Hash-consing table of type trees. Every distinct normalized spelling is
+// parsed once and identical subtrees are shared, so two types interned in
+// the same table are equal if and only if their nodes are.
+class TypeTable {
+  std::deque<TypeNode> Nodes_;
+  std::deque<std::string> Texts_;
+  std::unordered_map<std::string_view, const TypeNode *> ByText_;
+
+  const TypeNode *internView(std::string_view NormType);
+
+public:
+  TypeTable() = default;
+
+  // Nodes point at each other, so the table only moves
+  TypeTable(const TypeTable &) = delete;
+  TypeTable &operator=(const TypeTable &) = delete;
+  TypeTable(TypeTable &&) = default;
+  TypeTable &operator=(TypeTable &&) = default;
+
+  // Returns the tree for a normalized type (see normalizeType()).
+  const TypeNode *intern(std::string_view NormType);
+
+  // The node with the given TypeNode::Id.
+  const TypeNode &node(std::uint32_t Id) const { return Nodes_[Id]; }
+
+  // Number of distinct subtrees.
+  std::size_t size() const { return Nodes_.size(); }
+};
+
+// Types bound to the type variables of one query while one candidate is
+// matched. Start a fresh table (or reset()) for every candidate.
+class TypeBindings {
+  struct Bound {
+    const char *Data;
+    std::size_t Size;
+  };
+  std::uint32_t Bound_ = 0; // Bit per bound slot
+  std::array<Bound, MaxTypeVariables> Types_; // Only read once bound
+
+public:
+  // Binds Slot to Type, or compares Type with the type bound before.
+  bool bind(std::uint8_t Slot, std::string_view Type) {
+    const std::uint32_t Bit = std::uint32_t(1) << Slot;
+    if (Bound_ & Bit) {
+      return std::string_view(Types_[Slot].Data, Types_[Slot].Size) == Type;
+    }
+    Bound_ |= Bit;
+    Types_[Slot] = {Type.data(), Type.size()};
+    return true;
+  }
+
+  // For backtracking: reset(mark()) drops the bindings made in between.
+  std::uint32_t mark() const { return Bound_; }
+  void reset(std::uint32_t Mark = 0) { Bound_ = Mark; }
+};
+
+// True if NormType is a type variable ("?T").
+bool isTypeVariable(std::string_view NormType);
+
+// True if NormType contains a type variable: "?" and a capital letter that
+// start the type or one of its template arguments.
+bool hasTypeVariable(std::string_view NormType);
+
+// True if NormType may contain a structural wildcard or a type variable: a
+// "*" that starts the type or one of its template arguments, or
+// hasTypeVariable(). Cheap pre-check for isTypeMatch().
+bool hasTypeWildcard(std::string_view NormType);
+
+// Matches a normalized candidate type against a compiled pattern. Type
+// variables are bound in Bindings, or bound afresh for this type alone.
+bool matchesType(const TypeNode &Pattern, std::string_view ActualNorm,
+                 TypeBindings &Bindings);
+bool matchesType(const TypeNode &Pattern, std::string_view ActualNorm);
+
+// Same results as matchesType(), straight from the normalized pattern text
+// and without allocating.
+bool isTypeMatch(std::string_view PatternNorm, std::string_view ActualNorm,
+                 TypeBindings &Bindings);
+bool isTypeMatch(std::string_view PatternNorm, std::string_view ActualNorm);
+
+} // namespace coogle
@@ -0,0 +1,172 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Argument multisets and the --any-order matcher.
+
+#include "coogle/any_order.h"
+
+#include <algorithm>
+
+namespace coogle {
+
+namespace {
+
+// SplitMix64 finalizer: spreads the bits so sums of hashes do not cancel.
+std::uint64_t mix(std::uint64_t Hash) {
+  Hash = (Hash ^ (Hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  Hash = (Hash ^ (Hash >> 27)) * 0x94d049bb133111ebULL;
+  return Hash ^ (Hash >> 31);
+}
+
+// Gives each pattern from Next on a distinct type of Pool. Pool[0, Next)
+// holds the types already taken. Bindings made by a failed choice are
+// dropped before the next one.
+bool assignPatterns(const std::vector<const TypeNode *> &Patterns,
+                    std::size_t Next, std::vector<std::string_view> &Pool,
+                    TypeBindings &Bindings) {
+  if (Next == Patterns.size()) {
+    return true;
+  }
+  const std::uint32_t Mark = Bindings.mark();
+  for (std::size_t i = Next; i < Pool.size(); ++i) {
+    if (matchesType(*Patterns[Next], Pool[i], Bindings)) {
+      std::swap(Pool[Next], Pool[i]);
+      if (assignPatterns(Patterns, Next + 1, Pool, Bindings)) {
+        return true;
+      }
+      std::swap(Pool[Next], Pool[i]);
+    }
+    Bindings.reset(Mark);
+  }
+  return false;
+}
+
+// Reference search: query argument Next onwards against unused arguments.
+bool assignArgs(const Signature &Query, const Signature &Actual,
+                std::size_t Next, std::vector<bool> &Used,
+                TypeBindings &Bindings) {
+  if (Next == Query.ArgTypesNorm.size()) {
+    return true;
+  }
+  const std::uint32_t Mark = Bindings.mark();
+  for (std::size_t i = 0; i < Actual.ArgTypesNorm.size(); ++i) {
+    if (Used[i]) {
+      continue;
+    }
+    if (isTypeMatch(Query.ArgTypesNorm[Next], Actual.ArgTypesNorm[i],
+                    Bindings)) {
+      Used[i] = true;
+      if (assignArgs(Query, Actual, Next + 1, Used, Bindings)) {
+        return true;
+      }
+      Used[i] = false;
+    }
+    Bindings.reset(Mark);
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+std::uint64_t typeHash(std::string_view NormType) {
+  // FNV-1a
+  std::uint64_t Hash = 0xcbf29ce484222325ULL;
+  for (const char C : NormType) {
+    Hash = (Hash ^ static_cast<unsigned char>(C)) * 0x100000001b3ULL;
+  }
+  return mix(Hash);
+}
+
+std::uint64_t argMultisetHash(span<std::string_view> ArgTypesNorm) {
+  std::uint64_t Hash = 0;
+  for (std::string_view Type : ArgTypesNorm) {
+    Hash += typeHash(Type);
+  }
+  return Hash;
+}
+
+void buildArgMultiset(TypeTable &Types, span<std::string_view> ArgTypesNorm,
+                      ArgMultiset &Out) {
+  Out.Hash = argMultisetHash(ArgTypesNorm);
+  Out.Ids.clear();
+  for (std::string_view Type : ArgTypesNorm) {
+    Out.Ids.push_back(Types.intern(Type)->Id);
+  }
+  std::sort(Out.Ids.begin(), Out.Ids.end());
+}
+
+bool isAnyOrderMatch(const Signature &Query, const Signature &Actual) {
+  const std::size_t ActualArity = Actual.ArgTypesNorm.size();
+  if (!isArityMatch(Query.ArgTypesNorm.size(), Query.VariadicTail,
+                    ActualArity)) {
+    return false;
+  }
+  TypeBindings Bindings;
+  if (!isWildcardType(Query.RetType) &&
+      !isTypeMatch(Query.RetTypeNorm, Actual.RetTypeNorm, Bindings)) {
+    return false;
+  }
+  std::vector<bool> Used(ActualArity);
+  return assignArgs(Query, Actual, 0, Used, Bindings);
+}
+
+AnyOrderQuery::AnyOrderQuery(const Signature &Query)
+    : Arity_(Query.ArgTypesNorm.size()), VariadicTail_(Query.VariadicTail) {
+  if (!isWildcardType(Query.RetType)) {
+    RetType_ = Types_.intern(Query.RetTypeNorm);
+  }
+  std::vector<std::string_view> Required;
+  for (std::string_view Type : Query.ArgTypesNorm) {
+    const TypeNode *Node = Types_.intern(Type);
+    if (!Node->HasWildcard) {
+      Required.push_back(Type);
+    } else if (Node->Kind != TypeKind::Wildcard) {
+      Patterns_.push_back(Node);
+    }
+  }
+  buildArgMultiset(Types_, span<std::string_view>(Required.data(),
+                                                  Required.size()),
+                   Required_);
+  Closed_ = !VariadicTail_ && Required.size() == Arity_;
+}
+
+bool AnyOrderQuery::matches(const Signature &Actual) {
+  const span<std::string_view> Args = Actual.ArgTypesNorm;
+  if (!isArityMatch(Arity_, VariadicTail_, Args.size())) {
+    return false;
+  }
+  TypeBindings Bindings;
+  if (RetType_ && !matchesType(*RetType_, Actual.RetTypeNorm, Bindings)) {
+    return false;
+  }
+  // Rejects most candidates of the right arity without touching the table
+  if (Closed_ && argMultisetHash(Args) != Required_.Hash) {
+    return false;
+  }
+
+  CandidateIds_.clear();
+  for (std::string_view Type : Args) {
+    CandidateIds_.push_back(Types_.intern(Type)->Id);
+  }
+  std::sort(CandidateIds_.begin(), CandidateIds_.end());
+
+  // Both sorted: every required ID must be met on the way, and whatever
+  // is skipped is left for the patterns and wildcards
+  const std::vector<std::uint32_t> &Ids = Required_.Ids;
+  std::size_t Next = 0;
+  Leftover_.clear();
+  for (const std::uint32_t Id : CandidateIds_) {
+    if (Next < Ids.size() && Ids[Next] == Id) {
+      ++Next;
+    } else if (Next < Ids.size() && Ids[Next] < Id) {
+      return false;
+    } else if (!Patterns_.empty()) {
+      Leftover_.push_back(Types_.node(Id).Text);
+    }
+  }
+  if (Next != Ids.size()) {
+    return false;
+  }
+  return assignPatterns(Patterns_, 0, Leftover_, Bindings);
+}
+
+} // namespace coogle
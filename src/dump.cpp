@@ -0,0 +1,153 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// NDJSON and binary record encodings for `coogle dump`.
+
+#include "coogle/dump.h"
+
+namespace coogle {
+
+namespace {
+constexpr std::uint8_t KindFunction = 0;
+constexpr std::uint8_t KindMethod = 1;
+constexpr std::uint8_t FlagVariadic = 1;
+
+void appendU8(OutputBuffer &Out, std::uint8_t Value) {
+  Out.append(static_cast<char>(Value));
+}
+
+void appendU16(OutputBuffer &Out, std::uint16_t Value) {
+  const char Bytes[2] = {static_cast<char>(Value & 0xFF),
+                         static_cast<char>((Value >> 8) & 0xFF)};
+  Out.append(std::string_view(Bytes, sizeof(Bytes)));
+}
+
+void appendU32(OutputBuffer &Out, std::uint32_t Value) {
+  const char Bytes[4] = {static_cast<char>(Value & 0xFF),
+                         static_cast<char>((Value >> 8) & 0xFF),
+                         static_cast<char>((Value >> 16) & 0xFF),
+                         static_cast<char>((Value >> 24) & 0xFF)};
+  Out.append(std::string_view(Bytes, sizeof(Bytes)));
+}
+
+void appendStr(OutputBuffer &Out, std::string_view Str) {
+  appendU32(Out, static_cast<std::uint32_t>(Str.size()));
+  Out.append(Str);
+}
+
+// Little-endian reader over a bounded byte range.
+class Reader {
+  std::string_view In_;
+  bool Ok_ = true;
+
+public:
+  explicit Reader(std::string_view In) : In_(In) {}
+
+  std::uint32_t read(std::size_t Bytes) {
+    if (!Ok_ || In_.size() < Bytes) {
+      Ok_ = false;
+      return 0;
+    }
+    std::uint32_t Value = 0;
+    for (std::size_t i = 0; i < Bytes; ++i) {
+      Value |= static_cast<std::uint32_t>(static_cast<unsigned char>(In_[i]))
+               << (8 * i);
+    }
+    In_.remove_prefix(Bytes);
+    return Value;
+  }
+
+  std::string readStr() {
+    const std::uint32_t Size = read(4);
+    if (!Ok_ || In_.size() < Size) {
+      Ok_ = false;
+      return {};
+    }
+    std::string Str(In_.substr(0, Size));
+    In_.remove_prefix(Size);
+    return Str;
+  }
+
+  bool ok() const { return Ok_; }
+  bool atEnd() const { return In_.empty(); }
+};
+} // anonymous namespace
+
+void formatDumpJson(OutputBuffer &Out, const MatchRecord &Record) {
+  Out.append('{');
+  formatMatchJsonFields(Out, Record);
+  const Signature &Sig = *Record.Sig;
+  Out.append(",\"return\":");
+  appendJsonString(Out, Sig.RetType);
+  Out.append(",\"args\":[");
+  for (size_t i = 0; i < Sig.ArgTypes.size(); ++i) {
+    if (i > 0) {
+      Out.append(',');
+    }
+    appendJsonString(Out, Sig.ArgTypes[i]);
+  }
+  Out.append(']');
+  if (Sig.VariadicTail) {
+    Out.append(",\"variadic\":true");
+  }
+  Out.append('}');
+}
+
+void encodeDumpRecord(OutputBuffer &Out, const MatchRecord &Record) {
+  const Signature &Sig = *Record.Sig;
+
+  // Fixed fields plus a length prefix for every string
+  std::size_t PayloadSize = 4 + 4 + 1 + 1 + 2;
+  PayloadSize += 4 + Record.FileName.size();
+  PayloadSize += 4 + Record.FunctionName.size();
+  PayloadSize += 4 + Sig.RetType.size();
+  for (std::string_view Arg : Sig.ArgTypes) {
+    PayloadSize += 4 + Arg.size();
+  }
+
+  appendU32(Out, static_cast<std::uint32_t>(PayloadSize));
+  appendU32(Out, Record.Line);
+  appendU32(Out, Record.Column);
+  appendU8(Out, Record.Kind == "method" ? KindMethod : KindFunction);
+  appendU8(Out, Sig.VariadicTail ? FlagVariadic : 0);
+  appendU16(Out, static_cast<std::uint16_t>(Sig.ArgTypes.size()));
+  appendStr(Out, Record.FileName);
+  appendStr(Out, Record.FunctionName);
+  appendStr(Out, Sig.RetType);
+  for (std::string_view Arg : Sig.ArgTypes) {
+    appendStr(Out, Arg);
+  }
+}
+
+std::optional<DumpRecord> decodeDumpRecord(std::string_view &In) {
+  Reader Header(In);
+  const std::uint32_t PayloadSize = Header.read(4);
+  if (!Header.ok() || In.size() - 4 < PayloadSize) {
+    return std::nullopt;
+  }
+
+  Reader Payload(In.substr(4, PayloadSize));
+  DumpRecord Record;
+  Record.Line = Payload.read(4);
+  Record.Column = Payload.read(4);
+  const std::uint32_t Kind = Payload.read(1);
+  const std::uint32_t Flags = Payload.read(1);
+  const std::uint32_t ArgCount = Payload.read(2);
+  Record.FileName = Payload.readStr();
+  Record.FunctionName = Payload.readStr();
+  Record.RetType = Payload.readStr();
+  for (std::uint32_t i = 0; i < ArgCount && Payload.ok(); ++i) {
+    Record.ArgTypes.push_back(Payload.readStr());
+  }
+
+  if (!Payload.ok() || !Payload.atEnd() || Kind > KindMethod ||
+      (Flags & ~FlagVariadic) != 0) {
+    return std::nullopt;
+  }
+  Record.Kind = Kind == KindMethod ? "method" : "function";
+  Record.Variadic = (Flags & FlagVariadic) != 0;
+
+  In.remove_prefix(4 + PayloadSize);
+  return Record;
+}
+
+} // namespace coogle
@@ -0,0 +1,194 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Edit distances and the --fuzzy-types matcher.
+
+#include "coogle/fuzzy.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace coogle {
+
+namespace {
+
+// Cache entry of a candidate type not scored yet.
+constexpr std::uint8_t NotScored = 0xff;
+
+} // anonymous namespace
+
+unsigned fuzzyEditLimit(std::string_view QueryType, unsigned MaxEdits) {
+  const std::size_t Edits = QueryType.size() / FuzzyCharsPerEdit;
+  return static_cast<unsigned>(std::min<std::size_t>(Edits, MaxEdits));
+}
+
+unsigned editDistance(std::string_view A, std::string_view B) {
+  // One row of the table, B along it
+  std::vector<unsigned> Row(B.size() + 1);
+  std::iota(Row.begin(), Row.end(), 0u);
+  for (std::size_t i = 1; i <= A.size(); ++i) {
+    unsigned Diagonal = Row[0];
+    Row[0] = static_cast<unsigned>(i);
+    for (std::size_t j = 1; j <= B.size(); ++j) {
+      const unsigned Above = Row[j];
+      Row[j] = std::min({Above + 1, Row[j - 1] + 1,
+                         Diagonal + (A[i - 1] == B[j - 1] ? 0u : 1u)});
+      Diagonal = Above;
+    }
+  }
+  return Row.back();
+}
+
+FuzzyPattern::FuzzyPattern(std::string_view Pattern) : Pattern_(Pattern) {
+  for (std::size_t i = 0; i < Pattern.size() && i < 64; ++i) {
+    Peq_[static_cast<unsigned char>(Pattern[i])] |= std::uint64_t(1) << i;
+  }
+}
+
+unsigned FuzzyPattern::distance(std::string_view Text, unsigned Limit) const {
+  const std::size_t M = Pattern_.size();
+  const std::size_t N = Text.size();
+  const std::size_t Gap = M > N ? M - N : N - M;
+  if (Gap > Limit) {
+    return Limit + 1;
+  }
+  if (M == 0) {
+    return static_cast<unsigned>(N);
+  }
+  if (M > 64) {
+    return editDistance(Pattern_, Text);
+  }
+
+  // One column of the table at a time, as bit vectors of the vertical
+  // deltas (+1 in Pv, -1 in Mv) down the pattern. Score is the bottom
+  // cell. Hyyrö's formulation of Myers' algorithm.
+  const std::uint64_t Last = std::uint64_t(1) << (M - 1);
+  std::uint64_t Pv = ~std::uint64_t(0);
+  std::uint64_t Mv = 0;
+  std::size_t Score = M;
+  for (std::size_t j = 0; j < N; ++j) {
+    const std::uint64_t Eq = Peq_[static_cast<unsigned char>(Text[j])];
+    const std::uint64_t Xv = Eq | Mv;
+    const std::uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+    std::uint64_t Ph = Mv | ~(Xh | Pv);
+    std::uint64_t Mh = Pv & Xh;
+    if (Ph & Last) {
+      ++Score;
+    } else if (Mh & Last) {
+      --Score;
+    }
+    // The top row is the distance from the empty pattern: +1 per column
+    Ph = (Ph << 1) | 1;
+    Mh <<= 1;
+    Pv = Mh | ~(Xv | Ph);
+    Mv = Ph & Xv;
+    // Each remaining column lowers the score by at most one
+    if (Score > Limit + (N - j - 1)) {
+      return Limit + 1;
+    }
+  }
+  return static_cast<unsigned>(Score);
+}
+
+bool isFuzzyMatch(const Signature &Query, const Signature &Actual,
+                  unsigned MaxEdits) {
+  TypeBindings Bindings;
+  auto TypeMatches = [&](std::string_view Expected, std::string_view Type) {
+    if (hasTypeWildcard(Expected)) {
+      return isTypeMatch(Expected, Type, Bindings);
+    }
+    return editDistance(Expected, Type) <= fuzzyEditLimit(Expected, MaxEdits);
+  };
+
+  const std::size_t Arity = Query.ArgTypesNorm.size();
+  if (!isArityMatch(Arity, Query.VariadicTail, Actual.ArgTypesNorm.size())) {
+    return false;
+  }
+  if (!isWildcardType(Query.RetType) &&
+      !TypeMatches(Query.RetTypeNorm, Actual.RetTypeNorm)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < Arity; ++i) {
+    if (!isWildcardType(Query.ArgTypes[i]) &&
+        !TypeMatches(Query.ArgTypesNorm[i], Actual.ArgTypesNorm[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+FuzzyQuery::FuzzyQuery(const Signature &Query, unsigned MaxEdits)
+    : Arity_(Query.ArgTypesNorm.size()), VariadicTail_(Query.VariadicTail) {
+  MaxEdits = std::min(MaxEdits, MaxFuzzyEdits);
+  auto Compile = [&](std::string_view Original, std::string_view Norm) {
+    TypeCheck Check;
+    Check.Expected = Norm;
+    if (isWildcardType(Original)) {
+      Check.Pattern = Types_.intern("*");
+    } else if (hasTypeWildcard(Norm)) {
+      Check.Pattern = Types_.intern(Norm);
+    } else {
+      Check.Limit = fuzzyEditLimit(Norm, MaxEdits);
+    }
+    if (Check.Limit > 0) {
+      Check.Fuzzy = Patterns_.size();
+      Patterns_.emplace_back(Norm);
+    }
+    Checks_.push_back(std::move(Check));
+  };
+  Compile(Query.RetType, Query.RetTypeNorm);
+  for (std::size_t i = 0; i < Arity_; ++i) {
+    Compile(Query.ArgTypes[i], Query.ArgTypesNorm[i]);
+  }
+}
+
+bool FuzzyQuery::checkType(TypeCheck &Check, std::string_view ActualNorm,
+                           TypeBindings &Bindings) {
+  if (Check.Pattern) {
+    return matchesType(*Check.Pattern, ActualNorm, Bindings);
+  }
+  if (ActualNorm == Check.Expected) {
+    return true;
+  }
+  if (Check.Limit == 0) {
+    return false;
+  }
+  // Too far apart in length to be within reach: no need to intern it
+  const std::size_t Size = Check.Expected.size();
+  const std::size_t Gap =
+      Size > ActualNorm.size() ? Size - ActualNorm.size()
+                               : ActualNorm.size() - Size;
+  if (Gap > Check.Limit) {
+    return false;
+  }
+
+  const std::uint32_t Id = Types_.intern(ActualNorm)->Id;
+  if (Id >= Check.Distances.size()) {
+    Check.Distances.resize(Types_.size(), NotScored);
+  }
+  std::uint8_t &Distance = Check.Distances[Id];
+  if (Distance == NotScored) {
+    Distance = static_cast<std::uint8_t>(
+        std::min(Patterns_[Check.Fuzzy].distance(ActualNorm, Check.Limit),
+                 Check.Limit + 1));
+  }
+  return Distance <= Check.Limit;
+}
+
+bool FuzzyQuery::matches(const Signature &Actual) {
+  const span<std::string_view> Args = Actual.ArgTypesNorm;
+  if (!isArityMatch(Arity_, VariadicTail_, Args.size())) {
+    return false;
+  }
+  TypeBindings Bindings;
+  if (!checkType(Checks_[0], Actual.RetTypeNorm, Bindings)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < Arity_; ++i) {
+    if (!checkType(Checks_[i + 1], Args[i], Bindings)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace coogle
@@ -4,252 +4,140 @@
 // Parses source files using libclang and matches function signatures
 // with wildcard support.
 
-#include "coogle/arena.h"
-#include "coogle/clang_raii.h"
 #include "coogle/colors.h"
+#include "coogle/dump.h"
+#include "coogle/fuzzy.h"
 #include "coogle/includes.h"
+#include "coogle/instrument.h"
+#include "coogle/output.h"
 #include "coogle/parser.h"
+#include "coogle/perf.h"
+#include "coogle/profile.h"
+#include "coogle/rank.h"
+#include "coogle/search.h"
+#include "coogle/stats.h"
+#include "coogle/trace.h"
 
 #include <algorithm>
-#include <array>
 #include <cassert>
-#include <clang-c/Index.h>
+#include <charconv>
+#include <cstdlib>
 #include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <fmt/core.h>
-#include <future>
 #include <iostream>
-#include <numeric>
+#include <optional>
 #include <string>
 #include <string_view>
-#include <thread>
+#include <unistd.h>
 #include <vector>
 
 namespace fs = std::filesystem;
 namespace colors = coogle::colors;
 
-constexpr int ExpectedArgCount = 3;
-
-// Supported C/C++ file extensions
-constexpr std::array<std::string_view, 8> CppExtensions = {
-    ".c", ".cpp", ".cc", ".cxx", ".h", ".hpp", ".hh", ".hxx"};
-
-// Match result with zero-allocation string_view references.
-struct Match {
-  std::string_view FunctionName; // 16 bytes
-  std::string_view SignatureStr; // 16 bytes
-  unsigned int Line;             // 4 bytes
-};
-
-// Parse results for a single file (flat structure).
-struct ParseResults {
-  std::string_view FileName;
-  std::vector<Match> Matches;
-};
-
-// Result of a processing task (thread-local storage)
-struct TaskResult {
-  coogle::SignatureStorage Storage; // Owns the strings in Results
-  std::vector<ParseResults> Results;
-  std::vector<std::string> Failures;
-
-  // Enable move
-  TaskResult() = default;
-  TaskResult(TaskResult &&) = default;
-  TaskResult &operator=(TaskResult &&) = default;
-  TaskResult(const TaskResult &) = delete;
-  TaskResult &operator=(const TaskResult &) = delete;
-};
-
-// Visitor context with arena storage.
-struct VisitorContext {
-  coogle::Signature *TargetSig;
-  std::string CurrentFile;
-  std::vector<ParseResults> *Results;
-  coogle::SignatureStorage *Storage; // Arena for match strings
-};
-
-// Find all C/C++ source files in the given path
-std::vector<std::string> findSourceFiles(const fs::path &Path) {
-  std::vector<std::string> Files;
-
-  if (fs::is_regular_file(Path)) {
-    // Single file mode
-    Files.push_back(Path.string());
-  } else if (fs::is_directory(Path)) {
-    // Directory mode - recursive search
-    for (const auto &Entry : fs::recursive_directory_iterator(
-             Path, fs::directory_options::skip_permission_denied)) {
-      if (Entry.is_regular_file()) {
-        auto Ext = Entry.path().extension().string();
-        if (std::find(CppExtensions.begin(), CppExtensions.end(), Ext) !=
-            CppExtensions.end()) {
-          Files.push_back(Entry.path().string());
-        }
-      }
-    }
-  }
-
-  return Files;
-}
-
-CXChildVisitResult visitor(CXCursor Cursor, [[maybe_unused]] CXCursor Parent,
-                           CXClientData ClientData) {
-  auto *Ctx = static_cast<VisitorContext *>(ClientData);
-
-  CXCursorKind Kind = clang_getCursorKind(Cursor);
-  if (Kind == CXCursor_FunctionDecl || Kind == CXCursor_CXXMethod) {
-    // Build actual signature from libclang
-    coogle::SignatureStorage ActualStorage;
-
-    // Get return type (canonicalized for semantic type matching)
-    CXType RetType = clang_getCursorResultType(Cursor);
-    assert(RetType.kind != CXType_Invalid &&
-           "Invalid return type obtained from libclang");
-    CXType CanonicalRetType = clang_getCanonicalType(RetType);
-    CXString RetSpelling = clang_getTypeSpelling(CanonicalRetType);
-    std::string_view RetTypeSV = clang_getCString(RetSpelling);
-    std::string_view RetTypeInterned = ActualStorage.internString(RetTypeSV);
-    std::string_view RetTypeNorm =
-        coogle::normalizeType(ActualStorage.arena(), RetTypeInterned);
-    clang_disposeString(RetSpelling);
-
-    // Get arguments
-    int NumArgs = clang_Cursor_getNumArguments(Cursor);
-    ActualStorage.reserveArgs(NumArgs);
-
-    for (int ArgIdx = 0; ArgIdx < NumArgs; ++ArgIdx) {
-      CXCursor ArgCursor = clang_Cursor_getArgument(Cursor, ArgIdx);
-      if (clang_equalCursors(ArgCursor, clang_getNullCursor())) {
-        continue; // Skip invalid arguments (e.g. variadic args sometimes cause
-                  // issues)
-      }
-      CXType ArgType = clang_getCursorType(ArgCursor);
-      assert(ArgType.kind != CXType_Invalid &&
-             "Invalid argument type obtained from libclang");
-      CXType CanonicalArgType = clang_getCanonicalType(ArgType);
-      CXString TypeSpelling = clang_getTypeSpelling(CanonicalArgType);
-
-      std::string_view ArgTypeSV = clang_getCString(TypeSpelling);
-      std::string_view ArgTypeInterned = ActualStorage.internString(ArgTypeSV);
-      std::string_view ArgTypeNorm =
-          coogle::normalizeType(ActualStorage.arena(), ArgTypeInterned);
-      ActualStorage.addArg(ArgTypeInterned, ArgTypeNorm);
-
-      clang_disposeString(TypeSpelling);
-    }
-
-    // Build signature struct
-    coogle::Signature Actual;
-    Actual.RetType = RetTypeInterned;
-    Actual.RetTypeNorm = RetTypeNorm;
-    Actual.ArgTypes = ActualStorage.getArgs();
-    Actual.ArgTypesNorm = ActualStorage.getArgsNorm();
-
-    // Check if signature matches
-    if (coogle::isSignatureMatch(*Ctx->TargetSig, Actual)) {
-      // Get function location
-      CXSourceLocation Location = clang_getCursorLocation(Cursor);
-
-      // Skip system headers (double protection)
-      if (clang_Location_isInSystemHeader(Location)) {
-        return CXChildVisit_Continue;
-      }
-
-      CXFile File;
-      unsigned Line = 0;
-      clang_getSpellingLocation(Location, &File, &Line, nullptr, nullptr);
-
-      CXString FileName = clang_getFileName(File);
-      const char *FileNameStr = clang_getCString(FileName);
-
-      // Only show results from the file we're explicitly parsing
-      if (FileNameStr && Ctx->CurrentFile == FileNameStr) {
-        // Get function name
-        CXString FuncName = clang_getCursorSpelling(Cursor);
-        const char *FuncNameStr = clang_getCString(FuncName);
-
-        // Intern strings into the shared storage (immediate copy to arena)
-        std::string_view FuncNameView = Ctx->Storage->internString(FuncNameStr);
-        std::string SignatureStr = coogle::toString(Actual);
-        std::string_view SignatureView =
-            Ctx->Storage->internString(SignatureStr);
-
-        // Optimization: Since we process files sequentially, we only need to
-        // check the last entry
-        bool IsNewFile = Ctx->Results->empty() ||
-                         Ctx->Results->back().FileName != Ctx->CurrentFile;
-
-        if (IsNewFile) {
-          Ctx->Results->push_back(
-              {Ctx->Storage->internString(Ctx->CurrentFile), {}});
-        }
-
-        Ctx->Results->back().Matches.push_back(
-            {FuncNameView, SignatureView, Line});
-
-        clang_disposeString(FuncName);
-      }
-
-      clang_disposeString(FileName);
-    }
-  }
-
-  return CXChildVisit_Recurse;
-}
-
-TaskResult processFiles(const std::vector<std::string> &Files,
-                        const coogle::Signature &TargetSig,
-                        const std::vector<const char *> &ClangArgs) {
-  TaskResult Result;
-
-  // Each thread needs its own index to avoid contention
-  CXIndexRAII Index;
-  if (!Index.isValid()) {
-    std::cerr << "Error creating Clang index in worker thread\n";
-    return Result;
-  }
-
-  for (const auto &Filename : Files) {
-    // Performance optimization:
-    // - SkipFunctionBodies: We only need signatures
-    // - Incomplete: Allow parsing errors (missing headers)
-    // - SingleFileParse: Don't process included headers (we don't want them
-    // anyway)
-    // - LimitSkipFunctionBodiesToPreamble: Further optim for skipping bodies
-    unsigned Options =
-        CXTranslationUnit_SkipFunctionBodies | CXTranslationUnit_Incomplete |
-        CXTranslationUnit_SingleFileParse | CXTranslationUnit_KeepGoing;
-
-    CXTranslationUnitRAII TU(
-        clang_parseTranslationUnit(Index, Filename.c_str(), ClangArgs.data(),
-                                   ClangArgs.size(), nullptr, 0, Options));
-
-    if (!TU.isValid()) {
-      Result.Failures.push_back(Filename);
-      continue;
-    }
-
-    VisitorContext Ctx{const_cast<coogle::Signature *>(&TargetSig), Filename,
-                       &Result.Results, &Result.Storage};
-    CXCursor RootCursor = clang_getTranslationUnitCursor(TU);
-    clang_visitChildren(RootCursor, visitor, &Ctx);
+constexpr std::size_t SearchPositionalArgs = 2;
+constexpr std::size_t DumpPositionalArgs = 1;
+
+// Top-level command.
+//   Search: match functions against a signature (default)
+//   Dump:   export every extracted signature (`coogle dump`)
+enum class Command { Search, Dump };
+
+// Command-line options.
+struct CliOptions {
+  Command Cmd = Command::Search;
+  std::string InputPath;
+  std::string Query;
+  coogle::ColorMode Color = coogle::ColorMode::Auto;
+  std::optional<coogle::OutputFormat> Format; // Defaults depend on Cmd
+  coogle::ResultMode Mode = coogle::ResultMode::List;
+  bool Stream = false;
+  bool Stats = false;
+  bool PerfCounters = false; // --perf-counters (implies Stats)
+  std::string TracePath; // Empty unless --trace
+  std::optional<std::size_t> ProfileTopN; // --profile-files[=N]
+  std::string SaveProfilePath;            // --save-profile=FILE
+  std::string LoadProfilePath;            // --load-profile=FILE
+  std::optional<double> SkipSlowerThanMs; // --skip-slower-than=MS
+  std::optional<std::size_t> RankTopK;    // --rank[=K]
+  bool AnyOrder = false;                  // --any-order
+  unsigned FuzzyEdits = 0;                // --fuzzy-types[=N]
+  bool ShortNames = false;                // --short-names
+
+  // Whether workers must record per-file costs.
+  bool collectProfile() const {
+    return ProfileTopN.has_value() || !SaveProfilePath.empty();
   }
-
-  return Result;
-}
+};
 
 void printHelp(const char *ProgramName) {
   std::cout << fmt::format("Coogle - C++ Function Signature Search Tool\n\n");
   std::cout << fmt::format("Usage:\n");
   std::cout << fmt::format(
-      "  {} <file_or_directory> \"<function_signature>\"\n", ProgramName);
+      "  {} [options] <file_or_directory> \"<function_signature>\"\n",
+      ProgramName);
+  std::cout << fmt::format(
+      "  {} dump [--format=ndjson|json|binary] <file_or_directory>\n",
+      ProgramName);
   std::cout << fmt::format("  {} --help\n\n", ProgramName);
+  std::cout << fmt::format("Commands:\n");
+  std::cout << fmt::format(
+      "  dump                    Export every function signature (default "
+      "format: ndjson)\n\n");
   std::cout << fmt::format("Arguments:\n");
   std::cout << fmt::format(
       "  <file_or_directory>     C/C++ source file or directory to search\n");
   std::cout << fmt::format(
       "  <function_signature>    Function signature pattern to match\n\n");
+  std::cout << fmt::format("Options:\n");
+  std::cout << fmt::format(
+      "  --color=WHEN            Colorize output: auto (default), always, "
+      "never\n");
+  std::cout << fmt::format(
+      "  --format=FORMAT         Output format: text (default), json, "
+      "ndjson\n");
+  std::cout << fmt::format(
+      "  --stream                Write results after every file instead of "
+      "batching\n");
+  std::cout << fmt::format(
+      "  -c, --count             Print only the number of matches\n");
+  std::cout << fmt::format(
+      "  -l, --files-with-matches\n"
+      "                          Print only the names of files with "
+      "matches\n");
+  std::cout << fmt::format(
+      "  --any-order             Match the arguments in any order\n");
+  std::cout << fmt::format(
+      "  --fuzzy-types[=N]       Allow up to N typos per type name (default "
+      "{})\n",
+      coogle::DefaultFuzzyEdits);
+  std::cout << fmt::format(
+      "  --short-names           Match type names in any namespace or "
+      "class\n");
+  std::cout << fmt::format(
+      "  --rank[=K]              Print the K closest functions, best first "
+      "(default {})\n",
+      coogle::DefaultRankTopK);
+  std::cout << fmt::format(
+      "  --stats                 Print per-phase timings and resource usage "
+      "to stderr\n");
+  std::cout << fmt::format(
+      "  --perf-counters         Add hardware counters to --stats "
+      "(Linux)\n");
+  std::cout << fmt::format(
+      "  --trace FILE            Write a Chrome trace of worker activity to "
+      "FILE\n");
+  std::cout << fmt::format(
+      "  --profile-files[=N]     Print the N slowest files (default {})\n",
+      coogle::DefaultProfileTopN);
+  std::cout << fmt::format(
+      "  --save-profile=FILE     Save per-file costs for later runs\n");
+  std::cout << fmt::format(
+      "  --load-profile=FILE     Balance workers by the costs saved in FILE\n");
+  std::cout << fmt::format(
+      "  --skip-slower-than=MS   With --load-profile, skip files that took "
+      "longer\n\n");
   std::cout << fmt::format("Signature Format:\n");
   std::cout << fmt::format("  return_type(arg1_type, arg2_type, ...)\n\n");
   std::cout << fmt::format("Wildcards:\n");
@@ -257,7 +145,21 @@ void printHelp(const char *ProgramName) {
   std::cout << fmt::format(
       "  Example: \"void(*, int)\" matches any function returning void\n");
   std::cout << fmt::format(
-      "           with any first argument and int second argument\n\n");
+      "           with any first argument and int second argument\n");
+  std::cout << fmt::format("  Use '*' as the return type to match any\n");
+  std::cout << fmt::format(
+      "  End with '...' (or '..') to match zero or more further arguments\n");
+  std::cout << fmt::format(
+      "  Example: \"*(const char *, ...)\" matches printf-like functions\n");
+  std::cout << fmt::format(
+      "  Use '*' inside a type for any template argument or pointee\n");
+  std::cout << fmt::format(
+      "  Example: \"void(std::vector<*> &, * *)\" takes a vector of\n");
+  std::cout << fmt::format("           anything and any pointer\n");
+  std::cout << fmt::format(
+      "  Use '?' and a capital letter for a type used more than once\n");
+  std::cout << fmt::format(
+      "  Example: \"?T(?T, ?T)\" takes and returns one type\n\n");
   std::cout << fmt::format("Examples:\n");
   std::cout << fmt::format("  {} example.c \"int(int, char *)\"\n",
                            ProgramName);
@@ -276,6 +178,415 @@ void printHelp(const char *ProgramName) {
   std::cout << fmt::format("  • Wildcard argument matching\n\n");
 }
 
+void printUsage(const char *ProgramName) {
+  std::cerr << "Usage:\n";
+  std::cerr << fmt::format(
+      "  {} [options] <file_or_directory> \"<function_signature>\"\n",
+      ProgramName);
+  std::cerr << fmt::format(
+      "  {} dump [--format=ndjson|json|binary] <file_or_directory>\n",
+      ProgramName);
+  std::cerr << fmt::format("  {} --help\n\n", ProgramName);
+}
+
+// Parses command-line options. Prints a diagnostic and returns nullopt on
+// malformed input.
+std::optional<CliOptions> parseArgs(int Argc, char *Argv[]) {
+  CliOptions Opts;
+  std::vector<std::string_view> Positional;
+
+  int First = 1;
+  if (Argc > 1 && std::string_view(Argv[1]) == "dump") {
+    Opts.Cmd = Command::Dump;
+    First = 2;
+  }
+
+  for (int i = First; i < Argc; ++i) {
+    std::string_view Arg = Argv[i];
+    if (Arg.substr(0, 8) == "--color=") {
+      auto Mode = coogle::parseColorMode(Arg.substr(8));
+      if (!Mode) {
+        std::cerr << fmt::format(
+            "✖ Error: Invalid --color value '{}' (expected auto, always "
+            "or never)\n",
+            Arg.substr(8));
+        return std::nullopt;
+      }
+      Opts.Color = *Mode;
+    } else if (Arg.substr(0, 9) == "--format=") {
+      Opts.Format = coogle::parseOutputFormat(Arg.substr(9));
+      const bool Valid =
+          Opts.Format && (Opts.Cmd == Command::Dump
+                              ? *Opts.Format != coogle::OutputFormat::Text
+                              : *Opts.Format != coogle::OutputFormat::Binary);
+      if (!Valid) {
+        std::cerr << fmt::format(
+            "✖ Error: Invalid --format value '{}' (expected {})\n",
+            Arg.substr(9),
+            Opts.Cmd == Command::Dump ? "ndjson, json or binary"
+                                      : "text, json or ndjson");
+        return std::nullopt;
+      }
+    } else if (Arg == "--stream") {
+      Opts.Stream = true;
+    } else if (Arg == "--profile-files" ||
+               Arg.substr(0, 16) == "--profile-files=") {
+      std::size_t N = coogle::DefaultProfileTopN;
+      if (Arg.size() > 16) {
+        std::string_view Value = Arg.substr(16);
+        auto [Ptr, Ec] =
+            std::from_chars(Value.data(), Value.data() + Value.size(), N);
+        if (Ec != std::errc() || Ptr != Value.data() + Value.size()) {
+          std::cerr << fmt::format(
+              "✖ Error: Invalid --profile-files value '{}'\n", Value);
+          return std::nullopt;
+        }
+      }
+      Opts.ProfileTopN = N;
+    } else if (Arg == "--any-order") {
+      Opts.AnyOrder = true;
+    } else if (Arg == "--fuzzy-types" ||
+               Arg.substr(0, 14) == "--fuzzy-types=") {
+      unsigned N = coogle::DefaultFuzzyEdits;
+      if (Arg.size() > 14) {
+        std::string_view Value = Arg.substr(14);
+        auto [Ptr, Ec] =
+            std::from_chars(Value.data(), Value.data() + Value.size(), N);
+        if (Ec != std::errc() || Ptr != Value.data() + Value.size() ||
+            N == 0 || N > coogle::MaxFuzzyEdits) {
+          std::cerr << fmt::format("✖ Error: Invalid --fuzzy-types value "
+                                   "'{}' (expected 1 to {})\n",
+                                   Value, coogle::MaxFuzzyEdits);
+          return std::nullopt;
+        }
+      }
+      Opts.FuzzyEdits = N;
+    } else if (Arg == "--short-names") {
+      Opts.ShortNames = true;
+    } else if (Arg == "--rank" || Arg.substr(0, 7) == "--rank=") {
+      std::size_t K = coogle::DefaultRankTopK;
+      if (Arg.size() > 7) {
+        std::string_view Value = Arg.substr(7);
+        auto [Ptr, Ec] =
+            std::from_chars(Value.data(), Value.data() + Value.size(), K);
+        if (Ec != std::errc() || Ptr != Value.data() + Value.size() ||
+            K == 0 || K > coogle::MaxRankTopK) {
+          std::cerr << fmt::format("✖ Error: Invalid --rank value '{}' "
+                                   "(expected 1 to {})\n",
+                                   Value, coogle::MaxRankTopK);
+          return std::nullopt;
+        }
+      }
+      Opts.RankTopK = K;
+    } else if (Arg.substr(0, 15) == "--save-profile=") {
+      Opts.SaveProfilePath = Arg.substr(15);
+    } else if (Arg.substr(0, 15) == "--load-profile=") {
+      Opts.LoadProfilePath = Arg.substr(15);
+    } else if (Arg.substr(0, 19) == "--skip-slower-than=") {
+      const std::string Value(Arg.substr(19));
+      char *End = nullptr;
+      const double Ms = std::strtod(Value.c_str(), &End);
+      if (Value.empty() || *End != '\0' || Ms < 0) {
+        std::cerr << fmt::format(
+            "✖ Error: Invalid --skip-slower-than value '{}'\n", Value);
+        return std::nullopt;
+      }
+      Opts.SkipSlowerThanMs = Ms;
+    } else if (Arg == "--stats") {
+      Opts.Stats = true;
+    } else if (Arg == "--perf-counters") {
+      Opts.Stats = true;
+      Opts.PerfCounters = true;
+    } else if (Arg == "--trace" || Arg.substr(0, 8) == "--trace=") {
+      if (Arg == "--trace") {
+        if (i + 1 >= Argc) {
+          std::cerr << "✖ Error: --trace requires a file name\n";
+          return std::nullopt;
+        }
+        Opts.TracePath = Argv[++i];
+      } else {
+        Opts.TracePath = Arg.substr(8);
+      }
+    } else if (Arg == "--count" || Arg == "-c") {
+      Opts.Mode = coogle::ResultMode::Count;
+    } else if (Arg == "--files-with-matches" || Arg == "-l") {
+      Opts.Mode = coogle::ResultMode::FilesWithMatches;
+    } else if (Arg.size() > 1 && Arg.substr(0, 2) == "--") {
+      std::cerr << fmt::format("✖ Error: Unknown option '{}'\n\n", Arg);
+      printUsage(Argv[0]);
+      return std::nullopt;
+    } else {
+      Positional.push_back(Arg);
+    }
+  }
+
+  if (Opts.RankTopK &&
+      (Opts.Cmd == Command::Dump || Opts.Mode != coogle::ResultMode::List)) {
+    std::cerr << "✖ Error: --rank cannot be combined with dump, --count or "
+                 "--files-with-matches\n";
+    return std::nullopt;
+  }
+
+  if (Opts.AnyOrder && (Opts.Cmd == Command::Dump || Opts.RankTopK)) {
+    std::cerr << "✖ Error: --any-order cannot be combined with dump or "
+                 "--rank\n";
+    return std::nullopt;
+  }
+
+  if (Opts.FuzzyEdits &&
+      (Opts.Cmd == Command::Dump || Opts.RankTopK || Opts.AnyOrder)) {
+    std::cerr << "✖ Error: --fuzzy-types cannot be combined with dump, "
+                 "--rank or --any-order\n";
+    return std::nullopt;
+  }
+
+  if (Opts.ShortNames && (Opts.Cmd == Command::Dump || Opts.RankTopK ||
+                          Opts.AnyOrder || Opts.FuzzyEdits)) {
+    std::cerr << "✖ Error: --short-names cannot be combined with dump, "
+                 "--rank, --any-order or --fuzzy-types\n";
+    return std::nullopt;
+  }
+
+  if (Opts.SkipSlowerThanMs && Opts.LoadProfilePath.empty()) {
+    std::cerr << "✖ Error: --skip-slower-than requires --load-profile\n";
+    return std::nullopt;
+  }
+
+  const std::size_t Expected = Opts.Cmd == Command::Dump
+                                   ? DumpPositionalArgs
+                                   : SearchPositionalArgs;
+  if (Positional.size() != Expected) {
+    std::cerr << fmt::format("✖ Error: Incorrect number of arguments.\n\n");
+    printUsage(Argv[0]);
+    return std::nullopt;
+  }
+
+  Opts.InputPath = Positional[0];
+  if (Opts.Cmd == Command::Search) {
+    Opts.Query = Positional[1];
+  }
+  return Opts;
+}
+
+// Writes the worker buffers and trailer in one writev() and reports parse
+// failures that were kept off stdout.
+bool flushResults(coogle::OutputWriter &Writer,
+                  std::vector<coogle::TaskResult> &AllResults,
+                  coogle::OutputBuffer &Trailer) {
+  std::vector<coogle::OutputBuffer *> Pending;
+  for (auto &TaskRes : AllResults) {
+    Pending.push_back(&TaskRes.Output);
+    for (const auto &File : TaskRes.Failures) {
+      std::cerr << fmt::format("✖ Warning: Failed to parse {}\n", File);
+    }
+  }
+  Pending.push_back(&Trailer);
+
+  return Writer.write(
+      coogle::span<coogle::OutputBuffer *>(Pending.data(), Pending.size()));
+}
+
+// Prints and/or saves the per-file costs recorded by the workers.
+void reportProfile(const CliOptions &Opts,
+                   const std::vector<coogle::TaskResult> &AllResults) {
+  std::vector<coogle::FileProfile> Profiles;
+  for (const auto &TaskRes : AllResults) {
+    Profiles.insert(Profiles.end(), TaskRes.Profile.begin(),
+                    TaskRes.Profile.end());
+  }
+
+  if (Opts.ProfileTopN) {
+    coogle::OutputBuffer Out;
+    coogle::formatTopFiles(Out, Profiles, *Opts.ProfileTopN);
+    coogle::OutputWriter(STDERR_FILENO).write(Out);
+  }
+  if (!Opts.SaveProfilePath.empty()) {
+    coogle::saveProfile(Opts.SaveProfilePath, Profiles);
+  }
+}
+
+// Runs the workers, recording their stats and the parallel wall time in
+// Report when it is non-null. Files are balanced by Costs when a profile
+// was loaded. The --trace timeline and --profile-files report are written
+// once all workers have joined.
+template <typename TaskFn>
+std::vector<coogle::TaskResult>
+runWorkers(const std::vector<std::string> &Files, TaskFn Task,
+           const CliOptions &Opts, const coogle::CostMap *Costs,
+           coogle::StatsReport *Report) {
+  const std::uint64_t StartNs = coogle::wallNowNs();
+  const std::size_t NumThreads = coogle::defaultThreadCount();
+  std::vector<coogle::TaskResult> AllResults =
+      Costs ? coogle::runPartitioned(
+                  coogle::partitionByCost(Files, *Costs, NumThreads), Task)
+            : coogle::runChunked(Files, NumThreads, Task);
+  if (Report) {
+    Report->ParallelWallNs = coogle::wallNowNs() - StartNs;
+    for (const auto &TaskRes : AllResults) {
+      Report->Workers.push_back(TaskRes.Stats);
+    }
+  }
+  if (!Opts.TracePath.empty()) {
+    std::vector<const coogle::TraceBuffer *> Tracks;
+    for (const auto &TaskRes : AllResults) {
+      if (TaskRes.Trace) {
+        Tracks.push_back(TaskRes.Trace.get());
+      }
+    }
+    coogle::writeChromeTrace(Opts.TracePath, Tracks, StartNs);
+  }
+  if (Opts.collectProfile()) {
+    reportProfile(Opts, AllResults);
+  }
+  return AllResults;
+}
+
+int runSearch(const CliOptions &Opts, const std::vector<std::string> &Files,
+              const std::vector<const char *> &ClangArgs,
+              const coogle::CostMap *Costs, coogle::StatsReport *Report) {
+  coogle::WorkerStats *MainStats = Report ? &Report->Main : nullptr;
+
+  // Parse target signature once (with its own storage)
+  coogle::SignatureStorage TargetStorage;
+  std::optional<coogle::Signature> MaybeSig;
+  {
+    coogle::PhaseTimer Timer(MainStats, coogle::Phase::QueryParse);
+    MaybeSig = coogle::parseFunctionSignature(TargetStorage, Opts.Query);
+  }
+  if (!MaybeSig) {
+    return 1;
+  }
+  const coogle::Signature &TargetSig = *MaybeSig;
+
+  // Resolve output settings; color is dropped when stdout is not a terminal
+  // and never applies to the JSON formats
+  coogle::OutputWriter Writer(STDOUT_FILENO);
+  const coogle::OutputFormat Format =
+      Opts.Format.value_or(coogle::OutputFormat::Text);
+  const bool IsText = Format == coogle::OutputFormat::Text;
+  const coogle::WorkerSettings Settings{
+      Opts.Mode, Format,
+      colors::palette(IsText &&
+                      coogle::shouldUseColor(Opts.Color, Writer.fd())),
+      Opts.Stream ? 0 : coogle::OutputFlushThreshold, Report != nullptr,
+      !Opts.TracePath.empty(), Opts.collectProfile(),
+      Opts.PerfCounters, Opts.AnyOrder, Opts.FuzzyEdits, Opts.ShortNames};
+
+  // Header goes out before the workers start, since they may flush early
+  const bool IsList = Opts.Mode == coogle::ResultMode::List;
+  const bool IsJsonArray = Format == coogle::OutputFormat::Json &&
+                           Opts.Mode != coogle::ResultMode::Count;
+  coogle::OutputBuffer Header;
+  if (IsText && IsList) {
+    coogle::formatSearchHeader(Header, Settings.Colors, TargetSig);
+  } else if (IsJsonArray) {
+    Header.append("[\n");
+  }
+  Writer.write(Header);
+  if (IsJsonArray) {
+    Writer.setLeadingSeparator(coogle::JsonRecordSeparator);
+  }
+
+  std::vector<coogle::TaskResult> AllResults = runWorkers(
+      Files,
+      [&](const std::vector<std::string> &Chunk) {
+        if (Opts.RankTopK) {
+          return coogle::rankFiles(Chunk, TargetSig, *Opts.RankTopK,
+                                   ClangArgs, Writer, Settings);
+        }
+        return coogle::processFiles(Chunk, TargetSig, ClangArgs, Writer,
+                                    Settings);
+      },
+      Opts, Costs, Report);
+
+  // --- Output ---
+  size_t TotalMatches = 0;
+  for (const auto &TaskRes : AllResults) {
+    TotalMatches += TaskRes.MatchCount;
+  }
+
+  coogle::OutputBuffer Trailer;
+  if (Opts.RankTopK) {
+    // Workers only kept their own best; the report is the merged best
+    std::vector<std::vector<coogle::RankedMatch>> Lists;
+    for (auto &TaskRes : AllResults) {
+      Lists.push_back(std::move(TaskRes.Ranked));
+    }
+    const std::vector<coogle::RankedMatch> Best =
+        coogle::mergeTopMatches(std::move(Lists), *Opts.RankTopK);
+    TotalMatches = Best.size();
+    for (const coogle::RankedMatch &Match : Best) {
+      if (IsText) {
+        coogle::formatRankedMatch(Trailer, Settings.Colors, Match);
+        continue;
+      }
+      if (IsJsonArray) {
+        Trailer.append(coogle::JsonRecordSeparator);
+      }
+      coogle::formatRankedMatchJson(Trailer, Match);
+      if (!IsJsonArray) {
+        Trailer.append('\n');
+      }
+    }
+  }
+  if (Opts.Mode == coogle::ResultMode::Count) {
+    if (IsText) {
+      Trailer.appendUnsigned(TotalMatches);
+      Trailer.append('\n');
+    } else {
+      coogle::formatCountJson(Trailer, TotalMatches);
+    }
+  } else if (IsText && IsList) {
+    coogle::formatSummary(Trailer, TotalMatches);
+  } else if (IsJsonArray) {
+    Trailer.append("\n]\n");
+  }
+
+  coogle::PhaseTimer Timer(MainStats, coogle::Phase::Output);
+  return flushResults(Writer, AllResults, Trailer) ? 0 : 1;
+}
+
+int runDump(const CliOptions &Opts, const std::vector<std::string> &Files,
+            const std::vector<const char *> &ClangArgs,
+            const coogle::CostMap *Costs, coogle::StatsReport *Report) {
+  coogle::WorkerStats *MainStats = Report ? &Report->Main : nullptr;
+
+  coogle::OutputWriter Writer(STDOUT_FILENO);
+  const coogle::OutputFormat Format =
+      Opts.Format.value_or(coogle::OutputFormat::Ndjson);
+  const coogle::WorkerSettings Settings{
+      coogle::ResultMode::List, Format, colors::palette(false),
+      Opts.Stream ? 0 : coogle::OutputFlushThreshold, Report != nullptr,
+      !Opts.TracePath.empty(), Opts.collectProfile(),
+      Opts.PerfCounters};
+
+  coogle::OutputBuffer Header;
+  if (Format == coogle::OutputFormat::Binary) {
+    Header.append(coogle::DumpBinaryMagic);
+  } else if (Format == coogle::OutputFormat::Json) {
+    Header.append("[\n");
+  }
+  Writer.write(Header);
+  if (Format == coogle::OutputFormat::Json) {
+    Writer.setLeadingSeparator(coogle::JsonRecordSeparator);
+  }
+
+  std::vector<coogle::TaskResult> AllResults = runWorkers(
+      Files,
+      [&](const std::vector<std::string> &Chunk) {
+        return coogle::dumpFiles(Chunk, ClangArgs, Writer, Settings);
+      },
+      Opts, Costs, Report);
+
+  coogle::OutputBuffer Trailer;
+  if (Format == coogle::OutputFormat::Json) {
+    Trailer.append("\n]\n");
+  }
+
+  coogle::PhaseTimer Timer(MainStats, coogle::Phase::Output);
+  return flushResults(Writer, AllResults, Trailer) ? 0 : 1;
+}
+
 int main(int Argc, char *Argv[]) {
   assert(Argv != nullptr && "Argv should not be null");
   assert(Argv[0] != nullptr && "Program name (Argv[0]) should not be null");
@@ -287,21 +598,31 @@ int main(int Argc, char *Argv[]) {
     return 0;
   }
 
-  if (Argc != ExpectedArgCount) {
-    std::cerr << fmt::format("✖ Error: Incorrect number of arguments.\n\n");
-    std::cerr << "Usage:\n";
-    std::cerr << fmt::format(
-        "  {} <file_or_directory> \"<function_signature>\"\n", Argv[0]);
-    std::cerr << fmt::format("  {} --help\n\n", Argv[0]);
+  auto MaybeOpts = parseArgs(Argc, Argv);
+  if (!MaybeOpts) {
     return 1;
   }
+  const CliOptions &Opts = *MaybeOpts;
+
+  // --stats: everything below is charged to the report
+  const std::uint64_t StartNs = coogle::wallNowNs();
+  coogle::StatsReport Report;
+  coogle::StatsReport *ReportPtr = Opts.Stats ? &Report : nullptr;
+  if (Opts.Stats) {
+    coogle::parseOnCallingThread();
+  }
 
-  assert(Argv[1] != nullptr &&
-         "Input path argument (Argv[1]) should not be null");
-  assert(Argv[2] != nullptr &&
-         "Signature argument (Argv[2]) should not be null");
+  // --perf-counters: the main thread samples its own phases too
+  std::optional<coogle::PerfCounters> Counters;
+  if (Opts.PerfCounters) {
+    Counters.emplace();
+    Report.PerfRequested = true;
+    Report.PerfError = Counters->error();
+  }
+  coogle::PerfThreadScope PerfScope(
+      Counters && Counters->available() ? &*Counters : nullptr);
 
-  const std::string InputPath = Argv[1];
+  const std::string &InputPath = Opts.InputPath;
   fs::path Path(InputPath);
 
   // Check if path exists
@@ -311,88 +632,66 @@ int main(int Argc, char *Argv[]) {
   }
 
   // Discover files to parse
-  std::vector<std::string> Files = findSourceFiles(Path);
+  std::vector<std::string> Files;
+  {
+    coogle::PhaseTimer Timer(ReportPtr ? &Report.Main : nullptr,
+                             coogle::Phase::Discovery);
+    Files = coogle::findSourceFiles(Path);
+  }
 
   if (Files.empty()) {
     std::cerr << fmt::format("No C/C++ files found in: {}\n", InputPath);
     return 1;
   }
 
-  // Parse target signature once (with its own storage)
-  coogle::SignatureStorage TargetStorage;
-  auto MaybeSig = coogle::parseFunctionSignature(TargetStorage, Argv[2]);
-  if (!MaybeSig) {
-    return 1;
+  // Cost-based scheduling and exclusion from a saved profile
+  std::optional<coogle::CostMap> Costs;
+  if (!Opts.LoadProfilePath.empty()) {
+    auto Profiles = coogle::loadProfile(Opts.LoadProfilePath);
+    if (!Profiles) {
+      return 1;
+    }
+    Costs = coogle::makeCostMap(*Profiles);
+  }
+  if (Costs && Opts.SkipSlowerThanMs) {
+    const auto LimitNs =
+        static_cast<std::uint64_t>(*Opts.SkipSlowerThanMs * 1e6);
+    const std::size_t Before = Files.size();
+    Files.erase(std::remove_if(Files.begin(), Files.end(),
+                               [&](const std::string &File) {
+                                 auto It = Costs->find(File);
+                                 return It != Costs->end() &&
+                                        It->second > LimitNs;
+                               }),
+                Files.end());
+    if (Files.size() != Before) {
+      std::cerr << fmt::format(
+          "Skipping {} file(s) slower than {} ms in the profile\n",
+          Before - Files.size(), *Opts.SkipSlowerThanMs);
+    }
   }
-  coogle::Signature &TargetSig = *MaybeSig;
+  const coogle::CostMap *CostsPtr = Costs ? &*Costs : nullptr;
 
   // Prepare clang args
-  std::vector<std::string> ArgsVec;
-  ArgsVec.push_back("-x");
-  ArgsVec.push_back("c++");
-  ArgsVec.push_back("-nostdinc");   // Don't search standard system directories
-  ArgsVec.push_back("-nostdinc++"); // Don't search standard C++ directories
-
+  const std::vector<std::string> ArgsVec = coogle::defaultClangArgs();
   std::vector<const char *> ClangArgs;
   for (const auto &S : ArgsVec) {
     ClangArgs.push_back(S.c_str());
   }
 
-  // Determine thread count and chunk size
-  const size_t NumThreads = std::max(1u, std::thread::hardware_concurrency());
-  const size_t NumFiles = Files.size();
-  const size_t ChunkSize = (NumFiles + NumThreads - 1) / NumThreads;
-
-  std::vector<std::future<TaskResult>> Futures;
-
-  // Launch tasks
-  for (size_t i = 0; i < NumThreads; ++i) {
-    size_t Start = i * ChunkSize;
-    if (Start >= NumFiles)
-      break;
-    size_t End = std::min(Start + ChunkSize, NumFiles);
-
-    // Copy subset of files for this chunk
-    std::vector<std::string> ChunkFiles(Files.begin() + Start,
-                                        Files.begin() + End);
-
-    Futures.push_back(std::async(std::launch::async, processFiles,
-                                 std::move(ChunkFiles), std::cref(TargetSig),
-                                 std::cref(ClangArgs)));
-  }
-
-  // Collect results
-  std::vector<TaskResult> AllResults;
-  for (auto &Fut : Futures) {
-    AllResults.push_back(Fut.get());
+  const int Status = Opts.Cmd == Command::Dump
+                         ? runDump(Opts, Files, ClangArgs, CostsPtr, ReportPtr)
+                         : runSearch(Opts, Files, ClangArgs, CostsPtr,
+                                     ReportPtr);
+
+  if (ReportPtr) {
+    Report.TotalWallNs = coogle::wallNowNs() - StartNs;
+    Report.NumFiles = Files.size();
+    Report.Usage = coogle::currentProcessUsage();
+    coogle::OutputBuffer StatsOut;
+    coogle::formatStatsReport(StatsOut, Report);
+    coogle::OutputWriter(STDERR_FILENO).write(StatsOut);
   }
-
-  // --- Output ---
-  fmt::print("\n{}▶ Searching for: {}{}\n\n", colors::Bold,
-             coogle::toString(TargetSig), colors::Reset);
-
-  int TotalMatches = 0;
-
-  // Iterate through collected results
-  for (const auto &TaskRes : AllResults) {
-    for (const auto &Result : TaskRes.Results) {
-      fmt::print("{}{}✔ {}{}\n", colors::Bold, colors::Blue, Result.FileName,
-                 colors::Reset);
-      for (const auto &Match : Result.Matches) {
-        fmt::print("  {}└─ {}{}: {}{}{}{}\n", colors::Grey, colors::Yellow,
-                   Match.Line, colors::Reset, colors::Green, Match.FunctionName,
-                   colors::Reset, Match.SignatureStr);
-        TotalMatches++;
-      }
-    }
-
-    for (const auto &File : TaskRes.Failures) {
-      fmt::print("{}{}✖ Warning: {}{}Failed to parse {}\n", colors::Bold,
-                 colors::Yellow, colors::Reset, File);
-    }
-  }
-
-  fmt::print("\nMatches found: {}\n", TotalMatches);
-
-  return 0;
+  COOGLE_INSTRUMENT_REPORT();
+  return Status;
 }
@@ -0,0 +1,138 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+
+#include "coogle/match.h"
+
+#include <algorithm>
+#include <array>
+
+namespace coogle {
+
+namespace {
+
+// Normalized spellings that most functions in a C/C++ tree use somewhere.
+// Comparing against them first would rarely reject a candidate.
+constexpr std::array<std::string_view, 14> CommonTypes = {
+    "void",  "int",    "bool",         "char*",        "void*",
+    "char",  "double", "float",        "unsignedint",  "unsignedlong",
+    "long",  "size_t", "unsignedchar", "std::string&"};
+
+inline std::string_view actualType(const Signature &Actual,
+                                   std::uint32_t Position) {
+  return Position == MatchProgram::ReturnPosition
+             ? Actual.RetTypeNorm
+             : Actual.ArgTypesNorm[Position];
+}
+
+} // anonymous namespace
+
+unsigned typeSelectivity(std::string_view NormType) {
+  if (std::find(CommonTypes.begin(), CommonTypes.end(), NormType) !=
+      CommonTypes.end()) {
+    return 0;
+  }
+  // Qualified names and template arguments narrow the match further
+  return 1 + static_cast<unsigned>(NormType.size());
+}
+
+MatchProgram::MatchProgram(const Signature &Query)
+    : Arity_(Query.ArgTypesNorm.size()), VariadicTail_(Query.VariadicTail) {
+  Checks_.reserve(Arity_ + 1);
+  auto AddCheck = [this](std::string_view NormType, std::uint32_t Position) {
+    if (hasTypeWildcard(NormType)) {
+      const TypeNode *Pattern = Types_.intern(NormType);
+      if (Pattern->HasWildcard) {
+        PatternChecks_.push_back({Pattern, Position});
+        return;
+      }
+    }
+    Checks_.push_back({NormType, Position});
+  };
+  if (Query.RetType != "*") {
+    AddCheck(Query.RetTypeNorm, ReturnPosition);
+  }
+  for (std::size_t i = 0; i < Arity_; ++i) {
+    if (isWildcardType(Query.ArgTypes[i])) {
+      if (i < 64) {
+        WildcardMask_ |= std::uint64_t(1) << i;
+      }
+      continue;
+    }
+    AddCheck(Query.ArgTypesNorm[i], static_cast<std::uint32_t>(i));
+  }
+
+  // Most selective first; ties keep the return type, then argument order
+  std::stable_sort(Checks_.begin(), Checks_.end(),
+                   [](const Check &A, const Check &B) {
+                     return typeSelectivity(A.Expected) >
+                            typeSelectivity(B.Expected);
+                   });
+
+  // Indexed by [tail][number of checks]
+  static constexpr std::array<std::array<MatcherFn, 6>, 2> FixedMatchers = {{
+      {&matchFixed<0, false>, &matchFixed<1, false>, &matchFixed<2, false>,
+       &matchFixed<3, false>, &matchFixed<4, false>, &matchFixed<5, false>},
+      {&matchFixed<0, true>, &matchFixed<1, true>, &matchFixed<2, true>,
+       &matchFixed<3, true>, &matchFixed<4, true>, &matchFixed<5, true>},
+  }};
+  const auto &Fixed = FixedMatchers[VariadicTail_];
+  if (!PatternChecks_.empty()) {
+    Matcher_ = VariadicTail_ ? &matchPatterns<true> : &matchPatterns<false>;
+  } else if (Checks_.size() < Fixed.size()) {
+    Matcher_ = Fixed[Checks_.size()];
+  } else {
+    Matcher_ = VariadicTail_ ? &matchLoop<true> : &matchLoop<false>;
+  }
+}
+
+template <bool Tail>
+bool MatchProgram::arityMatches(const MatchProgram &Program,
+                                const Signature &Actual) {
+  // Checked positions all lie below Arity_, so a tail needs no more
+  return isArityMatch(Program.Arity_, Tail, Actual.ArgTypesNorm.size());
+}
+
+template <std::size_t NumChecks, bool Tail>
+bool MatchProgram::matchFixed(const MatchProgram &Program,
+                              const Signature &Actual) {
+  if (!arityMatches<Tail>(Program, Actual)) {
+    return false;
+  }
+  const Check *Checks = Program.Checks_.data();
+  for (std::size_t i = 0; i < NumChecks; ++i) {
+    if (actualType(Actual, Checks[i].Position) != Checks[i].Expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <bool Tail>
+bool MatchProgram::matchLoop(const MatchProgram &Program,
+                             const Signature &Actual) {
+  if (!arityMatches<Tail>(Program, Actual)) {
+    return false;
+  }
+  for (const Check &C : Program.Checks_) {
+    if (actualType(Actual, C.Position) != C.Expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <bool Tail>
+bool MatchProgram::matchPatterns(const MatchProgram &Program,
+                                 const Signature &Actual) {
+  if (!matchLoop<Tail>(Program, Actual)) {
+    return false;
+  }
+  TypeBindings Bindings;
+  for (const PatternCheck &C : Program.PatternChecks_) {
+    if (!matchesType(*C.Pattern, actualType(Actual, C.Position), Bindings)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace coogle
@@ -0,0 +1,361 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Buffered output writer and text/JSON formatters.
+
+#include "coogle/output.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <iostream>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace coogle {
+
+namespace {
+// Upper bound on iovecs passed to a single writev() call.
+#ifdef IOV_MAX
+constexpr std::size_t MaxIovecs = IOV_MAX;
+#else
+constexpr std::size_t MaxIovecs = 1024;
+#endif
+
+// Writes Data fully, retrying on short writes and EINTR.
+bool writeFully(int Fd, const char *Data, std::size_t Size) {
+  while (Size > 0) {
+    ssize_t Written = ::write(Fd, Data, Size);
+    if (Written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    Data += Written;
+    Size -= static_cast<std::size_t>(Written);
+  }
+  return true;
+}
+
+// Writes all iovecs, advancing past partially written entries.
+bool writevFully(int Fd, iovec *Iov, std::size_t Count) {
+  while (Count > 0) {
+    const int Batch = static_cast<int>(std::min(Count, MaxIovecs));
+    ssize_t Written = ::writev(Fd, Iov, Batch);
+    if (Written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+
+    auto Remaining = static_cast<std::size_t>(Written);
+    while (Count > 0 && Remaining >= Iov->iov_len) {
+      Remaining -= Iov->iov_len;
+      ++Iov;
+      --Count;
+    }
+    if (Count > 0) {
+      Iov->iov_base = static_cast<char *>(Iov->iov_base) + Remaining;
+      Iov->iov_len -= Remaining;
+    }
+  }
+  return true;
+}
+
+// Appends Str with JSON string escaping, without surrounding quotes.
+void appendJsonEscaped(OutputBuffer &Out, std::string_view Str) {
+  static constexpr char Hex[] = "0123456789abcdef";
+
+  size_t RunStart = 0;
+  for (size_t i = 0; i < Str.size(); ++i) {
+    const auto C = static_cast<unsigned char>(Str[i]);
+    if (C >= 0x20 && C != '"' && C != '\\') {
+      continue;
+    }
+
+    // Copy the clean run before the escaped character in one go
+    Out.append(Str.substr(RunStart, i - RunStart));
+    RunStart = i + 1;
+
+    switch (C) {
+    case '"':
+      Out.append("\\\"");
+      break;
+    case '\\':
+      Out.append("\\\\");
+      break;
+    case '\n':
+      Out.append("\\n");
+      break;
+    case '\t':
+      Out.append("\\t");
+      break;
+    case '\r':
+      Out.append("\\r");
+      break;
+    case '\b':
+      Out.append("\\b");
+      break;
+    case '\f':
+      Out.append("\\f");
+      break;
+    default:
+      Out.append("\\u00");
+      Out.append(Hex[C >> 4]);
+      Out.append(Hex[C & 0xF]);
+      break;
+    }
+  }
+  Out.append(Str.substr(RunStart));
+}
+} // anonymous namespace
+
+std::optional<ColorMode> parseColorMode(std::string_view Value) {
+  if (Value == "auto") {
+    return ColorMode::Auto;
+  }
+  if (Value == "always") {
+    return ColorMode::Always;
+  }
+  if (Value == "never") {
+    return ColorMode::Never;
+  }
+  return std::nullopt;
+}
+
+std::optional<OutputFormat> parseOutputFormat(std::string_view Value) {
+  if (Value == "text") {
+    return OutputFormat::Text;
+  }
+  if (Value == "json") {
+    return OutputFormat::Json;
+  }
+  if (Value == "ndjson") {
+    return OutputFormat::Ndjson;
+  }
+  if (Value == "binary") {
+    return OutputFormat::Binary;
+  }
+  return std::nullopt;
+}
+
+bool shouldUseColor(ColorMode Mode, int Fd) {
+  switch (Mode) {
+  case ColorMode::Always:
+    return true;
+  case ColorMode::Never:
+    return false;
+  case ColorMode::Auto:
+    return ::isatty(Fd) == 1;
+  }
+  return false;
+}
+
+void OutputBuffer::appendUnsigned(unsigned long long Value) {
+  char Digits[20];
+  auto [End, Ec] = std::to_chars(Digits, Digits + sizeof(Digits), Value);
+  (void)Ec; // 20 digits always fit a 64-bit value
+  Data_.insert(Data_.end(), Digits, End);
+}
+
+std::string_view OutputWriter::stripLeadingSeparator(std::string_view Chunk) {
+  if (LeadingSeparator_.empty() || SeparatorStripped_) {
+    return Chunk;
+  }
+  SeparatorStripped_ = true;
+  if (Chunk.substr(0, LeadingSeparator_.size()) == LeadingSeparator_) {
+    Chunk.remove_prefix(LeadingSeparator_.size());
+  }
+  return Chunk;
+}
+
+bool OutputWriter::write(OutputBuffer &Buffer) {
+  if (Buffer.empty()) {
+    return true;
+  }
+  bool Ok;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    std::string_view View = stripLeadingSeparator(Buffer.view());
+    Ok = writeFully(Fd_, View.data(), View.size());
+  }
+  Buffer.clear();
+  return Ok;
+}
+
+bool OutputWriter::write(span<OutputBuffer *> Buffers) {
+  std::vector<iovec> Iov;
+  Iov.reserve(Buffers.size());
+
+  bool Ok;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex_);
+    for (OutputBuffer *Buffer : Buffers) {
+      if (!Buffer->empty()) {
+        std::string_view View = stripLeadingSeparator(Buffer->view());
+        Iov.push_back({const_cast<char *>(View.data()), View.size()});
+      }
+    }
+    Ok = writevFully(Fd_, Iov.data(), Iov.size());
+  }
+  for (OutputBuffer *Buffer : Buffers) {
+    Buffer->clear();
+  }
+  return Ok;
+}
+
+bool writeFileContents(const std::string &Path, OutputBuffer &Buffer,
+                       std::string_view What) {
+  int Fd = ::open(Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (Fd < 0) {
+    std::cerr << fmt::format("✖ Error: Cannot open {} file '{}': {}\n", What,
+                             Path, std::strerror(errno));
+    Buffer.clear();
+    return false;
+  }
+
+  const bool Ok = OutputWriter(Fd).write(Buffer);
+  if (::close(Fd) != 0 || !Ok) {
+    std::cerr << fmt::format("✖ Error: Failed to write {} file '{}'\n", What,
+                             Path);
+    return false;
+  }
+  return true;
+}
+
+void appendSignature(OutputBuffer &Out, const Signature &Sig) {
+  Out.append(Sig.RetType);
+  Out.append('(');
+  for (size_t i = 0; i < Sig.ArgTypes.size(); ++i) {
+    if (i > 0) {
+      Out.append(", ");
+    }
+    Out.append(Sig.ArgTypes[i]);
+  }
+  if (Sig.VariadicTail) {
+    Out.append(Sig.ArgTypes.empty() ? "..." : ", ...");
+  }
+  Out.append(')');
+}
+
+void appendJsonString(OutputBuffer &Out, std::string_view Str) {
+  Out.append('"');
+  appendJsonEscaped(Out, Str);
+  Out.append('"');
+}
+
+void formatMatchJson(OutputBuffer &Out, const MatchRecord &Match) {
+  Out.append('{');
+  formatMatchJsonFields(Out, Match);
+  Out.append('}');
+}
+
+void formatMatchJsonFields(OutputBuffer &Out, const MatchRecord &Match) {
+  Out.append("\"file\":");
+  appendJsonString(Out, Match.FileName);
+  Out.append(",\"line\":");
+  Out.appendUnsigned(Match.Line);
+  Out.append(",\"column\":");
+  Out.appendUnsigned(Match.Column);
+  Out.append(",\"name\":");
+  appendJsonString(Out, Match.FunctionName);
+
+  // Escape the signature piecewise rather than building it with toString()
+  const Signature &Sig = *Match.Sig;
+  Out.append(",\"signature\":\"");
+  appendJsonEscaped(Out, Sig.RetType);
+  Out.append('(');
+  for (size_t i = 0; i < Sig.ArgTypes.size(); ++i) {
+    if (i > 0) {
+      Out.append(", ");
+    }
+    appendJsonEscaped(Out, Sig.ArgTypes[i]);
+  }
+  if (Sig.VariadicTail) {
+    Out.append(Sig.ArgTypes.empty() ? "..." : ", ...");
+  }
+  Out.append(")\",\"kind\":");
+  appendJsonString(Out, Match.Kind);
+}
+
+void formatMatchedFile(OutputBuffer &Out, const colors::Palette &Colors,
+                       std::string_view FileName) {
+  Out.append(Colors.Blue);
+  Out.append(FileName);
+  Out.append(Colors.Reset);
+  Out.append('\n');
+}
+
+void formatMatchedFileJson(OutputBuffer &Out, std::string_view FileName) {
+  Out.append("{\"file\":");
+  appendJsonString(Out, FileName);
+  Out.append('}');
+}
+
+void formatCountJson(OutputBuffer &Out, std::size_t Count) {
+  Out.append("{\"count\":");
+  Out.appendUnsigned(Count);
+  Out.append("}\n");
+}
+
+void formatSearchHeader(OutputBuffer &Out, const colors::Palette &Colors,
+                        const Signature &Query) {
+  Out.append('\n');
+  Out.append(Colors.Bold);
+  Out.append("▶ Searching for: ");
+  appendSignature(Out, Query);
+  Out.append(Colors.Reset);
+  Out.append("\n\n");
+}
+
+void formatFileHeader(OutputBuffer &Out, const colors::Palette &Colors,
+                      std::string_view FileName) {
+  Out.append(Colors.Bold);
+  Out.append(Colors.Blue);
+  Out.append("✔ ");
+  Out.append(FileName);
+  Out.append(Colors.Reset);
+  Out.append('\n');
+}
+
+void formatMatch(OutputBuffer &Out, const colors::Palette &Colors,
+                 unsigned Line, std::string_view FunctionName,
+                 const Signature &Sig) {
+  Out.append("  ");
+  Out.append(Colors.Grey);
+  Out.append("└─ ");
+  Out.append(Colors.Yellow);
+  Out.appendUnsigned(Line);
+  Out.append(": ");
+  Out.append(Colors.Reset);
+  Out.append(Colors.Green);
+  Out.append(FunctionName);
+  Out.append(Colors.Reset);
+  Out.append(' ');
+  appendSignature(Out, Sig);
+  Out.append('\n');
+}
+
+void formatParseFailure(OutputBuffer &Out, const colors::Palette &Colors,
+                        std::string_view FileName) {
+  Out.append(Colors.Bold);
+  Out.append(Colors.Yellow);
+  Out.append("✖ Warning: ");
+  Out.append(Colors.Reset);
+  Out.append("Failed to parse ");
+  Out.append(FileName);
+  Out.append('\n');
+}
+
+void formatSummary(OutputBuffer &Out, std::size_t TotalMatches) {
+  Out.append("\nMatches found: ");
+  Out.appendUnsigned(TotalMatches);
+  Out.append('\n');
+}
+
+} // namespace coogle
@@ -4,6 +4,7 @@
 // signature matcher with zero-allocation design.
 
 #include "coogle/parser.h"
+#include "coogle/type_tree.h"
 
 #include <array>
 #include <cassert>
@@ -27,6 +28,11 @@ std::string_view trim(std::string_view Sv) {
   return Sv.substr(Start, End - Start + 1);
 }
 
+// "..." (C spelling) or ".." ends a query's argument list
+bool isVariadicTail(std::string_view Token) {
+  return Token == "..." || Token == "..";
+}
+
 // Keywords to skip during type normalization
 constexpr std::array<std::string_view, 4> Keywords = {"const", "class",
                                                       "struct", "union"};
@@ -113,6 +119,39 @@ size_t normalizeStdString(coogle::span<char> Buffer, size_t WriteIdx) {
   return WriteIdx;
 }
 
+// isSignatureMatch() with the comparison of one pair of normalized types
+// supplied by the caller.
+template <typename TypeMatchFn>
+bool matchSignature(const Signature &UserSig, const Signature &ActualSig,
+                    TypeMatchFn TypeMatches) {
+  // Direct comparison using pre-normalized types
+  if (UserSig.RetType != "*" &&
+      !TypeMatches(UserSig.RetTypeNorm, ActualSig.RetTypeNorm)) {
+    return false;
+  }
+
+  // A variadic tail only fixes the leading arguments
+  const size_t UserArgs = UserSig.ArgTypesNorm.size();
+  const size_t ActualArgs = ActualSig.ArgTypesNorm.size();
+  if (UserSig.VariadicTail ? ActualArgs < UserArgs : ActualArgs != UserArgs) {
+    return false;
+  }
+
+  // Check each argument (with wildcard support)
+  for (size_t i = 0; i < UserSig.ArgTypesNorm.size(); ++i) {
+    // Wildcard matches any type
+    if (UserSig.ArgTypes[i] == "*") {
+      continue;
+    }
+
+    if (!TypeMatches(UserSig.ArgTypesNorm[i], ActualSig.ArgTypesNorm[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 } // anonymous namespace
 
 std::string_view normalizeType(StringArena &Arena, std::string_view Type) {
@@ -180,6 +219,7 @@ std::optional<Signature> parseFunctionSignature(SignatureStorage &Storage,
   std::string_view RetTypeSV = trim(Input.substr(0, ParenOpen));
   Result.RetType = Storage.internString(RetTypeSV);
   Result.RetTypeNorm = normalizeType(Storage.arena(), Result.RetType);
+  Result.HasTypeVariables = hasTypeVariable(Result.RetTypeNorm);
 
   // Parse arguments
   std::string_view ArgSV =
@@ -217,6 +257,13 @@ std::optional<Signature> parseFunctionSignature(SignatureStorage &Storage,
       Level--;
     } else if (ArgSV[i] == ',' && Level == 0) {
       std::string_view Token = trim(ArgSV.substr(Start, i - Start));
+      if (isVariadicTail(Token)) {
+        std::cerr << fmt::format(
+            "Invalid function signature ('{}' must be the last argument): "
+            "'{}'\n",
+            Token, Input);
+        return std::nullopt;
+      }
       if (!Token.empty()) {
         std::string_view ArgOrig = Storage.internString(Token);
         std::string_view ArgNorm = normalizeType(Storage.arena(), ArgOrig);
@@ -226,9 +273,11 @@ std::optional<Signature> parseFunctionSignature(SignatureStorage &Storage,
     }
   }
 
-  // Last argument
+  // Last argument, or the variadic tail
   std::string_view Token = trim(ArgSV.substr(Start));
-  if (!Token.empty()) {
+  if (isVariadicTail(Token)) {
+    Result.VariadicTail = true;
+  } else if (!Token.empty()) {
     std::string_view ArgOrig = Storage.internString(Token);
     std::string_view ArgNorm = normalizeType(Storage.arena(), ArgOrig);
     Storage.addArg(ArgOrig, ArgNorm);
@@ -237,37 +286,36 @@ std::optional<Signature> parseFunctionSignature(SignatureStorage &Storage,
   Result.ArgTypes = Storage.getArgs();
   Result.ArgTypesNorm = Storage.getArgsNorm();
 
+  for (std::string_view ArgNorm : Result.ArgTypesNorm) {
+    Result.HasTypeVariables |= hasTypeVariable(ArgNorm);
+  }
+
   return Result;
 }
 
 std::string toString(const Signature &Sig) {
   // Note: Still returns std::string for display purposes
-  return fmt::format("{}({})", Sig.RetType, fmt::join(Sig.ArgTypes, ", "));
+  std::string_view Tail;
+  if (Sig.VariadicTail) {
+    Tail = Sig.ArgTypes.empty() ? "..." : ", ...";
+  }
+  return fmt::format("{}({}{})", Sig.RetType, fmt::join(Sig.ArgTypes, ", "),
+                     Tail);
 }
 
 bool isSignatureMatch(const Signature &UserSig, const Signature &ActualSig) {
-  // Direct comparison using pre-normalized types
-  if (UserSig.RetTypeNorm != ActualSig.RetTypeNorm) {
-    return false;
-  }
-
-  if (UserSig.ArgTypesNorm.size() != ActualSig.ArgTypesNorm.size()) {
-    return false;
-  }
-
-  // Check each argument (with wildcard support)
-  for (size_t i = 0; i < UserSig.ArgTypesNorm.size(); ++i) {
-    // Wildcard matches any type
-    if (UserSig.ArgTypes[i] == "*") {
-      continue;
-    }
-
-    if (UserSig.ArgTypesNorm[i] != ActualSig.ArgTypesNorm[i]) {
-      return false;
-    }
+  if (UserSig.HasTypeVariables) {
+    // Type variables must bind to the same type across all positions
+    TypeBindings Bindings;
+    return matchSignature(UserSig, ActualSig,
+                          [&](std::string_view User, std::string_view Actual) {
+                            return isTypeMatch(User, Actual, Bindings);
+                          });
   }
-
-  return true;
+  return matchSignature(UserSig, ActualSig,
+                        [](std::string_view User, std::string_view Actual) {
+                          return User == Actual || isTypeMatch(User, Actual);
+                        });
 }
 
 } // namespace coogle
@@ -0,0 +1,138 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Hardware performance counters via perf_event_open (Linux only; other
+// platforms always report the counters as unavailable).
+
+#include "coogle/perf.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fmt/core.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace coogle {
+
+namespace {
+thread_local PerfCounters *CurrentCounters = nullptr;
+
+#ifdef __linux__
+constexpr std::array<std::uint64_t, NumPerfEvents> HardwareEvents = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+// Opens one user-space counter for the calling thread on any CPU, and with
+// Inherit for the threads it starts afterwards.
+int openCounter(std::uint64_t Config, bool Inherit) {
+  perf_event_attr Attr;
+  std::memset(&Attr, 0, sizeof(Attr));
+  Attr.type = PERF_TYPE_HARDWARE;
+  Attr.size = sizeof(Attr);
+  Attr.config = Config;
+  Attr.exclude_kernel = 1;
+  Attr.exclude_hv = 1;
+  Attr.inherit = Inherit ? 1 : 0;
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &Attr, /*pid=*/0, /*cpu=*/-1,
+              /*group_fd=*/-1, /*flags=*/0));
+}
+#endif
+} // anonymous namespace
+
+const char *perfEventName(PerfEvent Event) {
+  switch (Event) {
+  case PerfEvent::Cycles:
+    return "cycles";
+  case PerfEvent::Instructions:
+    return "instructions";
+  case PerfEvent::CacheMisses:
+    return "cache misses";
+  case PerfEvent::BranchMisses:
+    return "branch misses";
+  }
+  return "unknown";
+}
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &Other) {
+  for (std::size_t i = 0; i < NumPerfEvents; ++i) {
+    Values[i] += Other.Values[i];
+    Valid[i] = Valid[i] || Other.Valid[i];
+  }
+  return *this;
+}
+
+PerfCounts perfDelta(const PerfCounts &Start, const PerfCounts &End) {
+  PerfCounts Delta;
+  for (std::size_t i = 0; i < NumPerfEvents; ++i) {
+    Delta.Valid[i] = Start.Valid[i] && End.Valid[i];
+    Delta.Values[i] = Delta.Valid[i] && End.Values[i] > Start.Values[i]
+                          ? End.Values[i] - Start.Values[i]
+                          : 0;
+  }
+  return Delta;
+}
+
+PerfCounters::PerfCounters(bool CountChildThreads) {
+  Fds_.fill(-1);
+#ifdef __linux__
+  for (std::size_t i = 0; i < NumPerfEvents; ++i) {
+    Fds_[i] = openCounter(HardwareEvents[i], CountChildThreads);
+    if (Fds_[i] < 0 && Error_.empty()) {
+      Error_ = fmt::format("{}: {}", perfEventName(static_cast<PerfEvent>(i)),
+                           std::strerror(errno));
+    }
+  }
+#else
+  (void)CountChildThreads;
+  Error_ = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int Fd : Fds_) {
+    if (Fd >= 0) {
+      ::close(Fd);
+    }
+  }
+#endif
+}
+
+bool PerfCounters::available() const {
+  for (int Fd : Fds_) {
+    if (Fd >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+PerfCounts PerfCounters::read() const {
+  PerfCounts Counts;
+#ifdef __linux__
+  for (std::size_t i = 0; i < NumPerfEvents; ++i) {
+    std::uint64_t Value = 0;
+    if (Fds_[i] >= 0 && ::read(Fds_[i], &Value, sizeof(Value)) ==
+                            static_cast<ssize_t>(sizeof(Value))) {
+      Counts.Values[i] = Value;
+      Counts.Valid[i] = true;
+    }
+  }
+#endif
+  return Counts;
+}
+
+PerfCounters *threadPerfCounters() { return CurrentCounters; }
+
+PerfThreadScope::PerfThreadScope(PerfCounters *Counters)
+    : Previous_(CurrentCounters) {
+  CurrentCounters = Counters;
+}
+
+PerfThreadScope::~PerfThreadScope() { CurrentCounters = Previous_; }
+
+} // namespace coogle
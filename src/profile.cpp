@@ -0,0 +1,187 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Per-file cost profile: report, persistence and cost-based scheduling.
+
+#include "coogle/profile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fmt/core.h>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <utility>
+
+namespace coogle {
+
+namespace {
+constexpr std::uint64_t NsPerUs = 1000;
+
+bool slowerFirst(const FileProfile &A, const FileProfile &B) {
+  return A.costNs() > B.costNs();
+}
+
+// Splits off the next tab-separated field of Line.
+std::string_view nextField(std::string_view &Line) {
+  const std::size_t Tab = Line.find('\t');
+  std::string_view Field = Line.substr(0, Tab);
+  Line.remove_prefix(Tab == std::string_view::npos ? Line.size() : Tab + 1);
+  return Field;
+}
+
+bool parseUnsigned(std::string_view Field, std::uint64_t &Value) {
+  const char *End = Field.data() + Field.size();
+  auto [Ptr, Ec] = std::from_chars(Field.data(), End, Value);
+  return Ec == std::errc() && Ptr == End && !Field.empty();
+}
+} // anonymous namespace
+
+void formatTopFiles(OutputBuffer &Out, std::vector<FileProfile> Profiles,
+                    std::size_t N) {
+  N = std::min(N, Profiles.size());
+  std::partial_sort(Profiles.begin(), Profiles.begin() + N, Profiles.end(),
+                    slowerFirst);
+
+  Out.append(fmt::format("\n── Slowest files (top {} of {}) ──\n", N,
+                         Profiles.size()));
+  Out.append(fmt::format("{:>10} {:>10} {:>10} {:>9} {:>6}  {}\n", "total ms",
+                         "parse ms", "visit ms", "TU KiB", "funcs", "file"));
+  for (std::size_t i = 0; i < N; ++i) {
+    const FileProfile &P = Profiles[i];
+    Out.append(fmt::format("{:>10.2f} {:>10.2f} {:>10.2f} {:>9} {:>6}  {}\n",
+                           static_cast<double>(P.costNs()) / 1e6,
+                           static_cast<double>(P.ParseNs) / 1e6,
+                           static_cast<double>(P.VisitNs) / 1e6,
+                           P.MemoryBytes / 1024, P.Functions, P.File));
+  }
+}
+
+void formatProfile(OutputBuffer &Out,
+                   const std::vector<FileProfile> &Profiles) {
+  Out.append(ProfileHeader);
+  Out.append("\n# file\tparse_us\tvisit_us\tmemory_bytes\tfunctions\n");
+  for (const FileProfile &P : Profiles) {
+    Out.append(P.File);
+    Out.append('\t');
+    Out.appendUnsigned(P.ParseNs / NsPerUs);
+    Out.append('\t');
+    Out.appendUnsigned(P.VisitNs / NsPerUs);
+    Out.append('\t');
+    Out.appendUnsigned(P.MemoryBytes);
+    Out.append('\t');
+    Out.appendUnsigned(P.Functions);
+    Out.append('\n');
+  }
+}
+
+std::optional<std::vector<FileProfile>> parseProfile(std::string_view Text) {
+  if (Text.substr(0, ProfileHeader.size()) != ProfileHeader) {
+    return std::nullopt;
+  }
+
+  std::vector<FileProfile> Profiles;
+  while (!Text.empty()) {
+    const std::size_t Newline = Text.find('\n');
+    std::string_view Line = Text.substr(0, Newline);
+    Text.remove_prefix(Newline == std::string_view::npos ? Text.size()
+                                                         : Newline + 1);
+    if (Line.empty() || Line.front() == '#') {
+      continue;
+    }
+
+    FileProfile P;
+    std::uint64_t ParseUs = 0;
+    std::uint64_t VisitUs = 0;
+    P.File = std::string(nextField(Line));
+    if (P.File.empty() || !parseUnsigned(nextField(Line), ParseUs) ||
+        !parseUnsigned(nextField(Line), VisitUs) ||
+        !parseUnsigned(nextField(Line), P.MemoryBytes) ||
+        !parseUnsigned(nextField(Line), P.Functions)) {
+      continue; // Malformed row
+    }
+    P.ParseNs = ParseUs * NsPerUs;
+    P.VisitNs = VisitUs * NsPerUs;
+    Profiles.push_back(std::move(P));
+  }
+  return Profiles;
+}
+
+bool saveProfile(const std::string &Path,
+                 const std::vector<FileProfile> &Profiles) {
+  OutputBuffer Out;
+  formatProfile(Out, Profiles);
+  return writeFileContents(Path, Out, "profile");
+}
+
+std::optional<std::vector<FileProfile>> loadProfile(const std::string &Path) {
+  std::ifstream In(Path, std::ios::binary);
+  if (!In) {
+    std::cerr << fmt::format("✖ Error: Cannot open profile file '{}'\n",
+                             Path);
+    return std::nullopt;
+  }
+  std::ostringstream Contents;
+  Contents << In.rdbuf();
+
+  auto Profiles = parseProfile(Contents.str());
+  if (!Profiles) {
+    std::cerr << fmt::format("✖ Error: '{}' is not a coogle profile\n", Path);
+  }
+  return Profiles;
+}
+
+CostMap makeCostMap(const std::vector<FileProfile> &Profiles) {
+  CostMap Costs;
+  Costs.reserve(Profiles.size());
+  for (const FileProfile &P : Profiles) {
+    Costs[P.File] = P.costNs();
+  }
+  return Costs;
+}
+
+std::vector<std::vector<std::string>>
+partitionByCost(const std::vector<std::string> &Files, const CostMap &Costs,
+                std::size_t NumChunks) {
+  NumChunks = std::max<std::size_t>(1, std::min(NumChunks, Files.size()));
+
+  std::uint64_t KnownTotal = 0;
+  std::size_t KnownCount = 0;
+  for (const auto &File : Files) {
+    auto It = Costs.find(File);
+    if (It != Costs.end()) {
+      KnownTotal += It->second;
+      KnownCount++;
+    }
+  }
+  const std::uint64_t DefaultCost = KnownCount ? KnownTotal / KnownCount : 1;
+
+  std::vector<std::pair<std::uint64_t, std::size_t>> ByCost; // (cost, index)
+  ByCost.reserve(Files.size());
+  for (std::size_t i = 0; i < Files.size(); ++i) {
+    auto It = Costs.find(Files[i]);
+    ByCost.emplace_back(It != Costs.end() ? It->second : DefaultCost, i);
+  }
+  std::stable_sort(
+      ByCost.begin(), ByCost.end(),
+      [](const auto &A, const auto &B) { return A.first > B.first; });
+
+  // Min-heap of (load, chunk): each file goes to the least loaded chunk
+  using Load = std::pair<std::uint64_t, std::size_t>;
+  std::priority_queue<Load, std::vector<Load>, std::greater<Load>> Loads;
+  for (std::size_t i = 0; i < NumChunks; ++i) {
+    Loads.push({0, i});
+  }
+
+  std::vector<std::vector<std::string>> Chunks(NumChunks);
+  for (const auto &[Cost, Index] : ByCost) {
+    auto [Current, Chunk] = Loads.top();
+    Loads.pop();
+    Chunks[Chunk].push_back(Files[Index]);
+    Loads.push({Current + Cost, Chunk});
+  }
+  return Chunks;
+}
+
+} // namespace coogle
@@ -0,0 +1,268 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Ranked search: scoring, bounded per-worker heaps and result formatting.
+
+#include "coogle/rank.h"
+
+#include "coogle/type_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <tuple>
+
+namespace coogle {
+
+namespace {
+
+std::string_view stripReference(std::string_view Type) {
+  if (Type.size() > 2 && Type.substr(Type.size() - 2) == "&&") {
+    return Type.substr(0, Type.size() - 2);
+  }
+  if (Type.size() > 1 && Type.back() == '&') {
+    return Type.substr(0, Type.size() - 1);
+  }
+  return Type;
+}
+
+// T vs T* (either side)
+bool matchesUpToPointer(std::string_view Query, std::string_view Actual) {
+  if (Actual.size() > 1 && Actual.back() == '*' &&
+      isTypeMatch(Query, Actual.substr(0, Actual.size() - 1))) {
+    return true;
+  }
+  return Query.size() > 1 && Query.back() == '*' &&
+         isTypeMatch(Query.substr(0, Query.size() - 1), Actual);
+}
+
+// Pairing penalties, query argument by candidate argument.
+using CostMatrix =
+    std::array<std::array<unsigned, MaxRankedArity>, MaxRankedArity>;
+
+unsigned popCount(unsigned Mask) {
+  return static_cast<unsigned>(std::bitset<32>(Mask).count());
+}
+
+// Position of the highest set bit plus one (0 for 0).
+unsigned bitWidth(unsigned Mask) {
+  unsigned Width = 0;
+  for (; Mask; Mask >>= 1) {
+    ++Width;
+  }
+  return Width;
+}
+
+// The search formatters take a Signature; view the owned strings as one.
+template <typename FormatFn>
+void withSignature(const RankedMatch &Match, FormatFn Format) {
+  std::vector<std::string_view> Args(Match.ArgTypes.begin(),
+                                     Match.ArgTypes.end());
+  Signature Sig;
+  Sig.RetType = Match.RetType;
+  Sig.ArgTypes = span<std::string_view>(Args.data(), Args.size());
+  Sig.VariadicTail = Match.VariadicTail;
+  Format(Sig);
+}
+
+} // anonymous namespace
+
+unsigned typeDistance(std::string_view Query, std::string_view Actual) {
+  if (isTypeMatch(Query, Actual)) {
+    return 0;
+  }
+  const std::string_view QueryBase = stripReference(Query);
+  const std::string_view ActualBase = stripReference(Actual);
+  unsigned Cost = 0;
+  if (QueryBase.size() != Query.size() || ActualBase.size() != Actual.size()) {
+    Cost += RankCosts::Reference;
+    if (isTypeMatch(QueryBase, ActualBase)) {
+      return Cost;
+    }
+  }
+  if (matchesUpToPointer(QueryBase, ActualBase)) {
+    return Cost + RankCosts::Pointer;
+  }
+  return NoTypeMatch;
+}
+
+RankedQuery::RankedQuery(const Signature &Query)
+    : ArgTypes_(Query.ArgTypesNorm.begin(), Query.ArgTypesNorm.end()),
+      VariadicTail_(Query.VariadicTail) {
+  if (Query.RetType != "*") {
+    RetType_ = Query.RetTypeNorm;
+  }
+}
+
+unsigned RankedQuery::returnCost(const Signature &Actual) const {
+  if (RetType_.empty()) {
+    return 0;
+  }
+  const unsigned Cost = typeDistance(RetType_, Actual.RetTypeNorm);
+  return std::min(Cost, RankCosts::Return);
+}
+
+unsigned RankedQuery::arityCost(std::size_t ActualArgs) const {
+  const std::size_t QueryArgs = ArgTypes_.size();
+  if (ActualArgs >= QueryArgs) {
+    return VariadicTail_ ? 0
+                         : static_cast<unsigned>(ActualArgs - QueryArgs) *
+                               RankCosts::ExtraArg;
+  }
+  return static_cast<unsigned>(QueryArgs - ActualArgs) * RankCosts::MissingArg;
+}
+
+unsigned RankedQuery::lowerBound(const Signature &Actual) const {
+  // Every unpaired argument costs at least its arity penalty
+  return returnCost(Actual) + arityCost(Actual.ArgTypesNorm.size());
+}
+
+unsigned RankedQuery::score(const Signature &Actual) const {
+  const std::size_t N = ArgTypes_.size();
+  const std::size_t M = Actual.ArgTypesNorm.size();
+  const unsigned Unpaired =
+      RankCosts::MissingArg + (VariadicTail_ ? 0 : RankCosts::ExtraArg);
+  unsigned Total = returnCost(Actual);
+
+  if (N > MaxRankedArity || M > MaxRankedArity) {
+    // Too many arguments for the assignment search: pair by position
+    const std::size_t Paired = std::min(N, M);
+    for (std::size_t i = 0; i < Paired; ++i) {
+      const unsigned Cost =
+          typeDistance(ArgTypes_[i], Actual.ArgTypesNorm[i]);
+      Total += Cost == NoTypeMatch ? Unpaired : Cost;
+    }
+    return Total + arityCost(M);
+  }
+
+  CostMatrix Costs;
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < M; ++j) {
+      Costs[i][j] = typeDistance(ArgTypes_[i], Actual.ArgTypesNorm[j]);
+    }
+  }
+
+  // Best assignment of query arguments (in order) to distinct candidate
+  // arguments, over the set of candidate arguments used so far. Pairing
+  // query argument i with candidate argument j swaps it with every pair
+  // already made to a later candidate argument.
+  constexpr std::size_t States = std::size_t(1) << MaxRankedArity;
+  std::array<std::array<unsigned, States>, 2> Table;
+  const unsigned Used = 1u << M;
+  std::array<unsigned, States> *Prev = &Table[0];
+  std::array<unsigned, States> *Next = &Table[1];
+  std::fill_n(Prev->begin(), Used, NoTypeMatch);
+  (*Prev)[0] = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    std::fill_n(Next->begin(), Used, NoTypeMatch);
+    for (unsigned Mask = 0; Mask < Used; ++Mask) {
+      const unsigned Base = (*Prev)[Mask];
+      if (Base == NoTypeMatch) {
+        continue;
+      }
+      unsigned &Skip = (*Next)[Mask];
+      Skip = std::min(Skip, Base + RankCosts::MissingArg);
+      for (std::size_t j = 0; j < M; ++j) {
+        if ((Mask >> j) & 1u || Costs[i][j] == NoTypeMatch) {
+          continue;
+        }
+        const unsigned Swaps = popCount(Mask >> (j + 1));
+        unsigned &Pair = (*Next)[Mask | (1u << j)];
+        Pair =
+            std::min(Pair, Base + Costs[i][j] + Swaps * RankCosts::Reorder);
+      }
+    }
+    std::swap(Prev, Next);
+  }
+
+  // Unpaired candidate arguments are extras, except those a variadic tail
+  // absorbs after the last paired one
+  unsigned Best = NoTypeMatch;
+  for (unsigned Mask = 0; Mask < Used; ++Mask) {
+    const unsigned Cost = (*Prev)[Mask];
+    if (Cost == NoTypeMatch) {
+      continue;
+    }
+    unsigned Extras = static_cast<unsigned>(M) - popCount(Mask);
+    if (VariadicTail_) {
+      Extras = bitWidth(Mask) - popCount(Mask);
+    }
+    Best = std::min(Best, Cost + Extras * RankCosts::ExtraArg);
+  }
+  return Total + Best;
+}
+
+bool rankedBefore(const RankedMatch &A, const RankedMatch &B) {
+  return std::tie(A.Score, A.FileName, A.Line, A.Column, A.FunctionName) <
+         std::tie(B.Score, B.FileName, B.Line, B.Column, B.FunctionName);
+}
+
+void TopMatches::offer(RankedMatch Match) {
+  if (Heap_.size() < K_) {
+    Heap_.push_back(std::move(Match));
+    std::push_heap(Heap_.begin(), Heap_.end(), rankedBefore);
+    return;
+  }
+  if (K_ == 0 || !rankedBefore(Match, Heap_.front())) {
+    return;
+  }
+  std::pop_heap(Heap_.begin(), Heap_.end(), rankedBefore);
+  Heap_.back() = std::move(Match);
+  std::push_heap(Heap_.begin(), Heap_.end(), rankedBefore);
+}
+
+std::vector<RankedMatch> TopMatches::take() {
+  std::sort_heap(Heap_.begin(), Heap_.end(), rankedBefore);
+  return std::move(Heap_);
+}
+
+std::vector<RankedMatch>
+mergeTopMatches(std::vector<std::vector<RankedMatch>> Lists, std::size_t K) {
+  TopMatches Best(K);
+  for (auto &List : Lists) {
+    for (RankedMatch &Match : List) {
+      if (!Best.admits(Match.Score)) {
+        break; // Each list is best first
+      }
+      Best.offer(std::move(Match));
+    }
+  }
+  return Best.take();
+}
+
+void formatRankedMatch(OutputBuffer &Out, const colors::Palette &Colors,
+                       const RankedMatch &Match) {
+  Out.append("  ");
+  Out.append(Colors.Grey);
+  Out.append('[');
+  Out.appendUnsigned(Match.Score);
+  Out.append("] ");
+  Out.append(Colors.Reset);
+  Out.append(Colors.Blue);
+  Out.append(Match.FileName);
+  Out.append(Colors.Reset);
+  Out.append(':');
+  Out.append(Colors.Yellow);
+  Out.appendUnsigned(Match.Line);
+  Out.append(Colors.Reset);
+  Out.append(": ");
+  Out.append(Colors.Green);
+  Out.append(Match.FunctionName);
+  Out.append(Colors.Reset);
+  Out.append(' ');
+  withSignature(Match,
+                [&](const Signature &Sig) { appendSignature(Out, Sig); });
+  Out.append('\n');
+}
+
+void formatRankedMatchJson(OutputBuffer &Out, const RankedMatch &Match) {
+  withSignature(Match, [&](const Signature &Sig) {
+    Out.append('{');
+    formatMatchJsonFields(Out, {Match.FileName, Match.Line, Match.Column,
+                                Match.FunctionName, Match.Kind, &Sig});
+    Out.append(",\"score\":");
+    Out.appendUnsigned(Match.Score);
+    Out.append('}');
+  });
+}
+
+} // namespace coogle
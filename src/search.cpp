@@ -0,0 +1,605 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Search pipeline: source discovery, libclang signature extraction and
+// the per-worker visitors for search and dump.
+
+#include "coogle/search.h"
+
+#include "coogle/any_order.h"
+#include "coogle/clang_raii.h"
+#include "coogle/dump.h"
+#include "coogle/fuzzy.h"
+#include "coogle/instrument.h"
+#include "coogle/match.h"
+#include "coogle/short_names.h"
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+
+namespace fs = std::filesystem;
+
+namespace coogle {
+
+namespace {
+// Supported C/C++ file extensions
+constexpr std::array<std::string_view, 8> CppExtensions = {
+    ".c", ".cpp", ".cc", ".cxx", ".h", ".hpp", ".hh", ".hxx"};
+
+// Visitor context. Matches are formatted straight into the worker's buffer.
+struct VisitorContext {
+  const MatchProgram *Program; // Compiled query
+  AnyOrderQuery *AnyOrder;     // Used instead with --any-order
+  FuzzyQuery *Fuzzy;           // Used instead with --fuzzy-types
+  ShortNameQuery *ShortNames;  // Used instead with --short-names
+  const std::string *CurrentFile;
+  const WorkerSettings *Settings;
+  TaskResult *Result;
+  WorkerStats *Stats;        // Null unless --stats
+  SignatureStorage *Scratch; // Reused for every function of the worker
+  std::size_t Functions = 0;
+  bool FileHeaderWritten = false;
+};
+
+// Ranked search visitor context.
+struct RankContext {
+  const RankedQuery *Query;
+  TopMatches *Best;
+  const std::string *CurrentFile;
+  WorkerStats *Stats;        // Null unless --stats
+  SignatureStorage *Scratch; // Reused for every function of the worker
+  std::size_t Functions = 0;
+};
+
+// Dump visitor context.
+struct DumpContext {
+  const std::string *CurrentFile;
+  const WorkerSettings *Settings;
+  TaskResult *Result;
+  WorkerStats *Stats;        // Null unless --stats
+  SignatureStorage *Scratch; // Reused for every function of the worker
+  std::size_t Functions = 0;
+};
+
+// Returns true if Location is in the file being parsed (and not in a
+// system header). Checked on the location itself, so no file name string
+// is needed.
+bool isReportable(CXSourceLocation Location) {
+  return !COOGLE_CLANG(clang_Location_isInSystemHeader, Location) &&
+         COOGLE_CLANG(clang_Location_isFromMainFile, Location);
+}
+
+CXChildVisitResult visitor(CXCursor Cursor, [[maybe_unused]] CXCursor Parent,
+                           CXClientData ClientData) {
+  auto *Ctx = static_cast<VisitorContext *>(ClientData);
+
+  CXCursorKind Kind = COOGLE_CLANG(clang_getCursorKind, Cursor);
+  if (!isFunctionCursor(Kind)) {
+    return CXChildVisit_Recurse;
+  }
+
+  Ctx->Functions++;
+
+  // Build actual signature from libclang
+  Signature Actual;
+  {
+    PhaseTimer Timer(Ctx->Stats, Phase::Extract);
+    Ctx->Scratch->clear();
+    Actual = extractSignature(Cursor, *Ctx->Scratch);
+  }
+
+  // Check if signature matches
+  bool Matched;
+  {
+    PhaseTimer Timer(Ctx->Stats, Phase::Match);
+    if (Ctx->AnyOrder) {
+      Matched = Ctx->AnyOrder->matches(Actual);
+    } else if (Ctx->Fuzzy) {
+      Matched = Ctx->Fuzzy->matches(Actual);
+    } else if (Ctx->ShortNames) {
+      Matched = Ctx->ShortNames->matches(Actual);
+    } else {
+      Matched = Ctx->Program->matches(Actual);
+    }
+  }
+  if (!Matched) {
+    return CXChildVisit_Recurse;
+  }
+
+  // Get function location
+  CXSourceLocation Location = COOGLE_CLANG(clang_getCursorLocation, Cursor);
+
+  // Skip system headers (double protection)
+  if (COOGLE_CLANG(clang_Location_isInSystemHeader, Location)) {
+    return CXChildVisit_Continue;
+  }
+
+  // Only report results from the file we're explicitly parsing
+  if (!COOGLE_CLANG(clang_Location_isFromMainFile, Location)) {
+    return CXChildVisit_Recurse;
+  }
+
+  const WorkerSettings &Settings = *Ctx->Settings;
+  OutputBuffer &Out = Ctx->Result->Output;
+
+  switch (Settings.Mode) {
+  case ResultMode::Count:
+    // Counting needs no names, locations or formatting at all
+    Ctx->Result->MatchCount++;
+    return CXChildVisit_Continue;
+
+  case ResultMode::FilesWithMatches:
+    // One hit is enough; stop visiting the rest of this TU
+    if (Settings.Format == OutputFormat::Text) {
+      formatMatchedFile(Out, Settings.Colors, *Ctx->CurrentFile);
+    } else {
+      if (Settings.Format == OutputFormat::Json) {
+        Out.append(JsonRecordSeparator);
+      }
+      formatMatchedFileJson(Out, *Ctx->CurrentFile);
+      if (Settings.Format == OutputFormat::Ndjson) {
+        Out.append('\n');
+      }
+    }
+    Ctx->Result->MatchCount++;
+    return CXChildVisit_Break;
+
+  case ResultMode::List:
+    break;
+  }
+
+  unsigned Line = 0;
+  unsigned Column = 0;
+  COOGLE_CLANG(clang_getSpellingLocation, Location, nullptr, &Line, &Column,
+               nullptr);
+
+  // Get function name
+  CXStringRAII FuncName(COOGLE_CLANG(clang_getCursorSpelling, Cursor));
+  const char *FuncNameStr = FuncName.c_str();
+
+  // Format directly into the worker's buffer (no per-match strings)
+  switch (Settings.Format) {
+  case OutputFormat::Text:
+    if (!Ctx->FileHeaderWritten) {
+      formatFileHeader(Out, Settings.Colors, *Ctx->CurrentFile);
+      Ctx->FileHeaderWritten = true;
+    }
+    formatMatch(Out, Settings.Colors, Line, FuncNameStr, Actual);
+    break;
+  case OutputFormat::Json:
+  case OutputFormat::Ndjson:
+  case OutputFormat::Binary: {
+    const bool IsArray = Settings.Format == OutputFormat::Json;
+    if (IsArray) {
+      Out.append(JsonRecordSeparator);
+    }
+    formatMatchJson(Out, {*Ctx->CurrentFile, Line, Column, FuncNameStr,
+                          cursorKindName(Kind), &Actual});
+    if (!IsArray) {
+      Out.append('\n');
+    }
+    break;
+  }
+  }
+  Ctx->Result->MatchCount++;
+
+  return CXChildVisit_Recurse;
+}
+
+CXChildVisitResult rankVisitor(CXCursor Cursor,
+                               [[maybe_unused]] CXCursor Parent,
+                               CXClientData ClientData) {
+  auto *Ctx = static_cast<RankContext *>(ClientData);
+
+  CXCursorKind Kind = COOGLE_CLANG(clang_getCursorKind, Cursor);
+  if (!isFunctionCursor(Kind)) {
+    return CXChildVisit_Recurse;
+  }
+
+  Ctx->Functions++;
+
+  Signature Actual;
+  {
+    PhaseTimer Timer(Ctx->Stats, Phase::Extract);
+    Ctx->Scratch->clear();
+    Actual = extractSignature(Cursor, *Ctx->Scratch);
+  }
+
+  // Score only candidates whose bound could still enter the heap
+  unsigned Score;
+  {
+    PhaseTimer Timer(Ctx->Stats, Phase::Match);
+    if (!Ctx->Best->admits(Ctx->Query->lowerBound(Actual))) {
+      return CXChildVisit_Recurse;
+    }
+    Score = Ctx->Query->score(Actual);
+    if (!Ctx->Best->admits(Score)) {
+      return CXChildVisit_Recurse;
+    }
+  }
+
+  CXSourceLocation Location = COOGLE_CLANG(clang_getCursorLocation, Cursor);
+  if (COOGLE_CLANG(clang_Location_isInSystemHeader, Location)) {
+    return CXChildVisit_Continue;
+  }
+  if (!COOGLE_CLANG(clang_Location_isFromMainFile, Location)) {
+    return CXChildVisit_Recurse;
+  }
+
+  unsigned Line = 0;
+  unsigned Column = 0;
+  COOGLE_CLANG(clang_getSpellingLocation, Location, nullptr, &Line, &Column,
+               nullptr);
+  CXStringRAII FuncName(COOGLE_CLANG(clang_getCursorSpelling, Cursor));
+
+  RankedMatch Match;
+  Match.Score = Score;
+  Match.FileName = *Ctx->CurrentFile;
+  Match.Line = Line;
+  Match.Column = Column;
+  Match.FunctionName = FuncName.c_str();
+  Match.Kind = cursorKindName(Kind);
+  Match.RetType = Actual.RetType;
+  Match.ArgTypes.assign(Actual.ArgTypes.begin(), Actual.ArgTypes.end());
+  Match.VariadicTail = Actual.VariadicTail;
+  Ctx->Best->offer(std::move(Match));
+
+  return CXChildVisit_Recurse;
+}
+
+CXChildVisitResult dumpVisitor(CXCursor Cursor,
+                               [[maybe_unused]] CXCursor Parent,
+                               CXClientData ClientData) {
+  auto *Ctx = static_cast<DumpContext *>(ClientData);
+
+  CXCursorKind Kind = COOGLE_CLANG(clang_getCursorKind, Cursor);
+  if (!isFunctionCursor(Kind)) {
+    return CXChildVisit_Recurse;
+  }
+
+  CXSourceLocation Location = COOGLE_CLANG(clang_getCursorLocation, Cursor);
+  if (!isReportable(Location)) {
+    return CXChildVisit_Continue;
+  }
+
+  Ctx->Functions++;
+
+  Signature Sig;
+  {
+    PhaseTimer Timer(Ctx->Stats, Phase::Extract);
+    Ctx->Scratch->clear();
+    Sig = extractSignature(Cursor, *Ctx->Scratch);
+  }
+
+  unsigned Line = 0;
+  unsigned Column = 0;
+  COOGLE_CLANG(clang_getSpellingLocation, Location, nullptr, &Line, &Column,
+               nullptr);
+  CXStringRAII FuncName(COOGLE_CLANG(clang_getCursorSpelling, Cursor));
+
+  const MatchRecord Record{*Ctx->CurrentFile, Line,
+                           Column,            FuncName.c_str(),
+                           cursorKindName(Kind), &Sig};
+  OutputBuffer &Out = Ctx->Result->Output;
+  switch (Ctx->Settings->Format) {
+  case OutputFormat::Binary:
+    encodeDumpRecord(Out, Record);
+    break;
+  case OutputFormat::Json:
+    Out.append(JsonRecordSeparator);
+    formatDumpJson(Out, Record);
+    break;
+  case OutputFormat::Text:
+  case OutputFormat::Ndjson:
+    formatDumpJson(Out, Record);
+    Out.append('\n');
+    break;
+  }
+  Ctx->Result->MatchCount++;
+
+  return CXChildVisit_Continue;
+}
+
+// Records a parse failure in the worker's result.
+void reportFailure(TaskResult &Result, const WorkerSettings &Settings,
+                   const std::string &Filename) {
+  if (Settings.Format == OutputFormat::Text &&
+      Settings.Mode == ResultMode::List) {
+    formatParseFailure(Result.Output, Settings.Colors, Filename);
+  } else {
+    Result.Failures.push_back(Filename); // Keep stdout machine-readable
+  }
+}
+
+// Hands large buffers to the writer at file boundaries so memory stays
+// bounded and each file's records stay contiguous in the output.
+// In streaming mode the threshold is zero and every file is flushed.
+void maybeFlush(TaskResult &Result, OutputWriter &Writer,
+                const WorkerSettings &Settings, WorkerStats *Stats) {
+  if (!Result.Output.empty() &&
+      Result.Output.size() >= Settings.FlushThreshold) {
+    PhaseTimer Timer(Stats, Phase::Output);
+    Writer.write(Result.Output);
+  }
+}
+
+// Parses one file into TU, charging the time to the Parse phase.
+CXTranslationUnit parseFile(CXIndex Index, const std::string &Filename,
+                            const std::vector<const char *> &ClangArgs,
+                            WorkerStats *Stats) {
+  PhaseTimer Timer(Stats, Phase::Parse);
+  CXTranslationUnit TU = COOGLE_CLANG(
+      clang_parseTranslationUnit, Index, Filename.c_str(), ClangArgs.data(),
+      ClangArgs.size(), nullptr, 0, ParseOptions);
+  if (Stats) {
+    (TU ? Stats->FilesParsed : Stats->ParseFailures)++;
+  }
+  return TU;
+}
+
+// Total memory held by a translation unit, as reported by libclang.
+std::uint64_t tuMemoryBytes(CXTranslationUnit TU) {
+  CXTUResourceUsage Usage = COOGLE_CLANG(clang_getCXTUResourceUsage, TU);
+  std::uint64_t Total = 0;
+  for (unsigned i = 0; i < Usage.numEntries; ++i) {
+    Total += Usage.entries[i].amount;
+  }
+  COOGLE_CLANG(clang_disposeCXTUResourceUsage, Usage);
+  return Total;
+}
+
+// Parses every file in Files and hands each translation unit to Visit,
+// which returns the number of function cursors it saw. Owns the parts
+// shared by search and dump: the per-thread index, failure reporting,
+// flushing, --stats accounting, --trace spans and --profile-files rows.
+template <typename VisitFn>
+TaskResult runWorker(const std::vector<std::string> &Files,
+                     const std::vector<const char *> &ClangArgs,
+                     OutputWriter &Writer, const WorkerSettings &Settings,
+                     VisitFn Visit) {
+  TaskResult Result;
+  WorkerStats *Stats = Settings.CollectStats ? &Result.Stats : nullptr;
+  if (Settings.CollectTrace) {
+    Result.Trace = std::make_unique<TraceBuffer>(Files);
+  }
+  TraceBuffer *Trace = Result.Trace.get();
+  const bool Profile = Settings.CollectProfile;
+  const bool NeedTimes = Trace || Profile; // Per-file timestamps
+  const std::uint64_t StartNs = Stats ? wallNowNs() : 0;
+
+  // Hardware counters are per thread, so each worker opens its own; they
+  // take in any thread libclang starts for the parse
+  std::optional<PerfCounters> Counters;
+  if (Stats && Settings.CollectPerf) {
+    Counters.emplace(/*CountChildThreads=*/true);
+  }
+  PerfThreadScope PerfScope(Counters && Counters->available() ? &*Counters
+                                                                : nullptr);
+
+  // Each thread needs its own index to avoid contention
+  CXIndexRAII Index;
+  if (!Index.isValid()) {
+    std::cerr << "Error creating Clang index in worker thread\n";
+    return Result;
+  }
+
+  for (std::size_t FileIndex = 0; FileIndex < Files.size(); ++FileIndex) {
+    const std::string &Filename = Files[FileIndex];
+    const std::uint64_t ParseStartNs = NeedTimes ? wallNowNs() : 0;
+    CXTranslationUnitRAII TU(parseFile(Index, Filename, ClangArgs, Stats));
+    const std::uint64_t ParseEndNs = NeedTimes ? wallNowNs() : 0;
+
+    std::uint64_t Bytes = 0;
+    if (Trace) {
+      std::error_code Ec;
+      Bytes = fs::file_size(Filename, Ec);
+      if (Ec) {
+        Bytes = 0;
+      }
+      Trace->record({"parse", FileIndex, ParseStartNs,
+                     ParseEndNs - ParseStartNs, Bytes, 0});
+    }
+
+    if (!TU.isValid()) {
+      reportFailure(Result, Settings, Filename);
+      if (Profile) {
+        // Failed parses still cost time; keep them visible in the report
+        Result.Profile.push_back({Filename, ParseEndNs - ParseStartNs});
+      }
+      continue;
+    }
+
+    std::size_t Functions;
+    {
+      PhaseTimer Timer(Stats, Phase::Visit);
+      Functions = Visit(TU, Filename, Result, Stats);
+    }
+    if (Stats) {
+      Stats->FunctionsVisited += Functions;
+    }
+    const std::uint64_t VisitEndNs = NeedTimes ? wallNowNs() : 0;
+    if (Trace) {
+      Trace->record({"visit", FileIndex, ParseEndNs,
+                     VisitEndNs - ParseEndNs, Bytes, Functions});
+    }
+    if (Profile) {
+      Result.Profile.push_back({Filename, ParseEndNs - ParseStartNs,
+                                VisitEndNs - ParseEndNs, tuMemoryBytes(TU),
+                                Functions});
+    }
+
+    maybeFlush(Result, Writer, Settings, Stats);
+  }
+
+  if (Stats) {
+    Stats->Matches = Result.MatchCount;
+    Stats->BusyNs = wallNowNs() - StartNs;
+  }
+  return Result;
+}
+
+} // anonymous namespace
+
+std::vector<std::string> findSourceFiles(const fs::path &Path) {
+  std::vector<std::string> Files;
+
+  if (fs::is_regular_file(Path)) {
+    // Single file mode
+    Files.push_back(Path.string());
+  } else if (fs::is_directory(Path)) {
+    // Directory mode - recursive search
+    for (const auto &Entry : fs::recursive_directory_iterator(
+             Path, fs::directory_options::skip_permission_denied)) {
+      if (Entry.is_regular_file()) {
+        auto Ext = Entry.path().extension().string();
+        if (std::find(CppExtensions.begin(), CppExtensions.end(), Ext) !=
+            CppExtensions.end()) {
+          Files.push_back(Entry.path().string());
+        }
+      }
+    }
+  }
+
+  return Files;
+}
+
+std::vector<std::string> defaultClangArgs() {
+  return {
+      "-x",          "c++",
+      "-nostdinc",   // Don't search standard system directories
+      "-nostdinc++", // Don't search standard C++ directories
+  };
+}
+
+void parseOnCallingThread() { ::setenv("LIBCLANG_NOTHREADS", "1", 1); }
+
+Signature extractSignature(CXCursor Cursor, SignatureStorage &Storage) {
+  // Get return type (canonicalized for semantic type matching)
+  CXType RetType = COOGLE_CLANG(clang_getCursorResultType, Cursor);
+  assert(RetType.kind != CXType_Invalid &&
+         "Invalid return type obtained from libclang");
+  CXType CanonicalRetType = COOGLE_CLANG(clang_getCanonicalType, RetType);
+  CXString RetSpelling =
+      COOGLE_CLANG(clang_getTypeSpelling, CanonicalRetType);
+  std::string_view RetTypeSV = COOGLE_CLANG(clang_getCString, RetSpelling);
+  std::string_view RetTypeInterned = Storage.internString(RetTypeSV);
+  std::string_view RetTypeNorm =
+      normalizeType(Storage.arena(), RetTypeInterned);
+  COOGLE_CLANG(clang_disposeString, RetSpelling);
+
+  // Get arguments
+  int NumArgs = COOGLE_CLANG(clang_Cursor_getNumArguments, Cursor);
+  Storage.reserveArgs(NumArgs);
+
+  for (int ArgIdx = 0; ArgIdx < NumArgs; ++ArgIdx) {
+    CXCursor ArgCursor =
+        COOGLE_CLANG(clang_Cursor_getArgument, Cursor, ArgIdx);
+    if (COOGLE_CLANG(clang_equalCursors, ArgCursor, clang_getNullCursor())) {
+      continue; // Skip invalid arguments (e.g. variadic args sometimes cause
+                // issues)
+    }
+    CXType ArgType = COOGLE_CLANG(clang_getCursorType, ArgCursor);
+    assert(ArgType.kind != CXType_Invalid &&
+           "Invalid argument type obtained from libclang");
+    CXType CanonicalArgType = COOGLE_CLANG(clang_getCanonicalType, ArgType);
+    CXString TypeSpelling =
+        COOGLE_CLANG(clang_getTypeSpelling, CanonicalArgType);
+
+    std::string_view ArgTypeSV = COOGLE_CLANG(clang_getCString, TypeSpelling);
+    std::string_view ArgTypeInterned = Storage.internString(ArgTypeSV);
+    std::string_view ArgTypeNorm =
+        normalizeType(Storage.arena(), ArgTypeInterned);
+    Storage.addArg(ArgTypeInterned, ArgTypeNorm);
+
+    COOGLE_CLANG(clang_disposeString, TypeSpelling);
+  }
+
+  // Build signature struct
+  Signature Actual;
+  Actual.RetType = RetTypeInterned;
+  Actual.RetTypeNorm = RetTypeNorm;
+  Actual.ArgTypes = Storage.getArgs();
+  Actual.ArgTypesNorm = Storage.getArgsNorm();
+  Actual.VariadicTail = COOGLE_CLANG(clang_Cursor_isVariadic, Cursor) != 0;
+  return Actual;
+}
+
+TaskResult processFiles(const std::vector<std::string> &Files,
+                        const Signature &TargetSig,
+                        const std::vector<const char *> &ClangArgs,
+                        OutputWriter &Writer, const WorkerSettings &Settings) {
+  const MatchProgram Program(TargetSig);
+  std::optional<AnyOrderQuery> AnyOrder;
+  if (Settings.AnyOrder) {
+    AnyOrder.emplace(TargetSig);
+  }
+  AnyOrderQuery *AnyOrderPtr = AnyOrder ? &*AnyOrder : nullptr;
+  std::optional<FuzzyQuery> Fuzzy;
+  if (Settings.FuzzyEdits > 0) {
+    Fuzzy.emplace(TargetSig, Settings.FuzzyEdits);
+  }
+  FuzzyQuery *FuzzyPtr = Fuzzy ? &*Fuzzy : nullptr;
+  std::optional<ShortNameQuery> ShortNames;
+  if (Settings.ShortNames) {
+    ShortNames.emplace(TargetSig);
+  }
+  ShortNameQuery *ShortNamesPtr = ShortNames ? &*ShortNames : nullptr;
+  SignatureStorage Scratch;
+  return runWorker(Files, ClangArgs, Writer, Settings,
+                   [&](CXTranslationUnit TU, const std::string &Filename,
+                       TaskResult &Result, WorkerStats *Stats) {
+                     VisitorContext Ctx{&Program,      AnyOrderPtr,
+                                        FuzzyPtr,      ShortNamesPtr,
+                                        &Filename,     &Settings,
+                                        &Result,       Stats,
+                                        &Scratch};
+                     CXCursor Root =
+                         COOGLE_CLANG(clang_getTranslationUnitCursor, TU);
+                     COOGLE_CLANG(clang_visitChildren, Root, visitor, &Ctx);
+                     return Ctx.Functions;
+                   });
+}
+
+TaskResult rankFiles(const std::vector<std::string> &Files,
+                     const Signature &TargetSig, std::size_t K,
+                     const std::vector<const char *> &ClangArgs,
+                     OutputWriter &Writer, const WorkerSettings &Settings) {
+  const RankedQuery Query(TargetSig);
+  TopMatches Best(K);
+  SignatureStorage Scratch;
+  TaskResult Result = runWorker(
+      Files, ClangArgs, Writer, Settings,
+      [&](CXTranslationUnit TU, const std::string &Filename,
+          TaskResult &, WorkerStats *Stats) {
+        RankContext Ctx{&Query, &Best, &Filename, Stats, &Scratch};
+        CXCursor Root = COOGLE_CLANG(clang_getTranslationUnitCursor, TU);
+        COOGLE_CLANG(clang_visitChildren, Root, rankVisitor, &Ctx);
+        return Ctx.Functions;
+      });
+  Result.Ranked = Best.take();
+  Result.MatchCount = Result.Ranked.size();
+  if (Settings.CollectStats) {
+    Result.Stats.Matches = Result.MatchCount;
+  }
+  return Result;
+}
+
+TaskResult dumpFiles(const std::vector<std::string> &Files,
+                     const std::vector<const char *> &ClangArgs,
+                     OutputWriter &Writer, const WorkerSettings &Settings) {
+  SignatureStorage Scratch;
+  return runWorker(Files, ClangArgs, Writer, Settings,
+                   [&](CXTranslationUnit TU, const std::string &Filename,
+                       TaskResult &Result, WorkerStats *Stats) {
+                     DumpContext Ctx{&Filename, &Settings, &Result, Stats,
+                                     &Scratch};
+                     CXCursor Root =
+                         COOGLE_CLANG(clang_getTranslationUnitCursor, TU);
+                     COOGLE_CLANG(clang_visitChildren, Root, dumpVisitor, &Ctx);
+                     return Ctx.Functions;
+                   });
+}
+
+} // namespace coogle
@@ -0,0 +1,251 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Qualified-name suffix index and the --short-names matcher.
+
+#include "coogle/short_names.h"
+
+#include <algorithm>
+
+namespace coogle {
+
+namespace {
+
+// Cached verdicts of ShortNameQuery::TypeCheck.
+enum Verdict : std::uint8_t { NotChecked, Match, NoMatch };
+
+// Splits Name at the "::" outside any brackets: "std::vector<a::b>::size"
+// is "std", "vector<a::b>", "size".
+void splitQualifiedName(std::string_view Name,
+                        std::vector<std::string_view> &Components) {
+  Components.clear();
+  int Depth = 0;
+  std::size_t Start = 0;
+  for (std::size_t i = 0; i < Name.size(); ++i) {
+    const char C = Name[i];
+    if (C == '<' || C == '(' || C == '[') {
+      ++Depth;
+    } else if (C == '>' || C == ')' || C == ']') {
+      --Depth;
+    } else if (C == ':' && Depth == 0 && i + 1 < Name.size() &&
+               Name[i + 1] == ':') {
+      Components.push_back(Name.substr(Start, i - Start));
+      Start = i + 2;
+      ++i;
+    }
+  }
+  Components.push_back(Name.substr(Start));
+}
+
+// Matches a pattern tree against a candidate tree of the same table.
+// NameMatches decides the names (Leaf patterns); template names are
+// compared by suffix.
+template <typename NameMatchFn>
+bool matchTrees(const TypeNode &Pattern, const TypeNode &Actual,
+                TypeBindings &Bindings, NameMatchFn NameMatches) {
+  switch (Pattern.Kind) {
+  case TypeKind::Wildcard:
+    return true;
+  case TypeKind::Variable:
+    return Bindings.bind(Pattern.Slot, Actual.Text);
+  case TypeKind::Leaf:
+    return NameMatches(Pattern, Actual);
+  case TypeKind::Pointer:
+  case TypeKind::LValueRef:
+  case TypeKind::RValueRef:
+    return Actual.Kind == Pattern.Kind &&
+           matchTrees(*Pattern.Children.front(), *Actual.Children.front(),
+                      Bindings, NameMatches);
+  case TypeKind::Template:
+    if (Actual.Kind != TypeKind::Template ||
+        Actual.Children.size() != Pattern.Children.size() ||
+        !isQualifiedSuffix(Pattern.Name, Actual.Name)) {
+      return false;
+    }
+    for (std::size_t i = 0; i < Pattern.Children.size(); ++i) {
+      if (!matchTrees(*Pattern.Children[i], *Actual.Children[i], Bindings,
+                      NameMatches)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+} // anonymous namespace
+
+bool isQualifiedSuffix(std::string_view Suffix, std::string_view Name) {
+  if (Suffix.size() > Name.size()) {
+    return false;
+  }
+  std::vector<std::string_view> SuffixParts;
+  std::vector<std::string_view> NameParts;
+  splitQualifiedName(Suffix, SuffixParts);
+  splitQualifiedName(Name, NameParts);
+  if (SuffixParts.size() > NameParts.size()) {
+    return false;
+  }
+  return std::equal(SuffixParts.rbegin(), SuffixParts.rend(),
+                    NameParts.rbegin());
+}
+
+void TypeIdSet::insert(std::uint32_t Id) {
+  const std::size_t Word = Id / 64;
+  if (Word >= Words_.size()) {
+    Words_.resize(Word + 1);
+  }
+  Words_[Word] |= std::uint64_t(1) << (Id % 64);
+}
+
+TypeNameIndex::TypeNameIndex() { Nodes_.emplace_back(); }
+
+std::uint32_t TypeNameIndex::child(std::uint32_t Parent,
+                                   std::string_view Component) {
+  auto [It, Inserted] = Nodes_[Parent].Children.try_emplace(
+      Component, static_cast<std::uint32_t>(Nodes_.size()));
+  if (Inserted) {
+    Nodes_.emplace_back();
+  }
+  return It->second;
+}
+
+void TypeNameIndex::insert(std::string_view Name, std::uint32_t Id) {
+  std::vector<std::string_view> Components;
+  splitQualifiedName(Name, Components);
+  std::uint32_t Node = 0;
+  for (auto It = Components.rbegin(); It != Components.rend(); ++It) {
+    Node = child(Node, *It);
+    Nodes_[Node].Ids.insert(Id);
+  }
+}
+
+const TypeIdSet &TypeNameIndex::lookup(std::string_view Suffix) {
+  std::vector<std::string_view> Components;
+  splitQualifiedName(Suffix, Components);
+  std::uint32_t Node = 0;
+  for (auto It = Components.rbegin(); It != Components.rend(); ++It) {
+    Node = child(Node, *It);
+  }
+  return Nodes_[Node].Ids;
+}
+
+bool isShortNameMatch(const Signature &Query, const Signature &Actual) {
+  const std::size_t Arity = Query.ArgTypesNorm.size();
+  if (!isArityMatch(Arity, Query.VariadicTail, Actual.ArgTypesNorm.size())) {
+    return false;
+  }
+
+  TypeTable Types;
+  TypeBindings Bindings;
+  auto NameMatches = [](const TypeNode &Pattern, const TypeNode &Type) {
+    return Type.Kind == TypeKind::Leaf &&
+           isQualifiedSuffix(Pattern.Text, Type.Text);
+  };
+  auto TypeMatches = [&](std::string_view Expected, std::string_view Type) {
+    return matchTrees(*Types.intern(Expected), *Types.intern(Type), Bindings,
+                      NameMatches);
+  };
+
+  if (!isWildcardType(Query.RetType) &&
+      !TypeMatches(Query.RetTypeNorm, Actual.RetTypeNorm)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < Arity; ++i) {
+    if (!isWildcardType(Query.ArgTypes[i]) &&
+        !TypeMatches(Query.ArgTypesNorm[i], Actual.ArgTypesNorm[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ShortNameQuery::ShortNameQuery(const Signature &Query)
+    : Arity_(Query.ArgTypesNorm.size()), VariadicTail_(Query.VariadicTail) {
+  auto Compile = [&](std::string_view Original, std::string_view Norm) {
+    TypeCheck Check;
+    if (!isWildcardType(Original)) {
+      Check.Pattern = &internType(Norm);
+      Check.Cached = !hasTypeVariable(Norm);
+    }
+    Checks_.push_back(std::move(Check));
+  };
+  Compile(Query.RetType, Query.RetTypeNorm);
+  for (std::size_t i = 0; i < Arity_; ++i) {
+    Compile(Query.ArgTypes[i], Query.ArgTypesNorm[i]);
+  }
+
+  // Only query nodes are ever patterns
+  Resolved_.resize(Types_.size());
+  for (const TypeCheck &Check : Checks_) {
+    if (Check.Pattern) {
+      resolveNames(*Check.Pattern);
+    }
+  }
+}
+
+const TypeNode &ShortNameQuery::internType(std::string_view NormType) {
+  const TypeNode *Node = Types_.intern(NormType);
+  for (; Indexed_ < Types_.size(); ++Indexed_) {
+    const TypeNode &New = Types_.node(static_cast<std::uint32_t>(Indexed_));
+    if (New.Kind == TypeKind::Leaf) {
+      Names_.insert(New.Text, New.Id);
+    }
+  }
+  return *Node;
+}
+
+void ShortNameQuery::resolveNames(const TypeNode &Pattern) {
+  if (Pattern.Kind == TypeKind::Leaf) {
+    Resolved_[Pattern.Id] = &Names_.lookup(Pattern.Text);
+    return;
+  }
+  for (const TypeNode *Child : Pattern.Children) {
+    resolveNames(*Child);
+  }
+}
+
+bool ShortNameQuery::checkType(TypeCheck &Check, std::string_view ActualNorm,
+                               TypeBindings &Bindings) {
+  if (!Check.Pattern) {
+    return true;
+  }
+  if (Check.Cached && ActualNorm == Check.Pattern->Text) {
+    return true;
+  }
+  const TypeNode &Actual = internType(ActualNorm);
+  auto NameMatches = [this](const TypeNode &Pattern, const TypeNode &Type) {
+    return Resolved_[Pattern.Id]->contains(Type.Id);
+  };
+  if (!Check.Cached) {
+    return matchTrees(*Check.Pattern, Actual, Bindings, NameMatches);
+  }
+  if (Actual.Id >= Check.Verdicts.size()) {
+    Check.Verdicts.resize(Types_.size(), NotChecked);
+  }
+  std::uint8_t &Cached = Check.Verdicts[Actual.Id];
+  if (Cached == NotChecked) {
+    Cached = matchTrees(*Check.Pattern, Actual, Bindings, NameMatches)
+                 ? Match
+                 : NoMatch;
+  }
+  return Cached == Match;
+}
+
+bool ShortNameQuery::matches(const Signature &Actual) {
+  const span<std::string_view> Args = Actual.ArgTypesNorm;
+  if (!isArityMatch(Arity_, VariadicTail_, Args.size())) {
+    return false;
+  }
+  TypeBindings Bindings;
+  if (!checkType(Checks_[0], Actual.RetTypeNorm, Bindings)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < Arity_; ++i) {
+    if (!checkType(Checks_[i + 1], Args[i], Bindings)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace coogle
@@ -0,0 +1,193 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Pipeline instrumentation for --stats.
+
+#include "coogle/stats.h"
+
+#include <chrono>
+#include <ctime>
+#include <fmt/core.h>
+#include <sys/resource.h>
+
+namespace coogle {
+
+namespace {
+constexpr double NsPerMs = 1e6;
+constexpr double NsPerSec = 1e9;
+
+std::uint64_t timevalNs(const timeval &Tv) {
+  return static_cast<std::uint64_t>(Tv.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(Tv.tv_usec) * 1000ULL;
+}
+
+double toMs(std::uint64_t Ns) { return static_cast<double>(Ns) / NsPerMs; }
+
+// Appends the hardware counter table for the sampled phases.
+void formatPerfCounters(OutputBuffer &Out, const WorkerStats &Total,
+                        const std::string &Error) {
+  bool Any = false;
+  for (const PerfCounts &Counts : Total.Perf) {
+    Any = Any || Counts.anyValid();
+  }
+  if (!Any) {
+    Out.append(fmt::format("\nperf counters unavailable ({})\n",
+                           Error.empty() ? "no samples" : Error));
+    return;
+  }
+
+  Out.append(fmt::format("\n{:<20} {:>14} {:>14} {:>6} {:>12} {:>12}\n",
+                         "phase", "cycles", "instructions", "IPC",
+                         "cache miss", "branch miss"));
+  for (std::size_t i = 0; i < NumPhases; ++i) {
+    const auto P = static_cast<Phase>(i);
+    if (!isPerfSampled(P)) {
+      continue;
+    }
+    const PerfCounts &C = Total.Perf[i];
+    auto Cell = [&](PerfEvent Event) {
+      return C.valid(Event) ? fmt::format("{}", C[Event]) : std::string("-");
+    };
+    const bool HasIpc = C.valid(PerfEvent::Cycles) &&
+                        C.valid(PerfEvent::Instructions) &&
+                        C[PerfEvent::Cycles] > 0;
+    const std::string Ipc =
+        HasIpc ? fmt::format("{:.2f}",
+                             static_cast<double>(C[PerfEvent::Instructions]) /
+                                 static_cast<double>(C[PerfEvent::Cycles]))
+               : "-";
+    Out.append(fmt::format("{:<20} {:>14} {:>14} {:>6} {:>12} {:>12}\n",
+                           phaseName(P), Cell(PerfEvent::Cycles),
+                           Cell(PerfEvent::Instructions), Ipc,
+                           Cell(PerfEvent::CacheMisses),
+                           Cell(PerfEvent::BranchMisses)));
+  }
+  if (!Error.empty()) {
+    Out.append(fmt::format("(some counters unavailable: {})\n", Error));
+  }
+}
+
+} // anonymous namespace
+
+const char *phaseName(Phase P) {
+  switch (P) {
+  case Phase::Discovery:
+    return "discovery";
+  case Phase::QueryParse:
+    return "query parse";
+  case Phase::Parse:
+    return "libclang parse";
+  case Phase::Visit:
+    return "AST visit";
+  case Phase::Extract:
+    return "  type extraction";
+  case Phase::Match:
+    return "  matching";
+  case Phase::Output:
+    return "output";
+  }
+  return "unknown";
+}
+
+WorkerStats &WorkerStats::operator+=(const WorkerStats &Other) {
+  for (std::size_t i = 0; i < NumPhases; ++i) {
+    Phases[i].WallNs += Other.Phases[i].WallNs;
+    Phases[i].CpuNs += Other.Phases[i].CpuNs;
+    Perf[i] += Other.Perf[i];
+  }
+  FilesParsed += Other.FilesParsed;
+  ParseFailures += Other.ParseFailures;
+  FunctionsVisited += Other.FunctionsVisited;
+  Matches += Other.Matches;
+  BusyNs += Other.BusyNs;
+  return *this;
+}
+
+std::uint64_t wallNowNs() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+
+std::uint64_t threadCpuNowNs() {
+  timespec Ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Ts) != 0) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(Ts.tv_sec) * 1000000000ULL +
+         static_cast<std::uint64_t>(Ts.tv_nsec);
+}
+
+ProcessUsage currentProcessUsage() {
+  ProcessUsage Usage;
+  rusage Ru;
+  if (getrusage(RUSAGE_SELF, &Ru) != 0) {
+    return Usage;
+  }
+  Usage.UserCpuNs = timevalNs(Ru.ru_utime);
+  Usage.SystemCpuNs = timevalNs(Ru.ru_stime);
+#ifdef __APPLE__
+  Usage.PeakRssBytes = static_cast<std::uint64_t>(Ru.ru_maxrss); // bytes
+#else
+  Usage.PeakRssBytes = static_cast<std::uint64_t>(Ru.ru_maxrss) * 1024; // KiB
+#endif
+  return Usage;
+}
+
+void formatStatsReport(OutputBuffer &Out, const StatsReport &Report) {
+  WorkerStats Total = Report.Main;
+  for (const auto &Worker : Report.Workers) {
+    Total += Worker;
+  }
+
+  const double WallSec = static_cast<double>(Report.TotalWallNs) / NsPerSec;
+  const double FilesPerSec =
+      WallSec > 0 ? static_cast<double>(Report.NumFiles) / WallSec : 0;
+
+  Out.append("\n── Statistics ──────────────────────────────\n");
+  Out.append(fmt::format("{:<20} {:>12} {:>12}\n", "phase", "wall ms",
+                         "cpu ms"));
+  for (std::size_t i = 0; i < NumPhases; ++i) {
+    const auto P = static_cast<Phase>(i);
+    Out.append(fmt::format("{:<20} {:>12.2f} {:>12.2f}\n", phaseName(P),
+                           toMs(Total[P].WallNs), toMs(Total[P].CpuNs)));
+  }
+  Out.append("(worker phases are summed over all workers)\n");
+  // parseOnCallingThread() made this measurable; plain runs also pay for
+  // libclang's per-file helper thread, which the parse row leaves out
+  Out.append("(libclang parse runs on the worker thread under --stats)\n\n");
+
+  Out.append(fmt::format("{:<20} {:>12.2f} ms\n", "total wall",
+                         toMs(Report.TotalWallNs)));
+  Out.append(fmt::format("{:<20} {:>12.2f} ms user, {:.2f} ms sys\n",
+                         "process cpu", toMs(Report.Usage.UserCpuNs),
+                         toMs(Report.Usage.SystemCpuNs)));
+  Out.append(fmt::format("{:<20} {:>12}\n", "files", Report.NumFiles));
+  Out.append(fmt::format("{:<20} {:>12.1f}\n", "files/sec", FilesPerSec));
+  Out.append(fmt::format("{:<20} {:>12}\n", "parse failures",
+                         Total.ParseFailures));
+  Out.append(fmt::format("{:<20} {:>12}\n", "functions visited",
+                         Total.FunctionsVisited));
+  Out.append(fmt::format("{:<20} {:>12}\n", "matches", Total.Matches));
+  Out.append(fmt::format(
+      "{:<20} {:>12.1f} MiB\n", "peak RSS",
+      static_cast<double>(Report.Usage.PeakRssBytes) / (1024.0 * 1024.0)));
+
+  if (Report.PerfRequested) {
+    formatPerfCounters(Out, Total, Report.PerfError);
+  }
+
+  Out.append(fmt::format("\n{:<8} {:>8} {:>12} {:>12}\n", "worker", "files",
+                         "busy ms", "idle ms"));
+  for (std::size_t i = 0; i < Report.Workers.size(); ++i) {
+    const WorkerStats &Worker = Report.Workers[i];
+    const std::uint64_t IdleNs = Report.ParallelWallNs > Worker.BusyNs
+                                     ? Report.ParallelWallNs - Worker.BusyNs
+                                     : 0;
+    Out.append(fmt::format("{:<8} {:>8} {:>12.2f} {:>12.2f}\n", i,
+                           Worker.FilesParsed + Worker.ParseFailures,
+                           toMs(Worker.BusyNs), toMs(IdleNs)));
+  }
+}
+
+} // namespace coogle
@@ -0,0 +1,84 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Chrome trace-event export for --trace.
+
+#include "coogle/trace.h"
+
+#include <fmt/core.h>
+#include <iostream>
+
+namespace coogle {
+
+namespace {
+constexpr double NsPerUs = 1e3;
+
+double toUs(std::uint64_t Ns) { return static_cast<double>(Ns) / NsPerUs; }
+
+// Appends one complete ("X") event.
+void appendEvent(OutputBuffer &Out, const TraceBuffer &Track,
+                 const TraceEvent &Event, std::size_t Tid,
+                 std::uint64_t EpochNs) {
+  const std::uint64_t StartNs =
+      Event.StartNs > EpochNs ? Event.StartNs - EpochNs : 0;
+  Out.append("{\"name\":");
+  appendJsonString(Out, Event.Name);
+  Out.append(",\"cat\":\"coogle\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+  Out.appendUnsigned(Tid);
+  Out.append(fmt::format(",\"ts\":{:.3f},\"dur\":{:.3f}", toUs(StartNs),
+                         toUs(Event.DurNs)));
+  Out.append(",\"args\":{\"file\":");
+  appendJsonString(Out, Track.file(Event));
+  Out.append(",\"bytes\":");
+  Out.appendUnsigned(Event.Bytes);
+  Out.append(",\"functions\":");
+  Out.appendUnsigned(Event.Functions);
+  Out.append("}}");
+}
+} // anonymous namespace
+
+void formatChromeTrace(OutputBuffer &Out,
+                       const std::vector<const TraceBuffer *> &Tracks,
+                       std::uint64_t EpochNs) {
+  Out.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+  // Metadata events name the tracks so they read "worker N" in the UI
+  Out.append("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+             "\"args\":{\"name\":\"coogle\"}}");
+  for (std::size_t Tid = 0; Tid < Tracks.size(); ++Tid) {
+    Out.append(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":");
+    Out.appendUnsigned(Tid);
+    Out.append(",\"args\":{\"name\":\"worker ");
+    Out.appendUnsigned(Tid);
+    Out.append("\"}}");
+  }
+
+  for (std::size_t Tid = 0; Tid < Tracks.size(); ++Tid) {
+    Tracks[Tid]->forEach([&](const TraceEvent &Event) {
+      Out.append(",\n");
+      appendEvent(Out, *Tracks[Tid], Event, Tid, EpochNs);
+    });
+  }
+
+  Out.append("\n]}\n");
+}
+
+bool writeChromeTrace(const std::string &Path,
+                      const std::vector<const TraceBuffer *> &Tracks,
+                      std::uint64_t EpochNs) {
+  std::size_t Dropped = 0;
+  for (const TraceBuffer *Track : Tracks) {
+    Dropped += Track->dropped();
+  }
+  if (Dropped > 0) {
+    std::cerr << fmt::format(
+        "✖ Warning: Trace buffers overflowed; the {} oldest events were "
+        "dropped\n",
+        Dropped);
+  }
+
+  OutputBuffer Out;
+  formatChromeTrace(Out, Tracks, EpochNs);
+  return writeFileContents(Path, Out, "trace");
+}
+
+} // namespace coogle
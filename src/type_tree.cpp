@@ -0,0 +1,324 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Type tree parsing, hash-consing and structural matching.
+
+#include "coogle/type_tree.h"
+
+namespace coogle {
+
+namespace {
+
+bool endsWith(std::string_view Str, std::string_view Suffix) {
+  return Str.size() >= Suffix.size() &&
+         Str.substr(Str.size() - Suffix.size()) == Suffix;
+}
+
+// The sigil and a capital letter at I, followed by the end of the type, a
+// template argument or a pointer or reference layer.
+bool isVariableAt(std::string_view Type, std::size_t I) {
+  if (Type[I] != TypeVariableSigil || I + 1 == Type.size() ||
+      Type[I + 1] < 'A' || Type[I + 1] > 'Z') {
+    return false;
+  }
+  return I + 2 == Type.size() ||
+         std::string_view(">,*&").find(Type[I + 2]) != std::string_view::npos;
+}
+
+// TypeBindings slot of the type variable Var.
+std::uint8_t variableSlot(std::string_view Var) {
+  return static_cast<std::uint8_t>(Var[1] - 'A');
+}
+
+// Splits "Name<Args>" at the '<' matching the final '>'.
+// Fails for anything else, e.g. "A<int>::B" or unbalanced brackets.
+bool splitTemplate(std::string_view Type, std::string_view &Name,
+                   std::string_view &Args) {
+  if (Type.empty() || Type.back() != '>') {
+    return false;
+  }
+  int Depth = 0;
+  for (std::size_t i = Type.size(); i-- > 0;) {
+    const char C = Type[i];
+    if (C == '>' || C == ')' || C == ']') {
+      ++Depth;
+    } else if (C == '<' || C == '(' || C == '[') {
+      if (--Depth == 0) {
+        if (C != '<' || i == 0) {
+          return false;
+        }
+        Name = Type.substr(0, i);
+        Args = Type.substr(i + 1, Type.size() - i - 2);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Pops the next top-level template argument off Args.
+// Fails on an empty argument or unbalanced brackets.
+bool nextTemplateArg(std::string_view &Args, std::string_view &Arg) {
+  int Depth = 0;
+  std::size_t End = 0;
+  for (; End < Args.size(); ++End) {
+    const char C = Args[End];
+    if (C == '<' || C == '(' || C == '[') {
+      ++Depth;
+    } else if (C == '>' || C == ')' || C == ']') {
+      if (--Depth < 0) {
+        return false;
+      }
+    } else if (C == ',' && Depth == 0) {
+      break;
+    }
+  }
+  if (Depth != 0 || End == 0) {
+    return false;
+  }
+  Arg = Args.substr(0, End);
+  Args = End < Args.size() ? Args.substr(End + 1) : std::string_view();
+  return true;
+}
+
+// The outermost layer of a normalized type. Inner is the referent or
+// pointee, or the template name (arguments in Args).
+TypeKind outerLayer(std::string_view Type, std::string_view &Inner,
+                    std::string_view &Args) {
+  if (Type == "*") {
+    return TypeKind::Wildcard;
+  }
+  if (isTypeVariable(Type)) {
+    return TypeKind::Variable;
+  }
+  if (Type.size() > 2 && endsWith(Type, "&&")) {
+    Inner = Type.substr(0, Type.size() - 2);
+    return TypeKind::RValueRef;
+  }
+  if (Type.size() > 1 && (Type.back() == '&' || Type.back() == '*')) {
+    Inner = Type.substr(0, Type.size() - 1);
+    return Type.back() == '&' ? TypeKind::LValueRef : TypeKind::Pointer;
+  }
+  if (splitTemplate(Type, Inner, Args)) {
+    return TypeKind::Template;
+  }
+  return TypeKind::Leaf;
+}
+
+// A "*" that starts the type or one of its template arguments.
+bool hasStructuralWildcard(std::string_view Type) {
+  for (std::size_t i = Type.find('*'); i != std::string_view::npos;
+       i = Type.find('*', i + 1)) {
+    if (i == 0 || Type[i - 1] == '<' || Type[i - 1] == ',') {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Bindings is null when the query has no type variables; equal text then
+// matches without looking for them.
+bool matchLayers(std::string_view Pattern, std::string_view Actual,
+                 TypeBindings *Bindings) {
+  if (Pattern == "*") {
+    return true;
+  }
+  if (!Bindings) {
+    if (Pattern == Actual) {
+      return true;
+    }
+    if (!hasStructuralWildcard(Pattern)) {
+      return false;
+    }
+  } else if (isTypeVariable(Pattern)) {
+    return Bindings->bind(variableSlot(Pattern), Actual);
+  } else if (!hasTypeWildcard(Pattern)) {
+    // Equal text is not enough: the variables in it must still be bound
+    return Pattern == Actual;
+  }
+  std::string_view PatternInner, PatternArgs, ActualInner, ActualArgs;
+  const TypeKind Kind = outerLayer(Pattern, PatternInner, PatternArgs);
+  if (Kind == TypeKind::Leaf) {
+    return Pattern == Actual;
+  }
+  if (outerLayer(Actual, ActualInner, ActualArgs) != Kind) {
+    return false;
+  }
+  if (Kind != TypeKind::Template) {
+    return matchLayers(PatternInner, ActualInner, Bindings);
+  }
+  if (PatternInner != ActualInner) {
+    return false;
+  }
+  std::string_view PatternArg, ActualArg;
+  while (nextTemplateArg(PatternArgs, PatternArg)) {
+    if (!nextTemplateArg(ActualArgs, ActualArg) ||
+        !matchLayers(PatternArg, ActualArg, Bindings)) {
+      return false;
+    }
+  }
+  // Leftover pattern text: the tree keeps such a type as one Leaf
+  return PatternArgs.empty() && ActualArgs.empty();
+}
+
+} // anonymous namespace
+
+const TypeNode *TypeTable::intern(std::string_view NormType) {
+  auto It = ByText_.find(NormType);
+  if (It != ByText_.end()) {
+    return It->second;
+  }
+  // Subtrees are views into the owned copy of the outermost type
+  return internView(Texts_.emplace_back(NormType));
+}
+
+const TypeNode *TypeTable::internView(std::string_view NormType) {
+  auto It = ByText_.find(NormType);
+  if (It != ByText_.end()) {
+    return It->second;
+  }
+
+  TypeNode Node;
+  Node.Text = NormType;
+  std::string_view Inner, Args;
+  Node.Kind = outerLayer(NormType, Inner, Args);
+  switch (Node.Kind) {
+  case TypeKind::Leaf:
+    break;
+  case TypeKind::Wildcard:
+    Node.HasWildcard = true;
+    break;
+  case TypeKind::Variable:
+    Node.HasWildcard = true;
+    Node.Slot = variableSlot(NormType);
+    break;
+  case TypeKind::Pointer:
+  case TypeKind::LValueRef:
+  case TypeKind::RValueRef:
+    Node.Children.push_back(internView(Inner));
+    break;
+  case TypeKind::Template: {
+    std::string_view Arg;
+    std::string_view Rest = Args;
+    while (nextTemplateArg(Rest, Arg)) {
+      Node.Children.push_back(internView(Arg));
+    }
+    if (!Rest.empty() || Node.Children.empty()) {
+      // Not a well-formed argument list: keep it whole
+      Node.Kind = TypeKind::Leaf;
+      Node.Children.clear();
+      break;
+    }
+    Node.Name = Inner;
+    break;
+  }
+  }
+  for (const TypeNode *Child : Node.Children) {
+    Node.HasWildcard |= Child->HasWildcard;
+  }
+
+  Node.Id = static_cast<std::uint32_t>(Nodes_.size());
+  const TypeNode *Result = &Nodes_.emplace_back(std::move(Node));
+  ByText_.emplace(NormType, Result);
+  return Result;
+}
+
+bool isTypeVariable(std::string_view NormType) {
+  return NormType.size() == 2 && isVariableAt(NormType, 0);
+}
+
+bool hasTypeVariable(std::string_view NormType) {
+  for (std::size_t i = NormType.find(TypeVariableSigil);
+       i != std::string_view::npos;
+       i = NormType.find(TypeVariableSigil, i + 1)) {
+    if ((i == 0 || NormType[i - 1] == '<' || NormType[i - 1] == ',') &&
+        isVariableAt(NormType, i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool hasTypeWildcard(std::string_view NormType) {
+  return hasStructuralWildcard(NormType) || hasTypeVariable(NormType);
+}
+
+bool matchesType(const TypeNode &Pattern, std::string_view ActualNorm,
+                 TypeBindings &Bindings) {
+  if (!Pattern.HasWildcard) {
+    return Pattern.Text == ActualNorm;
+  }
+  const std::size_t Size = ActualNorm.size();
+  switch (Pattern.Kind) {
+  case TypeKind::Wildcard:
+    return true;
+  case TypeKind::Variable:
+    return Bindings.bind(Pattern.Slot, ActualNorm);
+  case TypeKind::Pointer:
+  case TypeKind::LValueRef: {
+    const char Suffix = Pattern.Kind == TypeKind::Pointer ? '*' : '&';
+    if (Size < 2 || ActualNorm.back() != Suffix ||
+        (Suffix == '&' && Size > 2 && ActualNorm[Size - 2] == '&')) {
+      return false;
+    }
+    return matchesType(*Pattern.Children.front(),
+                       ActualNorm.substr(0, Size - 1), Bindings);
+  }
+  case TypeKind::RValueRef:
+    if (Size < 3 || !endsWith(ActualNorm, "&&")) {
+      return false;
+    }
+    return matchesType(*Pattern.Children.front(),
+                       ActualNorm.substr(0, Size - 2), Bindings);
+  case TypeKind::Template: {
+    // Name<...>: the arguments must then split cleanly, which also makes
+    // this '<' the one matching the final '>'
+    const std::string_view Name = Pattern.Name;
+    if (Size < Name.size() + 2 || ActualNorm[Name.size()] != '<' ||
+        ActualNorm.back() != '>' || ActualNorm.substr(0, Name.size()) != Name) {
+      return false;
+    }
+    std::string_view Args =
+        ActualNorm.substr(Name.size() + 1, Size - Name.size() - 2);
+    std::string_view Arg;
+    for (const TypeNode *Child : Pattern.Children) {
+      if (!nextTemplateArg(Args, Arg) ||
+          !matchesType(*Child, Arg, Bindings)) {
+        return false;
+      }
+    }
+    return Args.empty();
+  }
+  case TypeKind::Leaf:
+    break;
+  }
+  return false;
+}
+
+bool matchesType(const TypeNode &Pattern, std::string_view ActualNorm) {
+  TypeBindings Bindings;
+  return matchesType(Pattern, ActualNorm, Bindings);
+}
+
+bool isTypeMatch(std::string_view PatternNorm, std::string_view ActualNorm,
+                 TypeBindings &Bindings) {
+  if (!hasTypeWildcard(PatternNorm)) {
+    return PatternNorm == ActualNorm;
+  }
+  return matchLayers(PatternNorm, ActualNorm, &Bindings);
+}
+
+bool isTypeMatch(std::string_view PatternNorm, std::string_view ActualNorm) {
+  // Without a wildcard this is the plain comparison. With one, equal text
+  // binds every variable to itself, which is consistent within one type.
+  if (PatternNorm == ActualNorm) {
+    return true;
+  }
+  if (!hasTypeVariable(PatternNorm)) {
+    return hasStructuralWildcard(PatternNorm) &&
+           matchLayers(PatternNorm, ActualNorm, nullptr);
+  }
+  TypeBindings Bindings;
+  return matchLayers(PatternNorm, ActualNorm, &Bindings);
+}
+
+} // namespace coogle
@@ -72,3 +72,8 @@ bool processData(const std::string &label, void *data, size_t size) {
     std::cout << "Processing " << size << " bytes with label: " << label << std::endl;
     return true;
 }
+
+// Variadic logging
+int logMessage(const char *format, ...) {
+    return format ? 0 : -1;
+}
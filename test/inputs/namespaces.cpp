@@ -0,0 +1,20 @@
+// Test file for type names qualified by namespaces and classes
+namespace llvm {
+struct StringRef {};
+
+StringRef trim(StringRef S) { return S; }
+
+class Twine {
+public:
+  enum Kind { Empty, Str };
+};
+
+Twine::Kind kindOf(const Twine &T) { return Twine::Empty; }
+} // namespace llvm
+
+// Same name in another namespace
+namespace clang {
+struct StringRef {};
+
+StringRef trim(StringRef S) { return S; }
+} // namespace clang
@@ -0,0 +1,120 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Counting replacements of the global allocation functions (test-only).
+
+#include "alloc_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+#ifdef __GLIBC__
+// glibc exports its allocator under these names, so the public symbols
+// can be interposed from the executable.
+extern "C" {
+void *__libc_malloc(std::size_t Size);
+void *__libc_calloc(std::size_t Count, std::size_t Size);
+void *__libc_realloc(void *Ptr, std::size_t Size);
+}
+#endif
+
+namespace {
+// Trivially constructible, so reading them never allocates
+thread_local std::size_t News = 0;
+thread_local std::size_t Mallocs = 0;
+thread_local std::size_t Bytes = 0;
+
+// The system allocator, bypassing the counting malloc below.
+void *rawMalloc(std::size_t Size) {
+#ifdef __GLIBC__
+  return __libc_malloc(Size);
+#else
+  return std::malloc(Size);
+#endif
+}
+
+void *countedNew(std::size_t Size) {
+  News++;
+  Bytes += Size;
+  if (void *Ptr = rawMalloc(Size == 0 ? 1 : Size)) {
+    return Ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *countedAlignedNew(std::size_t Size, std::align_val_t Align) {
+  News++;
+  Bytes += Size;
+  const std::size_t Alignment = static_cast<std::size_t>(Align);
+  // aligned_alloc needs a size that is a multiple of the alignment
+  const std::size_t Rounded = (Size + Alignment - 1) / Alignment * Alignment;
+  if (void *Ptr = std::aligned_alloc(Alignment, Rounded == 0 ? Alignment
+                                                             : Rounded)) {
+    return Ptr;
+  }
+  throw std::bad_alloc();
+}
+} // anonymous namespace
+
+namespace coogle::test {
+AllocationCounts threadAllocationCounts() { return {News, Mallocs, Bytes}; }
+} // namespace coogle::test
+
+#ifdef __GLIBC__
+extern "C" {
+void *malloc(std::size_t Size) noexcept {
+  Mallocs++;
+  Bytes += Size;
+  return __libc_malloc(Size);
+}
+
+void *calloc(std::size_t Count, std::size_t Size) noexcept {
+  Mallocs++;
+  Bytes += Count * Size;
+  return __libc_calloc(Count, Size);
+}
+
+void *realloc(void *Ptr, std::size_t Size) noexcept {
+  Mallocs++;
+  Bytes += Size;
+  return __libc_realloc(Ptr, Size);
+}
+}
+#endif
+
+void *operator new(std::size_t Size) { return countedNew(Size); }
+void *operator new[](std::size_t Size) { return countedNew(Size); }
+void *operator new(std::size_t Size, const std::nothrow_t &) noexcept {
+  try {
+    return countedNew(Size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void *operator new[](std::size_t Size, const std::nothrow_t &) noexcept {
+  try {
+    return countedNew(Size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void *operator new(std::size_t Size, std::align_val_t Align) {
+  return countedAlignedNew(Size, Align);
+}
+void *operator new[](std::size_t Size, std::align_val_t Align) {
+  return countedAlignedNew(Size, Align);
+}
+
+void operator delete(void *Ptr) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, std::size_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, std::size_t) noexcept { std::free(Ptr); }
+void operator delete(void *Ptr, std::align_val_t) noexcept { std::free(Ptr); }
+void operator delete[](void *Ptr, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete(void *Ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
+void operator delete[](void *Ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(Ptr);
+}
@@ -0,0 +1,42 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Test-only heap allocation accounting for coogle_test.
+//
+// alloc_counter.cpp replaces the global operator new family (and, on
+// glibc, malloc/calloc/realloc) with versions that bump thread-local
+// counters before forwarding to the system allocator. Allocations made by
+// libclang through these entry points are counted too, but only on the
+// calling thread: libclang parses translation units on a helper thread.
+
+#pragma once
+
+#include <cstddef>
+
+namespace coogle::test {
+
+struct AllocationCounts {
+  std::size_t News = 0;    // operator new / new[] calls
+  std::size_t Mallocs = 0; // malloc / calloc / realloc calls (glibc only)
+  std::size_t Bytes = 0;   // Bytes requested by either
+
+  std::size_t total() const { return News + Mallocs; }
+};
+
+// Counts for the calling thread since it started.
+AllocationCounts threadAllocationCounts();
+
+// Allocations made by the calling thread during the scope's lifetime.
+class AllocationScope {
+  AllocationCounts Start_;
+
+public:
+  AllocationScope() : Start_(threadAllocationCounts()) {}
+
+  AllocationCounts counts() const {
+    const AllocationCounts Now = threadAllocationCounts();
+    return {Now.News - Start_.News, Now.Mallocs - Start_.Mallocs,
+            Now.Bytes - Start_.Bytes};
+  }
+};
+
+} // namespace coogle::test
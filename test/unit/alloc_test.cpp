@@ -0,0 +1,139 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Allocation budgets for the hot path (see alloc_counter.h).
+
+#include "alloc_counter.h"
+#include "coogle/parser.h"
+#include "coogle/search.h"
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+constexpr std::string_view Types[] = {
+    "int",
+    "const char *",
+    "const std::basic_string<char, std::char_traits<char>, "
+    "std::allocator<char> > &",
+    "std::map<std::basic_string<char>, std::vector<int> > &",
+};
+
+// Runs a text search for Query over test/inputs/example.c, discarding the
+// output, and returns the calling thread's allocations and the number of
+// functions visited.
+std::pair<AllocationCounts, std::size_t> visitExample(std::string_view Query,
+                                                      ResultMode Mode) {
+  SignatureStorage Storage;
+  const Signature Target = *parseFunctionSignature(Storage, Query);
+  const std::vector<std::string> ArgsVec = defaultClangArgs();
+  std::vector<const char *> ClangArgs;
+  for (const auto &S : ArgsVec) {
+    ClangArgs.push_back(S.c_str());
+  }
+  const std::vector<std::string> Files = {COOGLE_TEST_INPUTS_DIR
+                                          "/example.c"};
+  const int NullFd = ::open("/dev/null", O_WRONLY);
+  OutputWriter Writer(NullFd);
+  const WorkerSettings Settings{Mode, OutputFormat::Text,
+                                colors::palette(false), OutputFlushThreshold,
+                                /*CollectStats=*/true};
+
+  AllocationScope Scope;
+  TaskResult Result =
+      processFiles(Files, Target, ClangArgs, Writer, Settings);
+  const AllocationCounts Counts = Scope.counts();
+  ::close(NullFd);
+  return {Counts, Result.Stats.FunctionsVisited};
+}
+} // anonymous namespace
+
+// The hook itself sees both allocation paths. The volatile sinks keep the
+// compiler from eliding the new/delete and malloc/free pairs.
+TEST(AllocTest, CountsAllocations) {
+  static int *volatile IntSink;
+  AllocationScope Scope;
+  IntSink = new int(1);
+  delete IntSink;
+  EXPECT_EQ(Scope.counts().News, 1u);
+  EXPECT_GE(Scope.counts().Bytes, sizeof(int));
+#ifdef __GLIBC__
+  static void *volatile RawSink;
+  RawSink = std::malloc(16);
+  std::free(RawSink);
+  EXPECT_EQ(Scope.counts().Mallocs, 1u);
+#endif
+}
+
+// Normalization writes into the arena; once it has capacity, nothing else
+// touches the heap
+TEST(AllocTest, NormalizeTypeIsAllocationFree) {
+  StringArena Arena;
+  for (std::string_view Type : Types) {
+    normalizeType(Arena, Type);
+  }
+  Arena.clear();
+
+  AllocationScope Scope;
+  for (std::string_view Type : Types) {
+    normalizeType(Arena, Type);
+  }
+  EXPECT_EQ(Scope.counts().total(), 0u);
+}
+
+TEST(AllocTest, SignatureMatchIsAllocationFree) {
+  SignatureStorage UserStorage;
+  SignatureStorage ActualStorage;
+  auto User = parseFunctionSignature(UserStorage, "void(*, const char *)");
+  auto Actual =
+      parseFunctionSignature(ActualStorage, "void(int *, const char *)");
+  ASSERT_TRUE(User && Actual);
+
+  AllocationScope Scope;
+  bool Matched = true;
+  for (int i = 0; i < 100; ++i) {
+    Matched = isSignatureMatch(*User, *Actual) && Matched;
+  }
+  EXPECT_TRUE(Matched);
+  EXPECT_EQ(Scope.counts().total(), 0u);
+}
+
+// A fresh storage costs its arena and argument buffers; a reused one costs
+// nothing
+TEST(AllocTest, ParseFunctionSignatureBudget) {
+  const std::string_view Query =
+      "bool(const std::map<std::string, std::vector<int>> &, size_t)";
+  {
+    AllocationScope Scope;
+    SignatureStorage Storage;
+    ASSERT_TRUE(parseFunctionSignature(Storage, Query));
+    EXPECT_LE(Scope.counts().total(), 3u);
+  }
+
+  SignatureStorage Storage;
+  ASSERT_TRUE(parseFunctionSignature(Storage, Query));
+  Storage.clear();
+  AllocationScope Scope;
+  ASSERT_TRUE(parseFunctionSignature(Storage, Query));
+  EXPECT_EQ(Scope.counts().total(), 0u);
+}
+
+// A full visitor pass. operator new is only hit for per-worker setup:
+// signature extraction reuses the worker's storage, so the count must not
+// grow with the number of functions. libclang's own strings (type and
+// cursor spellings) go through malloc and are bounded per function.
+TEST(AllocTest, VisitorPassBudget) {
+  constexpr std::size_t SetupNews = 12;
+  constexpr std::size_t MallocsPerFunction = 16;
+  for (ResultMode Mode : {ResultMode::List, ResultMode::Count}) {
+    const auto [Counts, Functions] = visitExample("int(int, int)", Mode);
+    ASSERT_GT(Functions, 0u);
+    EXPECT_LE(Counts.News, SetupNews);
+#ifdef __GLIBC__
+    EXPECT_LE(Counts.Mallocs, MallocsPerFunction * Functions);
+#endif
+  }
+}
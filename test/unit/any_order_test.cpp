@@ -0,0 +1,117 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for argument-order-insensitive matching (--any-order).
+
+#include "coogle/any_order.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+const QueryMode AnyOrder{compileAs<AnyOrderQuery>(), isAnyOrderMatch};
+
+bool anyOrder(std::string_view Query, std::string_view Actual) {
+  return AnyOrder.matches(Query, Actual);
+}
+
+const std::vector<std::string_view> Corpus = {
+    "void()",
+    "int(int)",
+    "int(int, int)",
+    "void(char *, int)",
+    "void(int, char *)",
+    "void(const char *, unsigned long)",
+    "void(int, const char *, void *)",
+    "std::string(int, const std::string &)",
+    "bool(const std::map<std::string, std::vector<int>> &, size_t)",
+    "bool(size_t, const std::map<std::string, int> &)",
+    "void(std::vector<int> &, std::vector<long> &, int)",
+    "void(int, char *, int, double)",
+    "int(const char *, ...)",
+};
+
+const std::vector<std::string_view> Queries = {
+    "void()",
+    "int(int, int)",
+    "void(int, char *)",
+    "void(int, *)",
+    "void(*, *, int)",
+    "*(int, ...)",
+    "*(char *, int, int, double)",
+    "bool(std::map<std::string, *> &, size_t)",
+    "void(std::vector<*> &, std::vector<int> &, *)",
+    "void(std::vector<*> &, std::vector<long> &, ...)",
+    "void(std::vector<?T> &, std::vector<?U> &, *)",
+    "?T(?T, ?T)",
+    "std::string(const std::string &, int)",
+    "int(const char *)",
+};
+} // anonymous namespace
+
+TEST(AnyOrderTest, MultisetHash) {
+  Signatures Sigs;
+  const Signature A = Sigs.parse("void(int, char *, int)");
+  const Signature B = Sigs.parse("void(char *, int, int)");
+  const Signature C = Sigs.parse("void(char *, char *, int)");
+  EXPECT_EQ(argMultisetHash(A.ArgTypesNorm), argMultisetHash(B.ArgTypesNorm));
+  EXPECT_NE(argMultisetHash(A.ArgTypesNorm), argMultisetHash(C.ArgTypesNorm));
+  EXPECT_NE(argMultisetHash(A.ArgTypesNorm),
+            argMultisetHash(Sigs.parse("void(int, char *)").ArgTypesNorm));
+  EXPECT_EQ(argMultisetHash(Sigs.parse("void()").ArgTypesNorm), 0u);
+
+  // IDs depend on the table, the hash only on the types
+  TypeTable First;
+  TypeTable Second;
+  Second.intern("double");
+  ArgMultiset FromFirst;
+  ArgMultiset FromSecond;
+  buildArgMultiset(First, A.ArgTypesNorm, FromFirst);
+  buildArgMultiset(Second, B.ArgTypesNorm, FromSecond);
+  EXPECT_EQ(FromFirst.Hash, FromSecond.Hash);
+  EXPECT_NE(FromFirst.Ids, FromSecond.Ids);
+  ASSERT_EQ(FromFirst.Ids.size(), 3u);
+  EXPECT_TRUE(std::is_sorted(FromFirst.Ids.begin(), FromFirst.Ids.end()));
+  EXPECT_EQ(FromFirst.Ids[0], FromFirst.Ids[1]); // int twice
+}
+
+TEST(AnyOrderTest, Matches) {
+  EXPECT_TRUE(anyOrder("void(int, char *)", "void(char *, int)"));
+  EXPECT_TRUE(anyOrder("void(const Foo &, int)", "void(int, Foo &)"));
+  EXPECT_FALSE(anyOrder("void(int, char *)", "int(char *, int)"));
+  EXPECT_FALSE(anyOrder("void(int, int)", "void(int, char *)"));
+  EXPECT_FALSE(anyOrder("void(int, char *)", "void(int, char *, int)"));
+
+  // Wildcards and a tail absorb whatever the concrete types leave
+  EXPECT_TRUE(anyOrder("void(int, *)", "void(double, int)"));
+  EXPECT_TRUE(anyOrder("*(Foo &, ...)", "bool(int, Foo &, char)"));
+  EXPECT_FALSE(anyOrder("*(Foo &, ...)", "bool(int, char)"));
+
+  // Patterns take the leftovers, whichever order they come in
+  EXPECT_TRUE(anyOrder("void(std::vector<*>, * *)",
+                       "void(char *, std::vector<int>)"));
+  EXPECT_TRUE(anyOrder("void(std::vector<*>, std::vector<int>)",
+                       "void(std::vector<int>, std::vector<long>)"));
+  EXPECT_FALSE(anyOrder("void(std::vector<*>, std::vector<int>)",
+                        "void(std::vector<int>, char *)"));
+  EXPECT_TRUE(anyOrder("void(* *, char *)", "void(char *, int *)"));
+
+  // Type variables bind across the chosen order
+  EXPECT_TRUE(anyOrder("void(?T *, size_t, ?T)", "void(size_t, int, int *)"));
+  EXPECT_FALSE(anyOrder("void(?T *, size_t, ?T)", "void(size_t, int, char *)"));
+  EXPECT_TRUE(anyOrder("?T(?T *, ?U *)", "int(char *, int *)"));
+}
+
+INSTANTIATE_TEST_SUITE_P(AnyOrderTest, CompiledMatchesReference,
+                         ::testing::Values(ReferenceCase{"Default", AnyOrder,
+                                                         Queries, Corpus}),
+                         referenceCaseName);
+
+INSTANTIATE_TEST_SUITE_P(
+    AnyOrderTest, ProcessFilesOnInputs,
+    ::testing::Values(InputsCase{"example.c", "bool(int, void *, const int &)",
+                                 [](WorkerSettings &S) { S.AnyOrder = true; },
+                                 0, 1})); // processData
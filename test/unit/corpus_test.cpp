@@ -0,0 +1,122 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the synthetic benchmark corpus generator.
+
+#include "corpus.h"
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unistd.h>
+
+using namespace coogle;
+using namespace coogle::corpus;
+namespace fs = std::filesystem;
+
+namespace {
+// Generates Config in memory, keyed by relative path.
+std::map<std::string, std::string> generate(const CorpusConfig &Config,
+                                            CorpusSummary *Summary = nullptr) {
+  std::map<std::string, std::string> Files;
+  CorpusSummary S = generateCorpus(
+      Config, defaultCorpusQueries(),
+      [&](const std::string &Path, const std::string &Contents) {
+        Files.emplace(Path, Contents);
+      });
+  if (Summary) {
+    *Summary = S;
+  }
+  return Files;
+}
+} // anonymous namespace
+
+// A seed fully determines the corpus
+TEST(CorpusTest, Deterministic) {
+  CorpusConfig Config = *corpusPreset("small");
+  EXPECT_EQ(generate(Config), generate(Config));
+
+  CorpusConfig Other = Config;
+  Other.Seed = 2;
+  EXPECT_NE(generate(Config), generate(Other));
+}
+
+TEST(CorpusTest, LayoutAndTotals) {
+  CorpusConfig Config;
+  Config.NumFiles = 7;
+  Config.FilesPerDirectory = 3;
+  Config.HeaderRatio = 0;
+  CorpusSummary Summary;
+  auto Files = generate(Config, &Summary);
+
+  ASSERT_EQ(Files.size(), 7u);
+  EXPECT_EQ(Files.begin()->first, "d000/f00000.cpp");
+  EXPECT_EQ(Files.rbegin()->first, "d002/f00006.cpp");
+  EXPECT_EQ(Summary.Files, 7u);
+
+  std::uint64_t Bytes = 0;
+  for (const auto &[Path, Contents] : Files) {
+    Bytes += Contents.size();
+    EXPECT_NE(Contents.find("namespace corpus {"), std::string::npos) << Path;
+  }
+  EXPECT_EQ(Summary.Bytes, Bytes);
+  EXPECT_GE(Summary.Functions, Summary.Files);
+}
+
+// Expected counts are consistent with the queries' relationships
+TEST(CorpusTest, ExpectedMatches) {
+  CorpusSummary Summary;
+  generate(*corpusPreset("small"), &Summary);
+
+  std::map<std::string, std::size_t> Expected(Summary.Expected.begin(),
+                                              Summary.Expected.end());
+  ASSERT_EQ(Expected.size(), defaultCorpusQueries().size());
+  EXPECT_GT(Expected["void(*)"], 0u);
+  EXPECT_GT(Expected["int(int, int)"], 0u);
+  EXPECT_LE(Expected["void(int)"], Expected["void(*)"]);
+  EXPECT_LT(Expected["void(*)"], Summary.Functions);
+}
+
+TEST(CorpusTest, Manifest) {
+  CorpusConfig Config = *corpusPreset("small");
+  CorpusSummary Summary;
+  generate(Config, &Summary);
+
+  OutputBuffer Out;
+  formatManifest(Out, Config, Summary);
+  const std::string_view Json = Out.view();
+  const std::string_view Prefix = "{\"generator\":\"coogle_corpus\",\"seed\":1,";
+  EXPECT_EQ(Json.substr(0, Prefix.size()), Prefix);
+  EXPECT_NE(Json.find("\"functions_per_file\":20"), std::string_view::npos);
+  EXPECT_NE(Json.find("{\"query\":\"int(int, int)\",\"matches\":"),
+            std::string_view::npos);
+}
+
+TEST(CorpusTest, UnknownPreset) {
+  EXPECT_FALSE(corpusPreset("chromium").has_value());
+}
+
+// Regenerating over an older corpus leaves only the new files; a directory
+// holding anything else is refused
+TEST(CorpusTest, WriteReplacesOldCorpus) {
+  const fs::path Root = fs::temp_directory_path() /
+                        ("coogle_corpus_test_" + std::to_string(::getpid()));
+  fs::remove_all(Root);
+  CorpusConfig Config;
+  Config.NumFiles = 6;
+  Config.FilesPerDirectory = 2;
+  ASSERT_TRUE(writeCorpus(Config, {}, Root).has_value());
+  Config.NumFiles = 2;
+  ASSERT_TRUE(writeCorpus(Config, {}, Root).has_value());
+
+  std::size_t Files = 0;
+  for (const auto &Entry : fs::recursive_directory_iterator(Root)) {
+    Files += Entry.is_regular_file();
+  }
+  EXPECT_EQ(Files, 3u); // Two sources and the manifest
+
+  std::ofstream(Root / "notes.txt") << "mine";
+  EXPECT_FALSE(writeCorpus(Config, {}, Root).has_value());
+  EXPECT_TRUE(fs::exists(Root / "notes.txt"));
+  fs::remove_all(Root);
+}
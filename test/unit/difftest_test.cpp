@@ -0,0 +1,69 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the differential tester.
+
+#include "difftest.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::bench;
+
+TEST(DiffTest, ParseMatchLine) {
+  auto Key = parseMatchLine(
+      R"json({"file":"dir/a \"b\".cpp","line":12,"column":5,)json"
+      R"json("name":"add","signature":"int(int, int)","kind":"function"})json");
+  ASSERT_TRUE(Key.has_value());
+  EXPECT_EQ(Key->File, "dir/a \"b\".cpp");
+  EXPECT_EQ(Key->Line, 12u);
+  EXPECT_EQ(Key->Column, 5u);
+  EXPECT_EQ(Key->Name, "add");
+
+  auto Escaped = parseMatchLine(
+      R"({"file":"a\\b\u0001.cpp","line":1,"column":2,"name":"f"})");
+  ASSERT_TRUE(Escaped.has_value());
+  EXPECT_EQ(Escaped->File, "a\\b\x01.cpp");
+
+  EXPECT_FALSE(parseMatchLine(R"({"file":"a.cpp"})").has_value());
+  EXPECT_FALSE(parseMatchLine(R"({"file":"a.cpp,"line":1)").has_value());
+  EXPECT_FALSE(parseMatchLine("").has_value());
+}
+
+// Multiset semantics: a duplicated record is an extra
+TEST(DiffTest, DiffMatches) {
+  std::vector<MatchKey> Reference = {{"b.cpp", 3, 1, "g"},
+                                     {"a.cpp", 1, 1, "f"},
+                                     {"a.cpp", 9, 1, "h"}};
+  std::vector<MatchKey> Actual = {{"a.cpp", 1, 1, "f"},
+                                  {"a.cpp", 1, 1, "f"},
+                                  {"b.cpp", 3, 1, "g"}};
+  std::vector<Mismatch> Out;
+  diffMatches(Reference, Actual, "parallel", "void(*)", Out);
+  ASSERT_EQ(Out.size(), 2u);
+  EXPECT_EQ(Out[0].Path, "parallel");
+  EXPECT_EQ(Out[0].Query, "void(*)");
+  EXPECT_EQ(Out[0].Detail, "missing a.cpp:9:1 h");
+  EXPECT_EQ(Out[1].Detail, "extra a.cpp:1:1 f");
+
+  Out.clear();
+  diffMatches(Reference, Reference, "dump", "void(*)", Out);
+  EXPECT_TRUE(Out.empty());
+}
+
+// Every path agrees on the checked-in inputs
+TEST(DiffTest, InputsAgree) {
+  DiffConfig Config;
+  Config.Queries = {"int(int, int)", "void(*)", "int(*)"};
+  Config.NumThreads = 2;
+  auto Report = runDiffTest({COOGLE_TEST_INPUTS_DIR "/example.c",
+                             COOGLE_TEST_INPUTS_DIR "/type_alias_test.cpp"},
+                            Config);
+  ASSERT_TRUE(Report.has_value());
+  EXPECT_GT(Report->ReferenceMatches, 0u);
+  for (const Mismatch &M : Report->Mismatches) {
+    ADD_FAILURE() << M.Path << " '" << M.Query << "': " << M.Detail;
+  }
+
+  OutputBuffer Out;
+  formatDiffReport(Out, *Report);
+  EXPECT_NE(Out.view().find("✓ 6 paths agree"), std::string_view::npos);
+}
@@ -0,0 +1,155 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the `coogle dump` record encodings.
+
+#include "coogle/dump.h"
+#include "coogle/parser.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+using namespace coogle;
+
+// Test the NDJSON dump object
+TEST(DumpTest, JsonRecord) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "int(int, const char *)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  formatDumpJson(Out, {"a.cpp", 6, 5, "add", "function", &*Sig});
+  EXPECT_EQ(Out.view(),
+            "{\"file\":\"a.cpp\",\"line\":6,\"column\":5,\"name\":\"add\","
+            "\"signature\":\"int(int, const char *)\",\"kind\":\"function\","
+            "\"return\":\"int\",\"args\":[\"int\",\"const char *\"]}");
+
+  SignatureStorage Storage2;
+  Sig = parseFunctionSignature(Storage2, "void()");
+  ASSERT_TRUE(Sig.has_value());
+  Out.clear();
+  formatDumpJson(Out, {"b.cpp", 1, 1, "f", "method", &*Sig});
+  EXPECT_EQ(Out.view(),
+            "{\"file\":\"b.cpp\",\"line\":1,\"column\":1,\"name\":\"f\","
+            "\"signature\":\"void()\",\"kind\":\"method\","
+            "\"return\":\"void\",\"args\":[]}");
+}
+
+// Test that binary records round-trip through the decoder
+TEST(DumpTest, BinaryRoundTrip) {
+  SignatureStorage StorageA, StorageB;
+  auto A = parseFunctionSignature(StorageA, "std::string(const std::string &)");
+  auto B = parseFunctionSignature(StorageB, "void()");
+  ASSERT_TRUE(A && B);
+
+  OutputBuffer Out;
+  encodeDumpRecord(Out, {"src/greet.cpp", 15, 13, "greet", "function", &*A});
+  encodeDumpRecord(Out, {"src/x.h", 70000, 2, "run", "method", &*B});
+
+  std::string_view In = Out.view();
+  auto First = decodeDumpRecord(In);
+  ASSERT_TRUE(First.has_value());
+  EXPECT_EQ(First->FileName, "src/greet.cpp");
+  EXPECT_EQ(First->Line, 15u);
+  EXPECT_EQ(First->Column, 13u);
+  EXPECT_EQ(First->FunctionName, "greet");
+  EXPECT_EQ(First->Kind, "function");
+  EXPECT_EQ(First->RetType, "std::string");
+  ASSERT_EQ(First->ArgTypes.size(), 1u);
+  EXPECT_EQ(First->ArgTypes[0], "const std::string &");
+
+  auto Second = decodeDumpRecord(In);
+  ASSERT_TRUE(Second.has_value());
+  EXPECT_EQ(Second->Line, 70000u);
+  EXPECT_EQ(Second->Kind, "method");
+  EXPECT_TRUE(Second->ArgTypes.empty());
+  EXPECT_TRUE(In.empty());
+}
+
+// Test that the variadic tail survives both encodings
+TEST(DumpTest, VariadicRecord) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "int(const char *, ...)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  formatDumpJson(Out, {"a.c", 77, 5, "logMessage", "function", &*Sig});
+  EXPECT_EQ(Out.view(),
+            "{\"file\":\"a.c\",\"line\":77,\"column\":5,"
+            "\"name\":\"logMessage\","
+            "\"signature\":\"int(const char *, ...)\",\"kind\":\"function\","
+            "\"return\":\"int\",\"args\":[\"const char *\"],"
+            "\"variadic\":true}");
+
+  Out.clear();
+  encodeDumpRecord(Out, {"a.c", 77, 5, "logMessage", "function", &*Sig});
+  std::string_view In = Out.view();
+  auto Record = decodeDumpRecord(In);
+  ASSERT_TRUE(Record.has_value());
+  EXPECT_TRUE(Record->Variadic);
+  ASSERT_EQ(Record->ArgTypes.size(), 1u);
+}
+
+// Test that extracted C variadics keep their tail in the dump
+TEST(DumpTest, ExtractsVariadic) {
+  const coogle::test::DefaultClangArgs ClangArgs;
+  char Path[] = "/tmp/coogle_dump_testXXXXXX";
+  const int Fd = ::mkstemp(Path);
+  ASSERT_GE(Fd, 0);
+  {
+    OutputWriter Writer(Fd);
+    const WorkerSettings Settings{ResultMode::List, OutputFormat::Ndjson,
+                                  colors::palette(false), 0};
+    TaskResult Result =
+        dumpFiles({COOGLE_TEST_INPUTS_DIR "/example.c"}, ClangArgs.get(),
+                  Writer, Settings);
+    Writer.write(Result.Output);
+  }
+  std::string Text;
+  char Chunk[4096];
+  ssize_t Read = 0;
+  ::lseek(Fd, 0, SEEK_SET);
+  while ((Read = ::read(Fd, Chunk, sizeof(Chunk))) > 0) {
+    Text.append(Chunk, static_cast<std::size_t>(Read));
+  }
+  ::close(Fd);
+  ::unlink(Path);
+
+  EXPECT_NE(Text.find("\"name\":\"logMessage\","
+                      "\"signature\":\"int(const char *, ...)\""),
+            std::string::npos);
+  EXPECT_NE(Text.find("\"args\":[\"const char *\"],\"variadic\":true}"),
+            std::string::npos);
+  EXPECT_EQ(Text.find("\"variadic\"", Text.find("\"variadic\"") + 1),
+            std::string::npos); // logMessage is the only variadic function
+}
+
+// Test that truncated or corrupt input is rejected without advancing
+TEST(DumpTest, BinaryRejectsTruncatedInput) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "int(int)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  encodeDumpRecord(Out, {"a.c", 1, 1, "f", "function", &*Sig});
+
+  for (size_t Cut = 0; Cut < Out.size(); ++Cut) {
+    std::string_view In = Out.view().substr(0, Cut);
+    EXPECT_FALSE(decodeDumpRecord(In).has_value()) << "cut at " << Cut;
+    EXPECT_EQ(In.size(), Cut);
+  }
+
+  // Invalid kind byte (offset: size + line + column)
+  std::string Corrupt(Out.view());
+  Corrupt[12] = 7;
+  std::string_view In = Corrupt;
+  EXPECT_FALSE(decodeDumpRecord(In).has_value());
+
+  // Unknown flag bit (the byte after the kind)
+  Corrupt = std::string(Out.view());
+  Corrupt[13] = 2;
+  In = Corrupt;
+  EXPECT_FALSE(decodeDumpRecord(In).has_value());
+}
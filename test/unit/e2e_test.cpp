@@ -0,0 +1,84 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the end-to-end benchmark statistics and report.
+
+#include "e2e.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::bench;
+
+// Nearest-rank percentiles over unsorted samples
+TEST(E2ETest, Percentiles) {
+  std::vector<std::uint64_t> Samples;
+  for (std::uint64_t i = 100; i >= 1; --i) {
+    Samples.push_back(i);
+  }
+  const Percentiles P = summarize(Samples);
+  EXPECT_EQ(P.MinNs, 1u);
+  EXPECT_EQ(P.MedianNs, 50u);
+  EXPECT_EQ(P.P90Ns, 90u);
+  EXPECT_EQ(P.P99Ns, 99u);
+  EXPECT_EQ(P.MaxNs, 100u);
+
+  const Percentiles Few = summarize({30, 10, 20});
+  EXPECT_EQ(Few.MedianNs, 20u);
+  EXPECT_EQ(Few.P90Ns, 30u);
+  EXPECT_EQ(Few.P99Ns, 30u);
+  EXPECT_DOUBLE_EQ(Few.StddevNs, 10.0);
+
+  const Percentiles None = summarize({});
+  EXPECT_EQ(None.MaxNs, 0u);
+}
+
+TEST(E2ETest, JsonReport) {
+  E2EReport Report;
+  Report.Corpus = "/tmp/corpus";
+  Report.Files = 10;
+  Report.Functions = 400;
+  Report.NumThreads = 4;
+  Report.Repetitions = 2;
+  Report.PeakRssBytes = 1024;
+  Report.Queries.push_back({"void(*)", 7, {}, {2000000, 4000000}});
+
+  OutputBuffer Out;
+  formatE2EJson(Out, Report);
+  const std::string_view Json = Out.view();
+  EXPECT_NE(Json.find("\"files\":10,\"functions\":400"), std::string_view::npos);
+  EXPECT_NE(Json.find("\"query\":\"void(*)\",\"matches\":7,\"warm\":"),
+            std::string_view::npos);
+  // Median of {2ms, 4ms} is 2ms: 10 files / 2ms = 5000 files/sec
+  EXPECT_NE(Json.find("\"median_ms\":2.000"), std::string_view::npos);
+  EXPECT_NE(Json.find("\"files_per_sec\":5000.0"), std::string_view::npos);
+  EXPECT_EQ(Json.find("\"cold\""), std::string_view::npos);
+}
+
+TEST(E2ETest, ScalingThreadCounts) {
+  EXPECT_EQ(scalingThreadCounts(1), (std::vector<std::size_t>{1}));
+  EXPECT_EQ(scalingThreadCounts(8), (std::vector<std::size_t>{1, 2, 4, 8}));
+  EXPECT_EQ(scalingThreadCounts(12),
+            (std::vector<std::size_t>{1, 2, 4, 8, 12}));
+}
+
+TEST(E2ETest, ScalingJson) {
+  ScalingReport Report;
+  Report.Corpus = "c";
+  Report.Query = "void(*)";
+  Report.Files = 100;
+  Report.Repetitions = 1;
+  ScalingPoint P;
+  P.NumThreads = 4;
+  P.WallNs = {25000000};
+  P.Speedup = 3.2;
+  P.Efficiency = 0.8;
+  P.MeanIdle = 0.1;
+  Report.Points.push_back(P);
+
+  OutputBuffer Out;
+  formatScalingJson(Out, Report);
+  EXPECT_NE(Out.view().find("{\"threads\":4,\"median_ms\":25.000,"),
+            std::string_view::npos);
+  EXPECT_NE(Out.view().find("\"speedup\":3.200,\"efficiency\":0.800,"
+                            "\"mean_idle\":0.100"),
+            std::string_view::npos);
+}
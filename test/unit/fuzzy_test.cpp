@@ -0,0 +1,161 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for typo-tolerant type matching (--fuzzy-types).
+
+#include "coogle/fuzzy.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+QueryMode fuzzyMode(unsigned MaxEdits) {
+  return {compileAs<FuzzyQuery>(MaxEdits),
+          [MaxEdits](const Signature &Query, const Signature &Actual) {
+            return isFuzzyMatch(Query, Actual, MaxEdits);
+          }};
+}
+
+bool fuzzy(std::string_view Query, std::string_view Actual,
+           unsigned MaxEdits = DefaultFuzzyEdits) {
+  return fuzzyMode(MaxEdits).matches(Query, Actual);
+}
+
+const std::vector<std::string_view> Corpus = {
+    "void()",
+    "int(int)",
+    "long(int, int)",
+    "void(llvm::raw_ostream &, int)",
+    "void(llvm::raw_fd_ostream &, int)",
+    "bool(llvm::StringRef, llvm::StringRef)",
+    "bool(llvm::StringRef, llvm::Twine)",
+    "std::vector<int>(const std::vector<int> &)",
+    "std::vector<long>(const std::vector<long> &)",
+    "int(const char *, ...)",
+};
+
+const std::vector<std::string_view> Queries = {
+    "void(llvm::raw_ostram &, int)",
+    "void(llvm::raw_ostream &, *)",
+    "bool(llvm::StringReff, llvm::StringRef)",
+    "bool(?T, ?T)",
+    "std::vector<int>(const std::vector<int> &)",
+    "std::vector<?T>(const std::vector<?T> &)",
+    "int(int)",
+    "int(const chr *, ...)",
+};
+} // anonymous namespace
+
+TEST(FuzzyTest, EditDistance) {
+  EXPECT_EQ(editDistance("", ""), 0u);
+  EXPECT_EQ(editDistance("abc", ""), 3u);
+  EXPECT_EQ(editDistance("", "abc"), 3u);
+  EXPECT_EQ(editDistance("kitten", "sitting"), 3u);
+  EXPECT_EQ(editDistance("raw_ostram", "raw_ostream"), 1u);
+  EXPECT_EQ(editDistance("StringReff", "StringRef"), 1u);
+
+  FuzzyPattern Pattern("kitten");
+  EXPECT_EQ(Pattern.distance("sitting", 3), 3u);
+  EXPECT_GT(Pattern.distance("sitting", 2), 2u);
+  EXPECT_EQ(Pattern.distance("kitten", 0), 0u);
+  EXPECT_GT(Pattern.distance("kitten and more", 4), 4u);
+}
+
+// The bit-parallel distance agrees with the table on random strings,
+// including patterns of exactly 64 characters and longer ones
+TEST(FuzzyTest, MatchesReferenceDistance) {
+  std::mt19937 Rng(42);
+  auto Random = [&](std::size_t Size) {
+    std::string S(Size, 'a');
+    for (char &C : S) {
+      C = static_cast<char>('a' + Rng() % 4);
+    }
+    return S;
+  };
+  for (std::size_t Size : {1u, 5u, 17u, 63u, 64u, 65u, 90u}) {
+    for (int Round = 0; Round < 20; ++Round) {
+      const std::string Pattern = Random(Size);
+      const std::string Text = Random(Size + Rng() % 5 - 2 + (Size < 2));
+      const unsigned Expected = editDistance(Pattern, Text);
+      const FuzzyPattern Compiled(Pattern);
+      EXPECT_EQ(Compiled.distance(Text, 1000), Expected)
+          << Pattern << " vs " << Text;
+      for (unsigned Limit : {0u, 1u, 3u, 8u}) {
+        const unsigned Bounded = Compiled.distance(Text, Limit);
+        if (Expected <= Limit) {
+          EXPECT_EQ(Bounded, Expected) << Pattern << " vs " << Text;
+        } else {
+          EXPECT_GT(Bounded, Limit) << Pattern << " vs " << Text;
+        }
+      }
+    }
+  }
+}
+
+TEST(FuzzyTest, EditLimit) {
+  EXPECT_EQ(fuzzyEditLimit("int", 2), 0u);
+  EXPECT_EQ(fuzzyEditLimit("long", 2), 1u);
+  EXPECT_EQ(fuzzyEditLimit("StringRef", 2), 2u);
+  EXPECT_EQ(fuzzyEditLimit("llvm::raw_ostream&", 2), 2u);
+  EXPECT_EQ(fuzzyEditLimit("llvm::raw_ostream&", 8), 4u);
+}
+
+TEST(FuzzyTest, Matches) {
+  EXPECT_TRUE(fuzzy("void(llvm::raw_ostram &, int)",
+                    "void(llvm::raw_ostream &, int)"));
+  EXPECT_TRUE(fuzzy("bool(StringReff)", "bool(StringRef)"));
+  EXPECT_TRUE(fuzzy("bool(StringReff)", "bool(StringRef)", 1));
+  EXPECT_FALSE(fuzzy("bool(StringRf)", "bool(std::string)"));
+  EXPECT_FALSE(fuzzy("void(llvm::raw_ostram &, int)",
+                     "void(llvm::raw_fd_ostream &, int)"));
+
+  // Short types stay exact
+  EXPECT_FALSE(fuzzy("int(int)", "int(uint)"));
+  EXPECT_FALSE(fuzzy("int(int)", "long(int)"));
+  EXPECT_TRUE(fuzzy("long(int)", "lng(int)"));
+
+  // Wildcards and variables keep their meaning; arity stays exact
+  EXPECT_TRUE(
+      fuzzy("void(*, llvm::StringReff)", "void(int, llvm::StringRef)"));
+  EXPECT_TRUE(fuzzy("?T(?T, StringReff)", "int(int, StringRef)"));
+  EXPECT_FALSE(fuzzy("?T(?T, StringReff)", "int(long, StringRef)"));
+  EXPECT_FALSE(fuzzy("std::vector<*>(int)", "std::vectr<int>(int)"));
+  EXPECT_FALSE(fuzzy("void(StringReff)", "void(StringRef, int)"));
+  EXPECT_TRUE(fuzzy("void(StringReff, ...)", "void(StringRef, int)"));
+}
+
+// Each distinct candidate type is interned (and scored) once
+TEST(FuzzyTest, CachesByType) {
+  Signatures Sigs;
+  const Signature Query = Sigs.parse("bool(llvm::StringReff, int)");
+  FuzzyQuery Compiled(Query, DefaultFuzzyEdits);
+  const Signature Hit = Sigs.parse("bool(llvm::StringRef, int)");
+  const Signature Miss = Sigs.parse("bool(llvm::StringMap, int)");
+  EXPECT_TRUE(Compiled.matches(Hit));
+  EXPECT_FALSE(Compiled.matches(Miss));
+  const std::size_t Types = Compiled.typeCount();
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(Compiled.matches(Hit));
+    EXPECT_FALSE(Compiled.matches(Miss));
+  }
+  EXPECT_EQ(Compiled.typeCount(), Types);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FuzzyTest, CompiledMatchesReference,
+    ::testing::Values(
+        ReferenceCase{"MaxEdits1", fuzzyMode(1), Queries, Corpus},
+        ReferenceCase{"MaxEdits2", fuzzyMode(2), Queries, Corpus},
+        ReferenceCase{"MaxEdits4", fuzzyMode(4), Queries, Corpus}),
+    referenceCaseName);
+
+INSTANTIATE_TEST_SUITE_P(
+    FuzzyTest, ProcessFilesOnInputs,
+    ::testing::Values(InputsCase{
+        "example.c", "bool(const int &, vod *, int)",
+        [](WorkerSettings &S) { S.FuzzyEdits = DefaultFuzzyEdits; }, 0,
+        1})); // processData
@@ -0,0 +1,118 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the benchmark regression gate.
+
+#include "gate.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::bench;
+
+namespace {
+// Trimmed Google Benchmark output with aggregates only.
+constexpr std::string_view MicroJson = R"({
+  "context": {"date": "2025-01-01", "num_cpus": 8},
+  "benchmarks": [
+    {"name": "BM_A_median", "run_name": "BM_A", "run_type": "aggregate",
+     "aggregate_name": "median", "real_time": 10.5, "cpu_time": 10.0,
+     "time_unit": "ns"},
+    {"name": "BM_A_stddev", "run_name": "BM_A", "run_type": "aggregate",
+     "aggregate_name": "stddev", "real_time": 0.2, "cpu_time": 0.1,
+     "time_unit": "ns"},
+    {"name": "BM_B/4", "run_name": "BM_B/4", "run_type": "iteration",
+     "real_time": 2.0, "cpu_time": 2.0, "time_unit": "us"}
+  ]
+})";
+
+constexpr std::string_view E2EJson =
+    R"json({"corpus":"/tmp/c","files":2,"queries":[
+  {"query":"void(*)","matches":3,"warm":{"runs":5,"median_ms":4.5,
+   "stddev_ms":0.25}}
+]})json";
+} // anonymous namespace
+
+TEST(GateTest, ParseMicroResults) {
+  auto Results = parseBenchResults(MicroJson);
+  ASSERT_TRUE(Results.has_value());
+  ASSERT_EQ(Results->size(), 2u);
+  EXPECT_EQ((*Results)[0].Name, "BM_A");
+  EXPECT_DOUBLE_EQ((*Results)[0].MedianNs, 10.0);
+  EXPECT_DOUBLE_EQ((*Results)[0].StddevNs, 0.1);
+  EXPECT_EQ((*Results)[1].Name, "BM_B/4");
+  EXPECT_DOUBLE_EQ((*Results)[1].MedianNs, 2000.0);
+}
+
+TEST(GateTest, ParseE2EResults) {
+  auto Results = parseBenchResults(E2EJson);
+  ASSERT_TRUE(Results.has_value());
+  ASSERT_EQ(Results->size(), 1u);
+  EXPECT_EQ((*Results)[0].Name, "e2e/void(*)");
+  EXPECT_DOUBLE_EQ((*Results)[0].MedianNs, 4.5e6);
+  EXPECT_DOUBLE_EQ((*Results)[0].StddevNs, 0.25e6);
+}
+
+TEST(GateTest, RejectsOtherJson) {
+  EXPECT_FALSE(parseBenchResults("{\"foo\": 1}").has_value());
+  EXPECT_FALSE(parseBenchResults("{\"benchmarks\": [").has_value());
+  EXPECT_FALSE(parseBaseline("[]").has_value());
+}
+
+TEST(GateTest, BaselineRoundTrip) {
+  Baseline Base;
+  Base.Entries.push_back({{"BM_A", 10.0, 0.5}, 0.1});
+  Base.Entries.push_back({{"e2e/int(int, int)", 4.5e6, 2e5}, 0.3});
+  OutputBuffer Out;
+  formatBaseline(Out, Base);
+
+  auto Loaded = parseBaseline(Out.view());
+  ASSERT_TRUE(Loaded.has_value());
+  ASSERT_EQ(Loaded->Entries.size(), 2u);
+  EXPECT_EQ(Loaded->Entries[1].Result.Name, "e2e/int(int, int)");
+  EXPECT_DOUBLE_EQ(Loaded->Entries[1].Result.MedianNs, 4.5e6);
+  EXPECT_DOUBLE_EQ(Loaded->Entries[1].Result.StddevNs, 2e5);
+  EXPECT_DOUBLE_EQ(Loaded->Entries[0].Tolerance, 0.1);
+}
+
+// Limit = median * (1 + tolerance) + sigmas * max(stddev)
+TEST(GateTest, NoiseAwareLimits) {
+  Baseline Base;
+  Base.Entries.push_back({{"stable", 100, 0}, 0.1});
+  Base.Entries.push_back({{"noisy", 100, 10}, 0.1});
+  Base.Entries.push_back({{"faster", 100, 0}, 0.1});
+  Base.Entries.push_back({{"gone", 100, 0}, 0.1});
+
+  const std::vector<BenchResult> Results = {
+      {"stable", 115, 0}, {"noisy", 135, 2}, {"faster", 80, 0},
+      {"extra", 5, 0}};
+  auto Comparisons = compareToBaseline(Base, Results, 3);
+  ASSERT_EQ(Comparisons.size(), 5u);
+
+  EXPECT_EQ(Comparisons[0].Status, GateStatus::Regressed);
+  EXPECT_DOUBLE_EQ(Comparisons[0].LimitNs, 110);
+  EXPECT_EQ(Comparisons[1].Status, GateStatus::Ok);
+  EXPECT_DOUBLE_EQ(Comparisons[1].LimitNs, 140);
+  EXPECT_EQ(Comparisons[2].Status, GateStatus::Improved);
+  EXPECT_EQ(Comparisons[3].Status, GateStatus::Missing);
+  EXPECT_EQ(Comparisons[4].Name, "extra");
+  EXPECT_EQ(Comparisons[4].Status, GateStatus::New);
+  EXPECT_TRUE(gateFailed(Comparisons));
+
+  OutputBuffer Out;
+  formatComparison(Out, Comparisons);
+  const std::string_view Table = Out.view();
+  EXPECT_NE(Table.find("+15.0%"), std::string_view::npos);
+  EXPECT_NE(Table.find("REGRESSED"), std::string_view::npos);
+  EXPECT_NE(Table.find("✖ 2 of 5 benchmarks"), std::string_view::npos);
+}
+
+TEST(GateTest, UpdateKeepsTolerances) {
+  Baseline Previous;
+  Previous.Entries.push_back({{"BM_A", 10, 0}, 0.5});
+  Baseline Base = makeBaseline({{"BM_A", 12, 1}, {"BM_New", 3, 0}}, Previous);
+  ASSERT_EQ(Base.Entries.size(), 2u);
+  EXPECT_DOUBLE_EQ(Base.Entries[0].Result.MedianNs, 12);
+  EXPECT_DOUBLE_EQ(Base.Entries[0].Tolerance, 0.5);
+  EXPECT_DOUBLE_EQ(Base.Entries[1].Tolerance, DefaultTolerance);
+  EXPECT_FALSE(gateFailed(compareToBaseline(Base, {{"BM_A", 12, 1},
+                                                   {"BM_New", 3, 0}})));
+}
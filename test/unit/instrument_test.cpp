@@ -0,0 +1,39 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the libclang instrumentation macros. They hold in both
+// normal and -DCOOGLE_INSTRUMENT=ON builds.
+
+#include "coogle/instrument.h"
+#include <gtest/gtest.h>
+
+namespace {
+int addOne(int Value) { return Value + 1; }
+
+void increment(int &Value) { ++Value; }
+} // anonymous namespace
+
+// Wrapped calls return the callee's value and evaluate arguments once
+TEST(InstrumentTest, ForwardsResult) {
+  int Calls = 0;
+  EXPECT_EQ(COOGLE_CLANG(addOne, ++Calls), 2);
+  EXPECT_EQ(Calls, 1);
+}
+
+// Void calls work and keep their side effects
+TEST(InstrumentTest, VoidCall) {
+  int Value = 0;
+  COOGLE_CLANG(increment, Value);
+  COOGLE_CLANG(increment, Value);
+  EXPECT_EQ(Value, 2);
+}
+
+#ifdef COOGLE_INSTRUMENT
+// Every call is counted under the function's name
+TEST(InstrumentTest, CountsCalls) {
+  auto &Counter = coogle::instrument::Registry::get().counter("addOne");
+  const auto Before = Counter.Calls.load();
+  COOGLE_CLANG(addOne, 1);
+  COOGLE_CLANG(addOne, 2);
+  EXPECT_EQ(Counter.Calls.load() - Before, 2u);
+}
+#endif
@@ -0,0 +1,115 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for compiled queries (MatchProgram).
+
+#include "coogle/match.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+constexpr std::string_view Corpus[] = {
+    "void()",
+    "int()",
+    "int(int)",
+    "int(int, int)",
+    "int(const int, int)",
+    "void(char *)",
+    "void(const char *)",
+    "void(const char *, unsigned long)",
+    "void(int, const char *, void *)",
+    "std::string(const std::string &)",
+    "std::string(const std::string &, int)",
+    "bool(const std::map<std::string, std::vector<int>> &, size_t)",
+    "void(int, int, int, int)",
+    "void(int, char *, int, double)",
+    "void(int, int, int, int, int, int)",
+    "void(int, char *, int, int, int, double)",
+    "std::vector<int>(const std::vector<int> &)",
+    "std::vector<std::string>(std::vector<int> &&, int *)",
+    "int(std::map<std::string, double> *, char **)",
+    "void(std::pair<int, std::vector<char *>> &, void (*)(int))",
+};
+} // anonymous namespace
+
+TEST(MatchProgramTest, Layout) {
+  Signatures Sigs;
+  const Signature Query = Sigs.parse("void(*, const llvm::Twine &, int, *)");
+  const MatchProgram Program(Query);
+  EXPECT_EQ(Program.arity(), 4u);
+  EXPECT_EQ(Program.wildcardMask(), 0b1001u);
+
+  // The qualified name is compared before the common builtins
+  ASSERT_EQ(Program.checks().size(), 3u);
+  EXPECT_EQ(Program.checks()[0].Position, 1u);
+  EXPECT_EQ(Program.checks()[1].Position, MatchProgram::ReturnPosition);
+  EXPECT_EQ(Program.checks()[2].Position, 2u);
+  EXPECT_FALSE(Program.variadicTail());
+
+  // A wildcard return type needs no check; the tail only bounds the arity
+  const MatchProgram Tail(Sigs.parse("*(const char *, ...)"));
+  EXPECT_EQ(Tail.arity(), 1u);
+  EXPECT_TRUE(Tail.variadicTail());
+  ASSERT_EQ(Tail.checks().size(), 1u);
+  EXPECT_EQ(Tail.checks()[0].Position, 0u);
+
+  // Structural patterns run after the plain checks
+  const MatchProgram Patterns(
+      Sigs.parse("std::vector<*>(int, * *, void (*)(int))"));
+  ASSERT_EQ(Patterns.checks().size(), 2u);
+  EXPECT_EQ(Patterns.checks()[0].Expected, "void(*)(int)");
+  EXPECT_EQ(Patterns.checks()[1].Expected, "int");
+  ASSERT_EQ(Patterns.patternChecks().size(), 2u);
+  EXPECT_EQ(Patterns.patternChecks()[0].Position,
+            MatchProgram::ReturnPosition);
+  EXPECT_EQ(Patterns.patternChecks()[1].Pattern->Kind, TypeKind::Pointer);
+  EXPECT_EQ(Patterns.patternChecks()[1].Position, 1u);
+}
+
+TEST(MatchProgramTest, Selectivity) {
+  EXPECT_EQ(typeSelectivity("void"), 0u);
+  EXPECT_EQ(typeSelectivity("char*"), 0u);
+  EXPECT_GT(typeSelectivity("std::vector<int>&"), typeSelectivity("Foo"));
+  EXPECT_GT(typeSelectivity("Foo"), typeSelectivity("int"));
+}
+
+// Every query against every candidate: same answers as isSignatureMatch,
+// through both the specialized matchers and the loop
+TEST(MatchProgramTest, AgreesWithInterpreter) {
+  Signatures Sigs;
+  std::vector<Signature> Queries;
+  for (std::string_view Input : Corpus) {
+    Queries.push_back(Sigs.parse(Input));
+  }
+  for (std::string_view Input :
+       {"void(*)", "int(*, int)", "void(*, *, *, *)", "void(int, *, int, *)",
+        "void(*, *, *, *, *, *)", "void(int, char *, *, int, *, double)",
+        "std::string(*, int)", "*(int, int)", "*()", "*(...)",
+        "void(const char *, ...)", "*(int, ..)", "void(int, *, int, int, ...)",
+        "void(int, char *, int, int, int, ...)", "std::vector<*>(*)",
+        "*(std::vector<*> &&, * *)", "*(const std::vector<*> &)",
+        "int(std::map<std::string, *> *, * *)", "*(std::map<*, *> *, ...)",
+        "void(std::pair<int, std::vector<* *>> &, *)", "void(*&, void (*)(*))",
+        "*(const *&)", "?T(?T, ?T)", "?T(?T)", "void(?T, ?T, ?T, ?T)",
+        "void(?T, char *, ?T, ...)", "void(?T *, ...)",
+        "std::vector<?T>(const std::vector<?T> &)",
+        "?T(const std::vector<?T> &)",
+        "*(std::map<?K, ?V> *, ?V *)", "*(std::map<?K, ?V> *, ?K *)",
+        "void(std::pair<?T, std::vector<?U>> &, *)"}) {
+    Queries.push_back(Sigs.parse(Input));
+  }
+
+  std::size_t Matches = 0;
+  for (const Signature &Query : Queries) {
+    const MatchProgram Program(Query);
+    for (std::string_view Input : Corpus) {
+      const Signature Actual = Sigs.parse(Input);
+      EXPECT_EQ(Program.matches(Actual), isSignatureMatch(Query, Actual))
+          << toString(Query) << " vs " << Input;
+      Matches += Program.matches(Actual);
+    }
+  }
+  EXPECT_GT(Matches, Queries.size());
+}
@@ -151,6 +151,141 @@ TEST(SignatureMatchTest, WildcardMatching) {
   EXPECT_FALSE(isSignatureMatch(*A, *B));
 }
 
+// Test return-type wildcards and variadic tails
+TEST(SignatureMatchTest, VariadicAndReturnWildcards) {
+  SignatureStorage StorageA;
+  auto AnyReturn = parseFunctionSignature(StorageA, "*(int, int)");
+  SignatureStorage StorageB;
+  auto Tail = parseFunctionSignature(StorageB, "*(const char *, ...)");
+  SignatureStorage StorageC;
+  auto AnyArgs = parseFunctionSignature(StorageC, "void(..)");
+  ASSERT_TRUE(AnyReturn && Tail && AnyArgs);
+
+  auto Matches = [](const Signature &Query, std::string_view Actual) {
+    SignatureStorage Storage;
+    auto Sig = parseFunctionSignature(Storage, Actual);
+    return Sig && isSignatureMatch(Query, *Sig);
+  };
+
+  EXPECT_TRUE(Matches(*AnyReturn, "int(int, int)"));
+  EXPECT_TRUE(Matches(*AnyReturn, "std::string(int, int)"));
+  EXPECT_FALSE(Matches(*AnyReturn, "int(int)"));
+  EXPECT_FALSE(Matches(*AnyReturn, "int(int, int, int)"));
+
+  // printf-like: the fixed prefix, then anything (libclang reports only
+  // the named arguments of a C variadic)
+  EXPECT_TRUE(Matches(*Tail, "int(const char *)"));
+  EXPECT_TRUE(Matches(*Tail, "void(const char *, int, double)"));
+  EXPECT_FALSE(Matches(*Tail, "int()"));
+  EXPECT_FALSE(Matches(*Tail, "int(int, const char *)"));
+
+  EXPECT_TRUE(Matches(*AnyArgs, "void()"));
+  EXPECT_TRUE(Matches(*AnyArgs, "void(int, char *, double)"));
+  EXPECT_FALSE(Matches(*AnyArgs, "int()"));
+}
+
+// Test wildcards inside template arguments and pointer/reference layers
+TEST(SignatureMatchTest, StructuralPatterns) {
+  SignatureStorage StorageA;
+  auto Lookup = parseFunctionSignature(
+      StorageA, "std::vector<*>(const std::map<std::string, *> &, * *)");
+  SignatureStorage StorageB;
+  auto AnyRef = parseFunctionSignature(StorageB, "void(const *&, ...)");
+  ASSERT_TRUE(Lookup && AnyRef);
+
+  auto Matches = [](const Signature &Query, std::string_view Actual) {
+    SignatureStorage Storage;
+    auto Sig = parseFunctionSignature(Storage, Actual);
+    return Sig && isSignatureMatch(Query, *Sig);
+  };
+
+  EXPECT_TRUE(Matches(*Lookup, "std::vector<int>(const std::map<"
+                               "std::basic_string<char>, double> &, char **)"));
+  EXPECT_TRUE(Matches(*Lookup, "std::vector<Foo *>(std::map<std::string, "
+                               "std::vector<int>> &, void *)"));
+  EXPECT_FALSE(Matches(*Lookup, "std::list<int>(const std::map<"
+                                "std::string, int> &, char *)"));
+  EXPECT_FALSE(Matches(*Lookup, "std::vector<int>(const std::map<"
+                                "int, int> &, char *)"));
+  EXPECT_FALSE(Matches(*Lookup, "std::vector<int>(const std::map<"
+                                "std::string, int> &, int)"));
+
+  EXPECT_TRUE(Matches(*AnyRef, "void(std::string &)"));
+  EXPECT_TRUE(Matches(*AnyRef, "void(const Foo &, int)"));
+  EXPECT_FALSE(Matches(*AnyRef, "void(Foo &&)"));
+  EXPECT_FALSE(Matches(*AnyRef, "void(Foo *)"));
+}
+
+// Test type variables that must bind to one type across positions
+TEST(SignatureMatchTest, TypeVariables) {
+  auto Matches = [](std::string_view Query, std::string_view Actual) {
+    SignatureStorage QueryStorage;
+    SignatureStorage ActualStorage;
+    auto QuerySig = parseFunctionSignature(QueryStorage, Query);
+    auto ActualSig = parseFunctionSignature(ActualStorage, Actual);
+    return QuerySig && ActualSig && isSignatureMatch(*QuerySig, *ActualSig);
+  };
+
+  EXPECT_TRUE(Matches("?T(?T, ?T)", "int(int, int)"));
+  EXPECT_TRUE(Matches("?T(?T, ?T)", "Foo(const Foo, Foo)"));
+  EXPECT_FALSE(Matches("?T(?T, ?T)", "int(int, long)"));
+  EXPECT_FALSE(Matches("?T(?T, ?T)", "long(int, int)"));
+
+  EXPECT_TRUE(Matches("void(?T *, size_t, ?T *)", "void(char *, size_t, "
+                                                  "const char *)"));
+  EXPECT_FALSE(Matches("void(?T *, size_t, ?T *)", "void(char *, size_t, "
+                                                   "int *)"));
+  EXPECT_FALSE(Matches("void(?T *, size_t, ?T *)", "void(char, size_t, "
+                                                   "char)"));
+  EXPECT_TRUE(Matches("?T(const std::vector<?T> &)",
+                      "std::string(const std::vector<std::string> &)"));
+  EXPECT_TRUE(Matches("?V(std::map<?K, ?V> &, ?K)",
+                      "int(std::map<std::string, int> &, std::string)"));
+  EXPECT_FALSE(Matches("?V(std::map<?K, ?V> &, ?K)",
+                       "int(std::map<std::string, int> &, int)"));
+
+  // Different variables may still bind to the same type
+  EXPECT_TRUE(Matches("void(?T, ?U)", "void(int, int)"));
+  EXPECT_TRUE(Matches("?T(?T, ...)", "int(int, double)"));
+  // Only the sigil and one capital letter make a variable
+  EXPECT_FALSE(Matches("void(?Tp)", "void(int)"));
+  EXPECT_FALSE(Matches("void(?T::type)", "void(int)"));
+  // Equal text still binds: ?T is "T" here, then int
+  EXPECT_FALSE(Matches("void(std::pair<?T, ?T>)", "void(std::pair<T, int>)"));
+  EXPECT_FALSE(Matches("void(?T, ?T)", "void(T, int)"));
+
+  SignatureStorage Storage;
+  EXPECT_TRUE(
+      parseFunctionSignature(Storage, "void(std::vector<?T> &)")
+          ->HasTypeVariables);
+  EXPECT_FALSE(
+      parseFunctionSignature(Storage, "void(Tp, std::vector<*>)")
+          ->HasTypeVariables);
+  EXPECT_TRUE(parseFunctionSignature(Storage, "?T()")->HasTypeVariables);
+}
+
+// Without the sigil a single capital letter is a plain type name
+TEST(SignatureMatchTest, SingleLetterTypeNames) {
+  auto Matches = [](std::string_view Query, std::string_view Actual) {
+    SignatureStorage QueryStorage;
+    SignatureStorage ActualStorage;
+    auto QuerySig = parseFunctionSignature(QueryStorage, Query);
+    auto ActualSig = parseFunctionSignature(ActualStorage, Actual);
+    return QuerySig && ActualSig && isSignatureMatch(*QuerySig, *ActualSig);
+  };
+
+  EXPECT_TRUE(Matches("void(A *)", "void(A *)"));
+  EXPECT_FALSE(Matches("void(A *)", "void(int *)"));
+  EXPECT_FALSE(Matches("void(A *)", "void(B *)"));
+  EXPECT_TRUE(Matches("T(T, T)", "T(T, T)"));
+  EXPECT_FALSE(Matches("T(T, T)", "int(int, int)"));
+  EXPECT_FALSE(Matches("void(std::vector<T> &)", "void(std::vector<int> &)"));
+
+  SignatureStorage Storage;
+  EXPECT_FALSE(parseFunctionSignature(Storage, "T(T, std::vector<K>)")
+                   ->HasTypeVariables);
+}
+
 // Test complex real-world signatures
 TEST(SignatureMatchTest, RealWorldCases) {
   // FILE * fopen(const char *, const char *)
@@ -0,0 +1,202 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the buffered output writer and text formatters.
+
+#include "coogle/output.h"
+#include "coogle/parser.h"
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unistd.h>
+
+using namespace coogle;
+
+namespace {
+// Reads everything currently buffered in a pipe's read end.
+std::string drainPipe(int Fd) {
+  std::string Data;
+  char Chunk[4096];
+  ssize_t N;
+  while ((N = ::read(Fd, Chunk, sizeof(Chunk))) > 0) {
+    Data.append(Chunk, static_cast<size_t>(N));
+    if (static_cast<size_t>(N) < sizeof(Chunk)) {
+      break;
+    }
+  }
+  return Data;
+}
+} // anonymous namespace
+
+// Test --color value parsing
+TEST(OutputTest, ParseColorMode) {
+  EXPECT_EQ(parseColorMode("auto"), ColorMode::Auto);
+  EXPECT_EQ(parseColorMode("always"), ColorMode::Always);
+  EXPECT_EQ(parseColorMode("never"), ColorMode::Never);
+  EXPECT_FALSE(parseColorMode("sometimes").has_value());
+  EXPECT_FALSE(parseColorMode("").has_value());
+}
+
+// Test that auto mode disables color on a pipe
+TEST(OutputTest, AutoColorDisabledOnPipe) {
+  int Fds[2];
+  ASSERT_EQ(::pipe(Fds), 0);
+  EXPECT_FALSE(shouldUseColor(ColorMode::Auto, Fds[1]));
+  EXPECT_TRUE(shouldUseColor(ColorMode::Always, Fds[1]));
+  EXPECT_FALSE(shouldUseColor(ColorMode::Never, Fds[1]));
+  ::close(Fds[0]);
+  ::close(Fds[1]);
+}
+
+// Test integer formatting without allocation
+TEST(OutputTest, AppendUnsigned) {
+  OutputBuffer Out;
+  Out.appendUnsigned(0);
+  Out.append(' ');
+  Out.appendUnsigned(42);
+  Out.append(' ');
+  Out.appendUnsigned(18446744073709551615ULL);
+  EXPECT_EQ(Out.view(), "0 42 18446744073709551615");
+}
+
+// Test that appendSignature agrees with toString
+TEST(OutputTest, AppendSignatureMatchesToString) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "char *(int, char *, double)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  appendSignature(Out, *Sig);
+  EXPECT_EQ(Out.view(), toString(*Sig));
+
+  SignatureStorage Storage2;
+  Sig = parseFunctionSignature(Storage2, "void()");
+  ASSERT_TRUE(Sig.has_value());
+  Out.clear();
+  appendSignature(Out, *Sig);
+  EXPECT_EQ(Out.view(), "void()");
+}
+
+// Test that a disabled palette emits no escape codes
+TEST(OutputTest, PlainFormattingHasNoEscapes) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "int(int, int)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  const colors::Palette Plain = colors::palette(false);
+  formatFileHeader(Out, Plain, "example.c");
+  formatMatch(Out, Plain, 6, "add", *Sig);
+  EXPECT_EQ(Out.view(), "✔ example.c\n  └─ 6: add int(int, int)\n");
+  EXPECT_EQ(Out.view().find('\033'), std::string_view::npos);
+
+  Out.clear();
+  formatMatch(Out, colors::palette(true), 6, "add", *Sig);
+  EXPECT_NE(Out.view().find('\033'), std::string_view::npos);
+}
+
+// Test that the writer emits buffers in order and clears them
+TEST(OutputTest, WriterFlushesInOrder) {
+  int Fds[2];
+  ASSERT_EQ(::pipe(Fds), 0);
+  OutputWriter Writer(Fds[1]);
+
+  OutputBuffer First, Second, Empty, Third;
+  First.append("first\n");
+  Second.append("second\n");
+  Third.append("third\n");
+  OutputBuffer *Buffers[] = {&First, &Second, &Empty, &Third};
+  EXPECT_TRUE(Writer.write(span<OutputBuffer *>(Buffers)));
+  EXPECT_TRUE(First.empty());
+  EXPECT_TRUE(Third.empty());
+
+  OutputBuffer Single;
+  formatSummary(Single, 3);
+  EXPECT_TRUE(Writer.write(Single));
+  EXPECT_TRUE(Single.empty());
+
+  ::close(Fds[1]);
+  EXPECT_EQ(drainPipe(Fds[0]), "first\nsecond\nthird\n\nMatches found: 3\n");
+  ::close(Fds[0]);
+}
+
+// Test --format value parsing
+TEST(OutputTest, ParseOutputFormat) {
+  EXPECT_EQ(parseOutputFormat("text"), OutputFormat::Text);
+  EXPECT_EQ(parseOutputFormat("json"), OutputFormat::Json);
+  EXPECT_EQ(parseOutputFormat("ndjson"), OutputFormat::Ndjson);
+  EXPECT_FALSE(parseOutputFormat("xml").has_value());
+}
+
+// Test JSON string escaping
+TEST(OutputTest, JsonEscaping) {
+  OutputBuffer Out;
+  appendJsonString(Out, "plain");
+  EXPECT_EQ(Out.view(), "\"plain\"");
+
+  Out.clear();
+  appendJsonString(Out, "a\"b\\c\nd\te");
+  EXPECT_EQ(Out.view(), "\"a\\\"b\\\\c\\nd\\te\"");
+
+  Out.clear();
+  appendJsonString(Out, std::string_view("\x01\x1f", 2));
+  EXPECT_EQ(Out.view(), "\"\\u0001\\u001f\"");
+
+  // UTF-8 passes through untouched
+  Out.clear();
+  appendJsonString(Out, "café");
+  EXPECT_EQ(Out.view(), "\"café\"");
+}
+
+// Test JSON match record encoding
+TEST(OutputTest, MatchJson) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "std::string(const std::string &)");
+  ASSERT_TRUE(Sig.has_value());
+
+  OutputBuffer Out;
+  formatMatchJson(Out, {"dir/a \"b\".cpp", 15, 13, "greet", "function", &*Sig});
+  EXPECT_EQ(Out.view(),
+            "{\"file\":\"dir/a \\\"b\\\".cpp\",\"line\":15,\"column\":13,"
+            "\"name\":\"greet\",\"signature\":\"std::string(const "
+            "std::string &)\",\"kind\":\"function\"}");
+}
+
+// Test that the leading record separator is dropped exactly once
+TEST(OutputTest, WriterStripsFirstSeparator) {
+  int Fds[2];
+  ASSERT_EQ(::pipe(Fds), 0);
+  OutputWriter Writer(Fds[1]);
+
+  OutputBuffer Header;
+  Header.append("[\n");
+  EXPECT_TRUE(Writer.write(Header));
+  Writer.setLeadingSeparator(JsonRecordSeparator);
+
+  OutputBuffer WorkerA, WorkerB, Footer;
+  WorkerA.append(",\n1");
+  WorkerA.append(",\n2");
+  EXPECT_TRUE(Writer.write(WorkerA));
+  WorkerB.append(",\n3");
+  Footer.append("\n]\n");
+  OutputBuffer *Rest[] = {&WorkerB, &Footer};
+  EXPECT_TRUE(Writer.write(span<OutputBuffer *>(Rest)));
+
+  ::close(Fds[1]);
+  EXPECT_EQ(drainPipe(Fds[0]), "[\n1,\n2,\n3\n]\n");
+  ::close(Fds[0]);
+}
+
+// Test --files-with-matches and --count formatters
+TEST(OutputTest, FileAndCountFormatters) {
+  OutputBuffer Out;
+  formatMatchedFile(Out, colors::palette(false), "src/a.cpp");
+  EXPECT_EQ(Out.view(), "src/a.cpp\n");
+
+  Out.clear();
+  formatMatchedFileJson(Out, "src/a.cpp");
+  EXPECT_EQ(Out.view(), "{\"file\":\"src/a.cpp\"}");
+
+  Out.clear();
+  formatCountJson(Out, 1234);
+  EXPECT_EQ(Out.view(), "{\"count\":1234}\n");
+}
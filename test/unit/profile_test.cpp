@@ -0,0 +1,104 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the per-file cost profile.
+
+#include "coogle/profile.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace coogle;
+
+namespace {
+std::uint64_t chunkCost(const std::vector<std::string> &Chunk,
+                        const CostMap &Costs) {
+  std::uint64_t Total = 0;
+  for (const auto &File : Chunk) {
+    Total += Costs.at(File);
+  }
+  return Total;
+}
+} // anonymous namespace
+
+// Saved profiles load back with microsecond precision
+TEST(ProfileTest, RoundTrip) {
+  std::vector<FileProfile> Profiles = {
+      {"src/a.cpp", 1520000, 85000, 1048576, 12},
+      {"gen/huge.cpp", 900000000, 2000000, 734003200, 40000},
+  };
+  OutputBuffer Out;
+  formatProfile(Out, Profiles);
+
+  auto Loaded = parseProfile(Out.view());
+  ASSERT_TRUE(Loaded.has_value());
+  ASSERT_EQ(Loaded->size(), 2u);
+  EXPECT_EQ((*Loaded)[0].File, "src/a.cpp");
+  EXPECT_EQ((*Loaded)[0].ParseNs, 1520000u);
+  EXPECT_EQ((*Loaded)[0].VisitNs, 85000u);
+  EXPECT_EQ((*Loaded)[0].MemoryBytes, 1048576u);
+  EXPECT_EQ((*Loaded)[0].Functions, 12u);
+  EXPECT_EQ((*Loaded)[1].costNs(), 902000000u);
+}
+
+// Wrong headers are rejected; malformed rows are skipped
+TEST(ProfileTest, ParseRejectsBadInput) {
+  EXPECT_FALSE(parseProfile("file\t1\t2\t3\t4\n").has_value());
+
+  auto Loaded = parseProfile("# coogle profile v1\n"
+                             "a.cpp\t1\t2\t3\n"       // Missing column
+                             "b.cpp\tx\t2\t3\t4\n"    // Not a number
+                             "c.cpp\t10\t20\t30\t4"); // No trailing newline
+  ASSERT_TRUE(Loaded.has_value());
+  ASSERT_EQ(Loaded->size(), 1u);
+  EXPECT_EQ((*Loaded)[0].File, "c.cpp");
+  EXPECT_EQ((*Loaded)[0].VisitNs, 20000u);
+}
+
+// The report lists the slowest files first and stops at N
+TEST(ProfileTest, TopFiles) {
+  OutputBuffer Out;
+  formatTopFiles(Out,
+                 {{"fast.cpp", 1000000}, {"slow.cpp", 9000000},
+                  {"mid.cpp", 5000000}},
+                 2);
+  const std::string Text(Out.view());
+  const auto Slow = Text.find("slow.cpp");
+  const auto Mid = Text.find("mid.cpp");
+  ASSERT_NE(Slow, std::string::npos);
+  ASSERT_NE(Mid, std::string::npos);
+  EXPECT_LT(Slow, Mid);
+  EXPECT_EQ(Text.find("fast.cpp"), std::string::npos);
+  EXPECT_NE(Text.find("top 2 of 3"), std::string::npos);
+}
+
+// Cost-based partitioning keeps every file and balances the load
+TEST(ProfileTest, PartitionByCost) {
+  const std::vector<std::string> Files = {"a", "b", "c", "d", "e", "f"};
+  const CostMap Costs = {{"a", 100}, {"b", 10}, {"c", 10},
+                         {"d", 10},  {"e", 60}, {"f", 40}};
+
+  auto Chunks = partitionByCost(Files, Costs, 2);
+  ASSERT_EQ(Chunks.size(), 2u);
+
+  std::vector<std::string> All;
+  for (const auto &Chunk : Chunks) {
+    All.insert(All.end(), Chunk.begin(), Chunk.end());
+  }
+  std::sort(All.begin(), All.end());
+  EXPECT_EQ(All, Files);
+
+  // Total 230: LPT reaches the optimal 120/110 split here, where contiguous
+  // chunks of three would give 120/110 only by accident of the file order
+  const auto Max = std::max(chunkCost(Chunks[0], Costs),
+                            chunkCost(Chunks[1], Costs));
+  EXPECT_LE(Max, 120u);
+}
+
+// Files missing from the profile are scheduled at the average cost
+TEST(ProfileTest, PartitionUnknownFiles) {
+  auto Chunks = partitionByCost({"x", "y", "z"}, CostMap{}, 8);
+  ASSERT_EQ(Chunks.size(), 3u);
+  for (const auto &Chunk : Chunks) {
+    EXPECT_EQ(Chunk.size(), 1u);
+  }
+}
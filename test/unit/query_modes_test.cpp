@@ -0,0 +1,53 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Tests shared by the query modes (see test_util.h).
+
+#include "test_util.h"
+
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+using namespace coogle;
+using namespace coogle::test;
+
+TEST_P(ProcessFilesOnInputs, CountsMatches) {
+  const InputsCase &Case = GetParam();
+  const DefaultClangArgs ClangArgs;
+  const int NullFd = ::open("/dev/null", O_WRONLY);
+  OutputWriter Writer(NullFd);
+  WorkerSettings Settings{ResultMode::Count, OutputFormat::Text,
+                          colors::palette(false), OutputFlushThreshold};
+
+  Signatures Sigs;
+  const Signature Target = Sigs.parse(Case.Query);
+  const std::vector<std::string> Files = {
+      std::string(COOGLE_TEST_INPUTS_DIR "/") + Case.File};
+  EXPECT_EQ(
+      processFiles(Files, Target, ClangArgs.get(), Writer, Settings).MatchCount,
+      Case.MatchesWithout);
+  Case.Enable(Settings);
+  EXPECT_EQ(
+      processFiles(Files, Target, ClangArgs.get(), Writer, Settings).MatchCount,
+      Case.MatchesWith);
+  ::close(NullFd);
+}
+
+TEST_P(CompiledMatchesReference, OnCorpus) {
+  const ReferenceCase &Case = GetParam();
+  Signatures Sigs;
+  for (std::string_view Query : Case.Queries) {
+    const Signature QuerySig = Sigs.parse(Query);
+    const QueryMode::MatcherFn Compiled = Case.Mode.Compile(QuerySig);
+    for (int Pass = 0; Pass < 2; ++Pass) {
+      for (std::string_view Input : Case.Corpus) {
+        const Signature Actual = Sigs.parse(Input);
+        const bool Expected = Case.Mode.Reference(QuerySig, Actual);
+        EXPECT_EQ(Compiled(Actual), Expected) << Query << " vs " << Input;
+        if (isSignatureMatch(QuerySig, Actual)) {
+          EXPECT_TRUE(Expected) << Query << " vs " << Input;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,196 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for ranked search (--rank).
+
+#include "coogle/rank.h"
+#include "coogle/search.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <limits>
+#include <unistd.h>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+unsigned scoreOf(std::string_view Query, std::string_view Actual) {
+  Signatures Sigs;
+  return RankedQuery(Sigs.parse(Query)).score(Sigs.parse(Actual));
+}
+
+RankedMatch matchAt(unsigned Score, std::string File, std::uint32_t Line) {
+  RankedMatch Match;
+  Match.Score = Score;
+  Match.FileName = std::move(File);
+  Match.Line = Line;
+  return Match;
+}
+
+constexpr std::string_view Corpus[] = {
+    "void()",
+    "int(int)",
+    "int(int, int)",
+    "void(char *)",
+    "void(const char *, unsigned long)",
+    "void(int, const char *, void *)",
+    "std::string(const std::string &)",
+    "std::string(int, const std::string &)",
+    "bool(const std::map<std::string, std::vector<int>> &, size_t)",
+    "void(int, char *, int, double)",
+    "void(int, int, int, int, int, int, int, int, int, int, int, int)",
+};
+} // anonymous namespace
+
+TEST(RankTest, TypeDistance) {
+  EXPECT_EQ(typeDistance("int", "int"), 0u);
+  EXPECT_EQ(typeDistance("*", "std::string&"), 0u);
+  EXPECT_EQ(typeDistance("std::vector<*>", "std::vector<int>"), 0u);
+
+  // Pass by value vs by (const) reference
+  EXPECT_EQ(typeDistance("std::string", "std::string&"), RankCosts::Reference);
+  EXPECT_EQ(typeDistance("Foo&&", "Foo"), RankCosts::Reference);
+  EXPECT_EQ(typeDistance("Foo&&", "Foo&"), RankCosts::Reference);
+  // Value vs pointer, then both relaxations at once
+  EXPECT_EQ(typeDistance("Foo", "Foo*"), RankCosts::Pointer);
+  EXPECT_EQ(typeDistance("char**", "char*"), RankCosts::Pointer);
+  EXPECT_EQ(typeDistance("Foo*", "Foo&"),
+            RankCosts::Reference + RankCosts::Pointer);
+
+  EXPECT_EQ(typeDistance("int", "long"), NoTypeMatch);
+  EXPECT_EQ(typeDistance("Foo", "Foo**"), NoTypeMatch);
+}
+
+TEST(RankTest, Score) {
+  EXPECT_EQ(scoreOf("int(int, int)", "int(int, int)"), 0u);
+  EXPECT_EQ(scoreOf("void(const char *)", "void(char *)"), 0u);
+
+  // Argument order
+  EXPECT_EQ(scoreOf("void(int, char *)", "void(char *, int)"),
+            RankCosts::Reorder);
+  EXPECT_EQ(scoreOf("void(int, char *, double)", "void(double, char *, int)"),
+            3 * RankCosts::Reorder);
+
+  // Subsets and supersets of the arguments
+  EXPECT_EQ(scoreOf("void(int, char *, double)", "void(char *, int)"),
+            RankCosts::MissingArg + RankCosts::Reorder);
+  EXPECT_EQ(scoreOf("void(int)", "void(int, double)"), RankCosts::ExtraArg);
+  EXPECT_EQ(scoreOf("void(int, ...)", "void(int, double, char)"), 0u);
+  EXPECT_EQ(scoreOf("void(int, Foo)", "void(int, Bar)"),
+            RankCosts::MissingArg + RankCosts::ExtraArg);
+
+  // Relaxed argument and return types
+  EXPECT_EQ(scoreOf("void(std::string)", "void(const std::string &)"),
+            RankCosts::Reference);
+  EXPECT_EQ(scoreOf("Foo(int)", "Foo *(int)"), RankCosts::Pointer);
+  EXPECT_EQ(scoreOf("int(int)", "void(int)"), RankCosts::Return);
+  EXPECT_EQ(scoreOf("*(int)", "void(int)"), 0u);
+
+  // Past MaxRankedArity arguments are paired by position
+  EXPECT_EQ(scoreOf("void(int, int, int, int, int, int, int, int, int, int, "
+                    "int, char)",
+                    "void(int, int, int, int, int, int, int, int, int, int, "
+                    "int, int)"),
+            RankCosts::MissingArg + RankCosts::ExtraArg);
+}
+
+// The bound is safe for pruning, and a zero score is an exact match
+TEST(RankTest, LowerBoundAndExactMatches) {
+  Signatures Sigs;
+  std::vector<Signature> Queries;
+  for (std::string_view Input : Corpus) {
+    Queries.push_back(Sigs.parse(Input));
+  }
+  for (std::string_view Input :
+       {"void(*)", "int(int, *)", "*(const char *, ...)", "void(char *, int)",
+        "std::string(const std::string &, int)", "bool(* *)",
+        "void(double, int, char *, int)", "void(int &, int &)"}) {
+    Queries.push_back(Sigs.parse(Input));
+  }
+
+  for (const Signature &Query : Queries) {
+    const RankedQuery Ranked(Query);
+    for (std::string_view Input : Corpus) {
+      const Signature Actual = Sigs.parse(Input);
+      const unsigned Score = Ranked.score(Actual);
+      EXPECT_LE(Ranked.lowerBound(Actual), Score)
+          << toString(Query) << " vs " << Input;
+      EXPECT_EQ(Score == 0, isSignatureMatch(Query, Actual))
+          << toString(Query) << " vs " << Input;
+    }
+  }
+}
+
+TEST(RankTest, TopMatches) {
+  TopMatches Best(2);
+  EXPECT_TRUE(Best.admits(100));
+  Best.offer(matchAt(5, "b.cpp", 1));
+  Best.offer(matchAt(3, "b.cpp", 9));
+  EXPECT_TRUE(Best.admits(5)); // May still win on location
+  EXPECT_FALSE(Best.admits(6));
+  Best.offer(matchAt(5, "a.cpp", 1)); // Ties break by location
+  Best.offer(matchAt(7, "a.cpp", 2));
+
+  const std::vector<RankedMatch> Kept = Best.take();
+  ASSERT_EQ(Kept.size(), 2u);
+  EXPECT_EQ(Kept[0].Score, 3u);
+  EXPECT_EQ(Kept[1].FileName, "a.cpp");
+
+  TopMatches None(0);
+  EXPECT_FALSE(None.admits(0));
+  None.offer(matchAt(0, "a.cpp", 1));
+  EXPECT_EQ(None.size(), 0u);
+}
+
+// Slots are taken as matches arrive, not reserved for K up front
+TEST(RankTest, TopMatchesLargeK) {
+  TopMatches Huge(std::numeric_limits<std::size_t>::max());
+  Huge.offer(matchAt(1, "a.cpp", 1));
+  EXPECT_TRUE(Huge.admits(1000));
+  EXPECT_EQ(Huge.take().size(), 1u);
+}
+
+TEST(RankTest, MergeTopMatches) {
+  std::vector<std::vector<RankedMatch>> Lists(3);
+  Lists[0] = {matchAt(0, "a.cpp", 1), matchAt(4, "a.cpp", 2)};
+  Lists[1] = {matchAt(1, "b.cpp", 1), matchAt(2, "b.cpp", 2)};
+  Lists[2] = {matchAt(2, "a.cpp", 9)};
+
+  const std::vector<RankedMatch> Best = mergeTopMatches(std::move(Lists), 3);
+  ASSERT_EQ(Best.size(), 3u);
+  EXPECT_EQ(Best[0].Score, 0u);
+  EXPECT_EQ(Best[1].Score, 1u);
+  EXPECT_EQ(Best[2].FileName, "a.cpp"); // Beats b.cpp:2 on location
+  EXPECT_EQ(Best[2].Line, 9u);
+}
+
+// Nothing matches exactly, yet the closest functions come back ranked
+TEST(RankTest, RankFilesOnInputs) {
+  Signatures Sigs;
+  const Signature Target = Sigs.parse("int(int, int, int)");
+  const DefaultClangArgs ClangArgs;
+  const int NullFd = ::open("/dev/null", O_WRONLY);
+  OutputWriter Writer(NullFd);
+  const WorkerSettings Settings{ResultMode::List, OutputFormat::Text,
+                                colors::palette(false), OutputFlushThreshold};
+
+  TaskResult Result =
+      rankFiles({COOGLE_TEST_INPUTS_DIR "/example.c"}, Target, 3,
+                ClangArgs.get(), Writer, Settings);
+  ::close(NullFd);
+  EXPECT_TRUE(Result.Output.empty());
+  ASSERT_EQ(Result.Ranked.size(), 3u);
+  EXPECT_EQ(Result.MatchCount, 3u);
+  EXPECT_EQ(Result.Ranked[0].FunctionName, "add");
+  EXPECT_EQ(Result.Ranked[0].Score, RankCosts::MissingArg);
+  EXPECT_EQ(Result.Ranked[1].FunctionName, "multiply");
+  EXPECT_LE(Result.Ranked[1].Score, Result.Ranked[2].Score);
+
+  OutputBuffer Out;
+  formatRankedMatchJson(Out, Result.Ranked[0]);
+  EXPECT_NE(Out.view().find("\"name\":\"add\""), std::string_view::npos);
+  EXPECT_NE(Out.view().find("\"signature\":\"int(int, int)\""),
+            std::string_view::npos);
+  EXPECT_NE(Out.view().find(",\"score\":3}"), std::string_view::npos);
+}
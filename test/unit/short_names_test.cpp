@@ -0,0 +1,123 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for short type names (--short-names).
+
+#include "coogle/short_names.h"
+#include "test_util.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::test;
+
+namespace {
+const QueryMode ShortNames{compileAs<ShortNameQuery>(), isShortNameMatch};
+
+bool shortNames(std::string_view Query, std::string_view Actual) {
+  return ShortNames.matches(Query, Actual);
+}
+
+const std::vector<std::string_view> Corpus = {
+    "void()",
+    "int(int, int)",
+    "llvm::StringRef(llvm::StringRef)",
+    "bool(llvm::StringRef, const llvm::Twine &)",
+    "bool(clang::StringRef, llvm::Twine)",
+    "std::string(const std::string &, int)",
+    "void(std::vector<llvm::StringRef> &)",
+    "void(llvm::SmallVector<llvm::StringRef, 4> &)",
+    "std::vector<int>::iterator(std::vector<int> &)",
+    "void(llvm::raw_ostream &, const char *, ...)",
+};
+
+const std::vector<std::string_view> Queries = {
+    "StringRef(StringRef)",
+    "bool(StringRef, Twine)",
+    "bool(llvm::StringRef, *)",
+    "string(const string &, int)",
+    "void(vector<StringRef> &)",
+    "void(SmallVector<StringRef, 4> &)",
+    "void(std::vector<*> &)",
+    "iterator(vector<int> &)",
+    "?T(?T)",
+    "void(raw_ostream &, ...)",
+    "int(int, int)",
+};
+} // anonymous namespace
+
+TEST(ShortNamesTest, QualifiedSuffix) {
+  EXPECT_TRUE(isQualifiedSuffix("StringRef", "llvm::StringRef"));
+  EXPECT_TRUE(isQualifiedSuffix("llvm::StringRef", "llvm::StringRef"));
+  EXPECT_TRUE(isQualifiedSuffix("Twine::Kind", "llvm::Twine::Kind"));
+  EXPECT_TRUE(isQualifiedSuffix("iterator", "std::vector<a::b>::iterator"));
+  EXPECT_FALSE(isQualifiedSuffix("Ref", "llvm::StringRef"));
+  EXPECT_FALSE(isQualifiedSuffix("Twine", "llvm::Twine::Kind"));
+  EXPECT_FALSE(isQualifiedSuffix("clang::StringRef", "llvm::StringRef"));
+  EXPECT_FALSE(
+      isQualifiedSuffix("b>::iterator", "std::vector<a::b>::iterator"));
+}
+
+TEST(ShortNamesTest, NameIndex) {
+  TypeNameIndex Index;
+  const TypeIdSet &StringRef = Index.lookup("StringRef");
+  Index.insert("llvm::StringRef", 0);
+  Index.insert("clang::StringRef", 1);
+  Index.insert("llvm::Twine", 2);
+  Index.insert("StringRef", 3);
+  // Sets resolved before the names came in see them too
+  EXPECT_TRUE(StringRef.contains(0));
+  EXPECT_TRUE(StringRef.contains(1));
+  EXPECT_FALSE(StringRef.contains(2));
+  EXPECT_TRUE(StringRef.contains(3));
+
+  const TypeIdSet &Llvm = Index.lookup("llvm::StringRef");
+  EXPECT_TRUE(Llvm.contains(0));
+  EXPECT_FALSE(Llvm.contains(1));
+  EXPECT_FALSE(Llvm.contains(3));
+  EXPECT_FALSE(Index.lookup("Ref").contains(0));
+  EXPECT_FALSE(Index.lookup("llvm").contains(2));
+
+  TypeIdSet Ids;
+  Ids.insert(200);
+  EXPECT_TRUE(Ids.contains(200));
+  EXPECT_FALSE(Ids.contains(199));
+  EXPECT_FALSE(Ids.contains(100000));
+}
+
+TEST(ShortNamesTest, Matches) {
+  EXPECT_TRUE(shortNames("StringRef(StringRef)",
+                         "llvm::StringRef(llvm::StringRef)"));
+  EXPECT_TRUE(shortNames("string(const string &)",
+                         "std::string(const std::string &)"));
+  EXPECT_TRUE(shortNames("void(vector<StringRef> *)",
+                         "void(std::vector<llvm::StringRef> *)"));
+  EXPECT_FALSE(shortNames("void(vector<StringRef> *)",
+                          "void(std::vector<llvm::StringRef> &)"));
+  EXPECT_FALSE(shortNames("void(Ref)", "void(llvm::StringRef)"));
+  EXPECT_FALSE(shortNames("void(llvm::StringRef)", "void(StringRef)"));
+  EXPECT_FALSE(shortNames("void(Twine)", "void(llvm::Twine::Kind)"));
+
+  // Wildcards and type variables keep their meaning
+  EXPECT_TRUE(shortNames("void(map<string, *> &)",
+                         "void(std::map<std::string, int> &)"));
+  EXPECT_TRUE(shortNames("?T(?T, StringRef)",
+                         "int(int, llvm::StringRef)"));
+  EXPECT_FALSE(shortNames("?T(?T, StringRef)",
+                          "int(long, llvm::StringRef)"));
+  EXPECT_TRUE(shortNames("void(StringRef, ...)",
+                         "void(llvm::StringRef, int)"));
+}
+
+INSTANTIATE_TEST_SUITE_P(ShortNamesTest, CompiledMatchesReference,
+                         ::testing::Values(ReferenceCase{
+                             "Default", ShortNames, Queries, Corpus}),
+                         referenceCaseName);
+
+INSTANTIATE_TEST_SUITE_P(
+    ShortNamesTest, ProcessFilesOnInputs,
+    ::testing::Values(
+        // llvm::trim and clang::trim
+        InputsCase{"namespaces.cpp", "StringRef(StringRef)",
+                   [](WorkerSettings &S) { S.ShortNames = true; }, 0, 2},
+        // llvm::kindOf
+        InputsCase{"namespaces.cpp", "Kind(const Twine &)",
+                   [](WorkerSettings &S) { S.ShortNames = true; }, 0, 1}));
@@ -101,6 +101,31 @@ TEST(ParseSignatureTest, InvalidInputs) {
   EXPECT_FALSE(parseFunctionSignature(Storage5, ")(").has_value());
 }
 
+// Test variadic tails and return-type wildcards
+TEST(ParseSignatureTest, VariadicTail) {
+  SignatureStorage Storage;
+  auto Sig = parseFunctionSignature(Storage, "*(int, ...)");
+  ASSERT_TRUE(Sig.has_value());
+  EXPECT_EQ(Sig->RetType, "*");
+  ASSERT_EQ(Sig->ArgTypes.size(), 1);
+  EXPECT_EQ(Sig->ArgTypes[0], "int");
+  EXPECT_TRUE(Sig->VariadicTail);
+
+  SignatureStorage Storage2;
+  Sig = parseFunctionSignature(Storage2, "void( .. )");
+  ASSERT_TRUE(Sig.has_value());
+  EXPECT_EQ(Sig->ArgTypes.size(), 0);
+  EXPECT_TRUE(Sig->VariadicTail);
+
+  SignatureStorage Storage3;
+  Sig = parseFunctionSignature(Storage3, "void(int)");
+  ASSERT_TRUE(Sig.has_value());
+  EXPECT_FALSE(Sig->VariadicTail);
+
+  SignatureStorage Storage4;
+  EXPECT_FALSE(parseFunctionSignature(Storage4, "void(..., int)").has_value());
+}
+
 // Test toString
 TEST(ToStringTest, BasicConversion) {
   SignatureStorage Storage;
@@ -117,6 +142,17 @@ TEST(ToStringTest, BasicConversion) {
   Sig = parseFunctionSignature(Storage3, "char *(int, char *, double)");
   ASSERT_TRUE(Sig.has_value());
   EXPECT_EQ(toString(*Sig), "char *(int, char *, double)");
+
+  // Both tail spellings print as "..."
+  SignatureStorage Storage4;
+  Sig = parseFunctionSignature(Storage4, "int(const char *, ..)");
+  ASSERT_TRUE(Sig.has_value());
+  EXPECT_EQ(toString(*Sig), "int(const char *, ...)");
+
+  SignatureStorage Storage5;
+  Sig = parseFunctionSignature(Storage5, "*(...)");
+  ASSERT_TRUE(Sig.has_value());
+  EXPECT_EQ(toString(*Sig), "*(...)");
 }
 
 // Test function pointers
@@ -0,0 +1,141 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the --stats instrumentation.
+
+#include "coogle/stats.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+
+// A null stats pointer must leave nothing behind
+TEST(StatsTest, NullTimerIsNoop) {
+  { PhaseTimer Timer(nullptr, Phase::Parse); }
+  SUCCEED();
+}
+
+// Timers accumulate into their own phase only
+TEST(StatsTest, TimerChargesPhase) {
+  WorkerStats Stats;
+  {
+    PhaseTimer Timer(&Stats, Phase::Parse);
+    volatile std::uint64_t Sink = 0;
+    for (int i = 0; i < 100000; ++i) {
+      Sink = Sink + i;
+    }
+  }
+  EXPECT_GT(Stats[Phase::Parse].WallNs, 0u);
+  EXPECT_EQ(Stats[Phase::Visit].WallNs, 0u);
+  EXPECT_EQ(Stats[Phase::Visit].CpuNs, 0u);
+}
+
+// Merging adds counters and phase times
+TEST(StatsTest, Merge) {
+  WorkerStats A;
+  A[Phase::Match].WallNs = 10;
+  A.FilesParsed = 2;
+  A.Matches = 1;
+
+  WorkerStats B;
+  B[Phase::Match].WallNs = 5;
+  B[Phase::Match].CpuNs = 4;
+  B.FilesParsed = 3;
+  B.ParseFailures = 1;
+
+  A += B;
+  EXPECT_EQ(A[Phase::Match].WallNs, 15u);
+  EXPECT_EQ(A[Phase::Match].CpuNs, 4u);
+  EXPECT_EQ(A.FilesParsed, 5u);
+  EXPECT_EQ(A.ParseFailures, 1u);
+  EXPECT_EQ(A.Matches, 1u);
+}
+
+// Peak RSS is never zero for a running process
+TEST(StatsTest, ProcessUsage) {
+  ProcessUsage Usage = currentProcessUsage();
+  EXPECT_GT(Usage.PeakRssBytes, 0u);
+}
+
+// The report lists every phase, the throughput and one row per worker
+TEST(StatsTest, Report) {
+  StatsReport Report;
+  Report.Workers.resize(2);
+  Report.Workers[0].FilesParsed = 3;
+  Report.Workers[0].BusyNs = 2000000;
+  Report.Workers[1].FilesParsed = 1;
+  Report.Workers[1].BusyNs = 500000;
+  Report.ParallelWallNs = 2000000;
+  Report.TotalWallNs = 1000000000; // 1 s
+  Report.NumFiles = 4;
+
+  OutputBuffer Out;
+  formatStatsReport(Out, Report);
+  const std::string Text(Out.view());
+
+  for (std::size_t i = 0; i < NumPhases; ++i) {
+    EXPECT_NE(Text.find(phaseName(static_cast<Phase>(i))), std::string::npos);
+  }
+  EXPECT_NE(Text.find("4.0"), std::string::npos); // files/sec
+  // Worker 1 was busy 0.5 ms of the 2 ms parallel section
+  EXPECT_NE(Text.find("0.50         1.50"), std::string::npos);
+}
+
+// Deltas only count counters that were valid at both ends
+TEST(StatsTest, PerfDelta) {
+  PerfCounts Start;
+  PerfCounts End;
+  Start.Values = {100, 200, 5, 1};
+  End.Values = {150, 500, 7, 1};
+  Start.Valid = {true, true, true, false};
+  End.Valid = {true, true, false, false};
+
+  PerfCounts Delta = perfDelta(Start, End);
+  EXPECT_EQ(Delta[PerfEvent::Cycles], 50u);
+  EXPECT_EQ(Delta[PerfEvent::Instructions], 300u);
+  EXPECT_FALSE(Delta.valid(PerfEvent::CacheMisses));
+  EXPECT_EQ(Delta[PerfEvent::CacheMisses], 0u);
+  EXPECT_FALSE(Delta.valid(PerfEvent::BranchMisses));
+}
+
+// Opening counters never fails hard; unavailable counters say why
+TEST(StatsTest, PerfCountersDegrade) {
+  for (bool CountChildThreads : {false, true}) {
+    PerfCounters Counters(CountChildThreads);
+    PerfCounts Counts = Counters.read();
+    EXPECT_EQ(Counts.anyValid(), Counters.available());
+    if (!Counters.available()) {
+      EXPECT_FALSE(Counters.error().empty());
+    }
+  }
+}
+
+// Timers sample installed counters for coarse phases only
+TEST(StatsTest, PerfSampledPhases) {
+  EXPECT_TRUE(isPerfSampled(Phase::Parse));
+  EXPECT_TRUE(isPerfSampled(Phase::Visit));
+  EXPECT_FALSE(isPerfSampled(Phase::Extract));
+  EXPECT_FALSE(isPerfSampled(Phase::Match));
+
+  PerfCounters Counters;
+  if (!Counters.available()) {
+    GTEST_SKIP() << "perf counters unavailable: " << Counters.error();
+  }
+  PerfThreadScope Scope(&Counters);
+  WorkerStats Stats;
+  { PhaseTimer Timer(&Stats, Phase::Parse); }
+  { PhaseTimer Timer(&Stats, Phase::Match); }
+  EXPECT_TRUE(Stats.Perf[static_cast<std::size_t>(Phase::Parse)].anyValid());
+  EXPECT_FALSE(Stats.Perf[static_cast<std::size_t>(Phase::Match)].anyValid());
+}
+
+// Without counters the report explains why instead of printing zeros
+TEST(StatsTest, ReportPerfUnavailable) {
+  StatsReport Report;
+  Report.PerfRequested = true;
+  Report.PerfError = "cycles: Permission denied";
+
+  OutputBuffer Out;
+  formatStatsReport(Out, Report);
+  EXPECT_NE(std::string(Out.view()).find(
+                "perf counters unavailable (cycles: Permission denied)"),
+            std::string::npos);
+}
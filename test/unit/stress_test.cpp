@@ -0,0 +1,62 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the stress test's step sizes and limits.
+
+#include "stress.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+using namespace coogle::bench;
+
+namespace {
+StressStep step(std::size_t Files, std::uint64_t WallNs,
+                std::uint64_t PeakRssBytes) {
+  StressStep Step;
+  Step.Files = Files;
+  Step.Matches = Files;
+  Step.Workers = 4;
+  Step.WallNs = WallNs;
+  Step.PeakRssBytes = PeakRssBytes;
+  return Step;
+}
+} // anonymous namespace
+
+TEST(StressTest, StepSizes) {
+  EXPECT_EQ(stressStepSizes(100000, 4),
+            (std::vector<std::size_t>{12500, 25000, 50000, 100000}));
+  EXPECT_EQ(stressStepSizes(3, 4), (std::vector<std::size_t>{1, 3}));
+  EXPECT_EQ(stressStepSizes(10, 1), (std::vector<std::size_t>{10}));
+}
+
+TEST(StressTest, LinearRunPasses) {
+  StressReport Report;
+  Report.Query = "void(*)";
+  Report.Steps = {step(100, 1000000, 50 << 20), step(200, 2100000, 52 << 20),
+                  step(400, 4000000, 53 << 20)};
+  EXPECT_TRUE(checkStress(Report, StressConfig(), 400).empty());
+
+  OutputBuffer Out;
+  formatStressTable(Out, Report);
+  EXPECT_NE(Out.view().find("10.0"), std::string_view::npos); // us/file
+}
+
+TEST(StressTest, ReportsPathologies) {
+  StressReport Report;
+  Report.Query = "void(*)";
+  Report.Steps = {step(100, 1000000, 50 << 20), step(400, 8000000, 900 << 20)};
+  Report.Steps[1].Failures = 3;
+  Report.Steps[1].MaxIdle = 0.6;
+
+  StressConfig Config;
+  const auto Violations = checkStress(Report, Config, 401);
+  ASSERT_EQ(Violations.size(), 5u);
+  EXPECT_EQ(Violations[0], "3 of 400 files failed to parse");
+  EXPECT_NE(Violations[1].find("2.00x more per file"), std::string::npos);
+  EXPECT_NE(Violations[2].find("idled 60%"), std::string::npos);
+  EXPECT_NE(Violations[3].find("grew by 850 MiB"), std::string::npos);
+  EXPECT_NE(Violations[4].find("expects 401"), std::string::npos);
+
+  // Idle time is meaningless with a single worker
+  Report.Steps[1].Workers = 1;
+  EXPECT_EQ(checkStress(Report, Config, 401).size(), 4u);
+}
@@ -0,0 +1,129 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Helpers shared by the query and matcher tests.
+//
+// CompiledMatchesReference checks a compiled query mode against its plain
+// reference implementation: over a corpus of signatures, with any cache
+// the compiled query keeps warm or cold, both agree, and every exact match
+// is also a match of the mode. Its test body lives in query_modes_test.cpp
+// and each matcher's test file instantiates it with its queries.
+//
+// ProcessFilesOnInputs is the end-to-end check of a query mode: a query
+// that finds nothing (or less) in a file under test/inputs with the mode
+// off finds the expected functions with it on. The test body lives in
+// query_modes_test.cpp; each matcher's test file instantiates it with its
+// own cases. The inputs are parsed without system headers, so standard
+// types decay to int: processData in example.c is
+// bool(const int &, void *, int).
+
+#pragma once
+
+#include "coogle/parser.h"
+#include "coogle/search.h"
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace coogle::test {
+
+// Parses signatures into storage that lives as long as this object.
+class Signatures {
+  std::deque<SignatureStorage> Storage_;
+
+public:
+  Signature parse(std::string_view Input) {
+    return *parseFunctionSignature(Storage_.emplace_back(), Input);
+  }
+};
+
+// defaultClangArgs() in the form processFiles() takes.
+class DefaultClangArgs {
+  std::vector<std::string> Strings_ = defaultClangArgs();
+  std::vector<const char *> Args_;
+
+public:
+  DefaultClangArgs() {
+    for (const std::string &S : Strings_) {
+      Args_.push_back(S.c_str());
+    }
+  }
+
+  const std::vector<const char *> &get() const { return Args_; }
+};
+
+// A query mode: its compiled query and the reference it must agree with.
+struct QueryMode {
+  using MatcherFn = std::function<bool(const Signature &Actual)>;
+
+  // Compiles Query once; the matcher is called for every candidate
+  std::function<MatcherFn(const Signature &Query)> Compile;
+  std::function<bool(const Signature &Query, const Signature &Actual)>
+      Reference;
+
+  // Matches with both, expects them to agree and returns the answer.
+  bool matches(std::string_view Query, std::string_view Actual) const {
+    Signatures Sigs;
+    const Signature QuerySig = Sigs.parse(Query);
+    const Signature ActualSig = Sigs.parse(Actual);
+    const bool Result = Compile(QuerySig)(ActualSig);
+    EXPECT_EQ(Result, Reference(QuerySig, ActualSig))
+        << Query << " vs " << Actual;
+    return Result;
+  }
+};
+
+// Compile function of a query class constructed as QueryT(Query, Args...).
+template <typename QueryT, typename... ArgTs>
+auto compileAs(ArgTs... Args) {
+  return [=](const Signature &Query) -> QueryMode::MatcherFn {
+    auto Compiled = std::make_shared<QueryT>(Query, Args...);
+    return [Compiled](const Signature &Actual) {
+      return Compiled->matches(Actual);
+    };
+  };
+}
+
+// One corpus case of a query mode.
+struct ReferenceCase {
+  const char *Name; // Test name suffix
+  QueryMode Mode;
+  std::vector<std::string_view> Queries;
+  std::vector<std::string_view> Corpus;
+};
+
+inline void PrintTo(const ReferenceCase &Case, std::ostream *Os) {
+  *Os << Case.Name;
+}
+
+class CompiledMatchesReference
+    : public ::testing::TestWithParam<ReferenceCase> {};
+
+// Test name of a ReferenceCase instantiation.
+inline std::string
+referenceCaseName(const ::testing::TestParamInfo<ReferenceCase> &Info) {
+  return Info.param.Name;
+}
+
+// One end-to-end case of a query mode.
+struct InputsCase {
+  const char *File;  // Under test/inputs
+  const char *Query;
+  void (*Enable)(WorkerSettings &); // Turns the mode on
+  std::size_t MatchesWithout;       // Match count with the mode off
+  std::size_t MatchesWith;          // Match count with the mode on
+};
+
+inline void PrintTo(const InputsCase &Case, std::ostream *Os) {
+  *Os << Case.File << ": \"" << Case.Query << '"';
+}
+
+class ProcessFilesOnInputs : public ::testing::TestWithParam<InputsCase> {};
+
+} // namespace coogle::test
@@ -0,0 +1,77 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for the --trace ring buffers and Chrome trace export.
+
+#include "coogle/trace.h"
+#include <gtest/gtest.h>
+
+using namespace coogle;
+
+namespace {
+std::vector<std::string> heldFiles(const TraceBuffer &Buffer) {
+  std::vector<std::string> Files;
+  Buffer.forEach([&](const TraceEvent &Event) {
+    Files.emplace_back(Buffer.file(Event));
+  });
+  return Files;
+}
+} // anonymous namespace
+
+// Events come back oldest first while the buffer has room
+TEST(TraceTest, RingKeepsOrder) {
+  TraceBuffer Buffer({"a.cpp", "b.cpp"}, 4);
+  Buffer.record({"parse", 0});
+  Buffer.record({"parse", 1});
+  EXPECT_EQ(Buffer.size(), 2u);
+  EXPECT_EQ(Buffer.dropped(), 0u);
+  EXPECT_EQ(heldFiles(Buffer), (std::vector<std::string>{"a.cpp", "b.cpp"}));
+}
+
+// Once full, the oldest events are overwritten and counted as dropped
+TEST(TraceTest, RingOverwritesOldest) {
+  TraceBuffer Buffer({"a", "b", "c", "d", "e"}, 3);
+  for (std::size_t File = 0; File < 5; ++File) {
+    Buffer.record({"parse", File});
+  }
+  EXPECT_EQ(Buffer.size(), 3u);
+  EXPECT_EQ(Buffer.dropped(), 2u);
+  EXPECT_EQ(heldFiles(Buffer), (std::vector<std::string>{"c", "d", "e"}));
+}
+
+// The ring only allocates the events it holds
+TEST(TraceTest, RingGrowsOnDemand) {
+  TraceBuffer Buffer({"a.cpp"});
+  EXPECT_EQ(Buffer.size(), 0u);
+  Buffer.record({"parse", 0});
+  Buffer.record({"visit", 0});
+  EXPECT_EQ(Buffer.size(), 2u);
+  EXPECT_EQ(Buffer.dropped(), 0u);
+  EXPECT_EQ(heldFiles(Buffer), (std::vector<std::string>{"a.cpp", "a.cpp"}));
+}
+
+// One named track per worker and one complete event per span
+TEST(TraceTest, ChromeTraceFormat) {
+  TraceBuffer Worker0({"a.cpp"}, 8);
+  Worker0.record({"parse", 0, 1500, 2000, 42, 0});
+  TraceBuffer Worker1({"b\"c.cpp"}, 8);
+  Worker1.record({"visit", 0, 4000, 500, 7, 3});
+
+  OutputBuffer Out;
+  formatChromeTrace(Out, {&Worker0, &Worker1}, 1000);
+  const std::string Text(Out.view());
+
+  EXPECT_EQ(Text.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", 0),
+            0u);
+  EXPECT_NE(Text.find("\"tid\":1,\"args\":{\"name\":\"worker 1\"}"),
+            std::string::npos);
+  EXPECT_NE(Text.find("{\"name\":\"parse\",\"cat\":\"coogle\",\"ph\":\"X\","
+                      "\"pid\":1,\"tid\":0,\"ts\":0.500,\"dur\":2.000,"
+                      "\"args\":{\"file\":\"a.cpp\",\"bytes\":42,"
+                      "\"functions\":0}}"),
+            std::string::npos);
+  EXPECT_NE(Text.find("\"tid\":1,\"ts\":3.000,\"dur\":0.500,"
+                      "\"args\":{\"file\":\"b\\\"c.cpp\",\"bytes\":7,"
+                      "\"functions\":3}}"),
+            std::string::npos);
+  EXPECT_EQ(Text.substr(Text.size() - 4), "\n]}\n");
+}
@@ -0,0 +1,202 @@
+// Copyright 2025 Yi-Ping Pan (Cloudlet)
+//
+// Unit tests for structural type patterns and the hash-consed type table.
+
+#include "coogle/parser.h"
+#include "coogle/type_tree.h"
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace coogle;
+
+namespace {
+std::string normalized(std::string_view Type) {
+  StringArena Arena;
+  return std::string(normalizeType(Arena, Type));
+}
+
+struct PatternCase {
+  std::string_view Pattern;
+  std::string_view Actual;
+  bool Expected;
+};
+
+constexpr PatternCase Cases[] = {
+    {"std::vector<*>", "std::vector<int>", true},
+    {"std::vector<*>", "std::vector<std::vector<double>>", true},
+    {"std::vector<*>", "std::list<int>", false},
+    {"std::vector<*>", "std::vector<int> &", false},
+    {"std::vector<*>", "std::vector<int>::iterator", false},
+    {"const std::vector<*> &", "const std::vector<int> &", true},
+    {"std::map<std::string, *>", "std::map<std::basic_string<char>, int>",
+     true},
+    {"std::map<std::string, *>", "std::map<int, int>", false},
+    {"std::map<*, *>", "std::map<int, std::pair<int, int>>", true},
+    {"std::map<*>", "std::map<int, int>", false},
+    {"std::map<*, *, *>", "std::map<int, int>", false},
+    {"std::pair<*, int> *", "std::pair<char, int> *", true},
+    {"std::pair<*, int> *", "std::pair<char, long> *", false},
+    {"std::function<*>", "std::function<void (int, int)>", true},
+    {"* *", "int *", true},
+    {"* *", "char **", true},
+    {"* *", "const std::string *", true},
+    {"* *", "int", false},
+    {"* *", "int &", false},
+    {"* **", "char **", true},
+    {"* **", "char *", false},
+    {"const *&", "const std::string &", true},
+    {"const *&", "int &&", false},
+    {"const *&", "int *", false},
+    {"*&&", "std::vector<int> &&", true},
+    {"*&&", "int &", false},
+    // Function types and arrays are compared literally
+    {"* *", "void (*)(int)", false},
+    {"const *&", "int (&)[4]", false},
+    {"std::function<void (int, *)>", "std::function<void (int, int)>", false},
+    {"std::function<void (int, *)>", "std::function<void (int, *)>", true},
+    // Type variables: any type, the same one at every use
+    {"?T", "std::vector<int>", true},
+    {"std::pair<?T, ?T>", "std::pair<int, int>", true},
+    {"std::pair<?T, ?T>", "std::pair<int, long>", false},
+    {"std::pair<?T, ?U>", "std::pair<int, int>", true},
+    {"std::map<?K, std::vector<?K>> &", "std::map<int, std::vector<int>> &",
+     true},
+    {"std::map<?K, std::vector<?K>> &", "std::map<int, std::vector<char>> &",
+     false},
+    {"?T **", "int **", true},
+    {"?T **", "int *", false},
+    {"std::pair<?T, ?T>", "std::pair<T, T>", true},
+    // No wildcard: the plain comparison
+    {"std::vector<int>", "std::vector<int>", true},
+    {"std::vector<int>", "std::vector<long>", false},
+};
+} // anonymous namespace
+
+TEST(TypeTreeTest, Layers) {
+  TypeTable Types;
+  const TypeNode *Map = Types.intern(normalized("std::map<std::string, *> &"));
+  ASSERT_EQ(Map->Kind, TypeKind::LValueRef);
+  EXPECT_TRUE(Map->HasWildcard);
+  EXPECT_EQ(Map->Text, "std::map<std::string,*>&");
+
+  const TypeNode *Template = Map->Children.front();
+  ASSERT_EQ(Template->Kind, TypeKind::Template);
+  EXPECT_EQ(Template->Name, "std::map");
+  ASSERT_EQ(Template->Children.size(), 2u);
+  EXPECT_EQ(Template->Children[0]->Kind, TypeKind::Leaf);
+  EXPECT_EQ(Template->Children[0]->Text, "std::string");
+  EXPECT_FALSE(Template->Children[0]->HasWildcard);
+  EXPECT_EQ(Template->Children[1]->Kind, TypeKind::Wildcard);
+
+  // "* *" is a pointer to anything
+  const TypeNode *AnyPointer = Types.intern(normalized("* *"));
+  ASSERT_EQ(AnyPointer->Kind, TypeKind::Pointer);
+  EXPECT_EQ(AnyPointer->Children.front()->Kind, TypeKind::Wildcard);
+  EXPECT_EQ(Types.intern("int&&")->Kind, TypeKind::RValueRef);
+
+  // Whole leaves: nested names, function types, bad argument lists
+  for (std::string_view Leaf :
+       {"std::map<int,int>::iterator", "void(*)(int)", "int(&)[4]", "A<,*>",
+        "unsignedint"}) {
+    EXPECT_EQ(Types.intern(Leaf)->Kind, TypeKind::Leaf) << Leaf;
+    EXPECT_FALSE(Types.intern(Leaf)->HasWildcard) << Leaf;
+  }
+  const TypeNode *Function = Types.intern("std::function<void(int,*)>");
+  EXPECT_EQ(Function->Kind, TypeKind::Template);
+  EXPECT_FALSE(Function->HasWildcard);
+}
+
+// Identical subtrees are one node, so equality is pointer equality
+TEST(TypeTreeTest, HashConsing) {
+  TypeTable Types;
+  const TypeNode *Vector = Types.intern(std::string("std::vector<int>"));
+  EXPECT_EQ(Types.intern("std::vector<int>"), Vector);
+  EXPECT_NE(Types.intern("std::vector<long>"), Vector);
+
+  const TypeNode *Pair =
+      Types.intern("std::pair<std::vector<int>,std::vector<int>>");
+  ASSERT_EQ(Pair->Children.size(), 2u);
+  EXPECT_EQ(Pair->Children[0], Vector);
+  EXPECT_EQ(Pair->Children[1], Vector);
+  EXPECT_EQ(Types.intern("std::vector<int>*")->Children.front(), Vector);
+  EXPECT_EQ(Types.intern("int"), Vector->Children.front());
+
+  // int, std::vector<int>, long, std::vector<long>, the pair, the pointer
+  EXPECT_EQ(Types.size(), 6u);
+  EXPECT_EQ(Types.intern("int")->Id, 0u);
+  EXPECT_EQ(Vector->Id, 1u);
+
+  // The table owns its text
+  TypeTable Moved = std::move(Types);
+  EXPECT_EQ(Moved.intern("std::vector<int>"), Vector);
+  EXPECT_EQ(Vector->Text, "std::vector<int>");
+}
+
+TEST(TypeTreeTest, Variables) {
+  TypeTable Types;
+  const TypeNode *T = Types.intern("?T");
+  EXPECT_EQ(T->Kind, TypeKind::Variable);
+  EXPECT_EQ(T->Slot, 'T' - 'A');
+  EXPECT_TRUE(T->HasWildcard);
+  const TypeNode *Map = Types.intern("std::map<?K,?V>&");
+  EXPECT_TRUE(Map->HasWildcard);
+  EXPECT_EQ(Map->Children.front()->Children[1]->Slot, 'V' - 'A');
+  for (std::string_view Leaf :
+       {"T", "?Tp", "?T::type", "std::vector<T>", "std::vector<?Tp>"}) {
+    EXPECT_FALSE(Types.intern(Leaf)->HasWildcard) << Leaf;
+  }
+
+  // Bindings carry over between types until reset
+  TypeBindings Bindings;
+  EXPECT_TRUE(isTypeMatch("?T*", "int*", Bindings));
+  EXPECT_FALSE(isTypeMatch("?T", "long", Bindings));
+  const std::uint32_t Mark = Bindings.mark();
+  EXPECT_TRUE(matchesType(*Map, "std::map<int,long>&", Bindings));
+  EXPECT_FALSE(isTypeMatch("?V", "int", Bindings));
+  Bindings.reset(Mark);
+  EXPECT_TRUE(isTypeMatch("?V", "int", Bindings));
+  EXPECT_TRUE(isTypeMatch("?T", "int", Bindings));
+  Bindings.reset();
+  EXPECT_TRUE(isTypeMatch("?T", "long", Bindings));
+
+  // A nested name after the template is one Leaf, compared literally
+  EXPECT_TRUE(isTypeMatch("std::vector<?T>::iterator",
+                          "std::vector<?T>::iterator", Bindings));
+  EXPECT_FALSE(isTypeMatch("std::vector<?T>::iterator",
+                           "std::vector<int>::iterator", Bindings));
+}
+
+TEST(TypeTreeTest, HasTypeWildcard) {
+  EXPECT_TRUE(hasTypeWildcard("*"));
+  EXPECT_TRUE(hasTypeWildcard("**"));
+  EXPECT_TRUE(hasTypeWildcard("*&"));
+  EXPECT_TRUE(hasTypeWildcard("std::vector<*>"));
+  EXPECT_TRUE(hasTypeWildcard("std::map<int,*>"));
+  EXPECT_FALSE(hasTypeWildcard("char*"));
+  EXPECT_FALSE(hasTypeWildcard("void(*)(int)"));
+  EXPECT_FALSE(hasTypeWildcard("std::vector<int*>"));
+  EXPECT_TRUE(hasTypeWildcard("?T"));
+  EXPECT_TRUE(hasTypeWildcard("?T*&"));
+  EXPECT_TRUE(hasTypeWildcard("std::map<std::string,?V>"));
+  EXPECT_FALSE(hasTypeWildcard("Foo"));
+  EXPECT_FALSE(hasTypeWildcard("T"));
+  EXPECT_FALSE(hasTypeWildcard("std::map<K,V>"));
+  EXPECT_FALSE(hasTypeWildcard("?T::type"));
+  EXPECT_FALSE(hasTypeWildcard("void(?T)"));
+  EXPECT_FALSE(hasTypeWildcard("?"));
+  EXPECT_FALSE(hasTypeWildcard("<"));
+}
+
+// The compiled tree and the text interpreter agree on every case
+TEST(TypeTreeTest, Matches) {
+  TypeTable Types;
+  for (const PatternCase &Case : Cases) {
+    const std::string Pattern = normalized(Case.Pattern);
+    const std::string Actual = normalized(Case.Actual);
+    EXPECT_EQ(isTypeMatch(Pattern, Actual), Case.Expected)
+        << Case.Pattern << " vs " << Case.Actual;
+    EXPECT_EQ(matchesType(*Types.intern(Pattern), Actual), Case.Expected)
+        << Case.Pattern << " vs " << Case.Actual;
+  }
+}